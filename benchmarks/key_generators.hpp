@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace benchmarks
+{
+
+/**
+ * @brief The order/distribution of the keys fed to a benchmark
+ *
+ * - Random: every key in [0, n) exactly once, shuffled
+ * - Sorted: every key in [0, n) exactly once, ascending
+ * - ReverseSorted: every key in [0, n) exactly once, descending
+ * - Zipfian: n draws from a Zipf(0.99) distribution over [0, n), so a few hot keys repeat very often
+ * - HotSet: n draws, 90% of them uniform over a fixed hot 1% of [0, n) and the rest uniform over all of it
+ */
+enum class KeyOrder
+{
+    Random,
+    Sorted,
+    ReverseSorted,
+    Zipfian,
+    HotSet
+};
+
+inline const char *keyOrderName(KeyOrder order)
+{
+    switch (order)
+    {
+    case KeyOrder::Random:
+        return "random";
+    case KeyOrder::Sorted:
+        return "sorted";
+    case KeyOrder::ReverseSorted:
+        return "reverse";
+    case KeyOrder::Zipfian:
+        return "zipfian";
+    case KeyOrder::HotSet:
+        return "hotset";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Map a key rank onto a value of the benchmarked type, preserving order
+ */
+template <typename T> T makeKey(uint64_t rank);
+
+template <> inline int makeKey<int>(uint64_t rank)
+{
+    return static_cast<int>(rank);
+}
+
+template <> inline double makeKey<double>(uint64_t rank)
+{
+    return static_cast<double>(rank) * 0.5 + 0.25;
+}
+
+template <> inline std::string makeKey<std::string>(uint64_t rank)
+{
+    //? Zero padded so that lexicographic order matches rank order, long enough to defeat the small string buffer
+    char buffer[40];
+    std::snprintf(buffer, sizeof(buffer), "bench/key/%020llu", static_cast<unsigned long long>(rank));
+    return buffer;
+}
+
+/**
+ * @brief Zipf distributed ranks in [0, n) using the constant-time method of Gray et al.,
+ * "Quickly Generating Billion-Record Synthetic Databases" (SIGMOD '94), as popularized by YCSB
+ */
+class ZipfianGenerator
+{
+  private:
+    uint64_t items;
+    double theta, alpha, zetan, eta;
+    std::uniform_real_distribution<double> uniform;
+
+    static double zeta(uint64_t count, double theta)
+    {
+        double sum = 0.0;
+        for (uint64_t i = 1; i <= count; ++i)
+        {
+            sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        }
+        return sum;
+    }
+
+  public:
+    ZipfianGenerator(uint64_t items, double theta = 0.99)
+        : items(items), theta(theta), alpha(1.0 / (1.0 - theta)), zetan(zeta(items, theta)), uniform(0.0, 1.0)
+    {
+        const double zeta2 = zeta(2, theta);
+        eta = (1.0 - std::pow(2.0 / static_cast<double>(items), 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    template <typename Engine> uint64_t operator()(Engine &engine)
+    {
+        const double u = uniform(engine);
+        const double uz = u * zetan;
+        if (uz < 1.0)
+        {
+            return 0;
+        }
+        if (uz < 1.0 + std::pow(0.5, theta))
+        {
+            return 1;
+        }
+        const auto rank = static_cast<uint64_t>(static_cast<double>(items) * std::pow(eta * u - eta + 1.0, alpha));
+        return std::min(rank, items - 1);
+    }
+};
+
+/**
+ * @brief Generate count keys of type T in the requested order
+ *
+ * @param order The distribution of the keys
+ * @param count The number of keys to generate
+ * @param seed Seed for the random orders, so every run of a benchmark sees the same keys
+ */
+template <typename T> std::vector<T> generateKeys(KeyOrder order, size_t count, uint64_t seed = 42)
+{
+    std::mt19937_64 engine(seed);
+    std::vector<uint64_t> ranks(count);
+
+    switch (order)
+    {
+    case KeyOrder::Random:
+        std::iota(ranks.begin(), ranks.end(), 0);
+        std::shuffle(ranks.begin(), ranks.end(), engine);
+        break;
+    case KeyOrder::Sorted:
+        std::iota(ranks.begin(), ranks.end(), 0);
+        break;
+    case KeyOrder::ReverseSorted:
+        std::iota(ranks.rbegin(), ranks.rend(), 0);
+        break;
+    case KeyOrder::Zipfian: {
+        //? Scatter the hot ranks over the key space with a multiplicative bijection, otherwise the hottest keys
+        //? would all be the smallest ones and sit on one side of the tree
+        ZipfianGenerator zipf(count);
+        for (auto &rank : ranks)
+        {
+            rank = (zipf(engine) * 2654435761ULL) % count;
+        }
+        break;
+    }
+    case KeyOrder::HotSet: {
+        //? The hot ranks are scattered the same way as the Zipfian ones
+        const uint64_t hot = std::max<uint64_t>(1, count / 100);
+        for (auto &rank : ranks)
+        {
+            rank = engine() % 10 == 0 ? engine() % count : (engine() % hot * 2654435761ULL) % count;
+        }
+        break;
+    }
+    }
+
+    std::vector<T> keys;
+    keys.reserve(count);
+    for (uint64_t rank : ranks)
+    {
+        keys.push_back(makeKey<T>(rank));
+    }
+    return keys;
+}
+
+} // namespace benchmarks
@@ -0,0 +1,28 @@
+#!/bin/bash
+
+# Benchmark runner script for the tree benchmarks
+# Usage: ./benchmarks/run_benchmarks.sh [extra Google Benchmark flags, e.g. --benchmark_filter='contains/.*/1000$']
+
+set -e  # Exit on any error
+
+# Move to project root if running from benchmarks/
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$SCRIPT_DIR/.."
+cd "$PROJECT_ROOT"
+
+# Create build directory if it doesn't exist
+mkdir -p build
+cd build
+
+# Configure with CMake (benchmarks are only meaningful in an optimized build)
+cmake -DCMAKE_BUILD_TYPE=Release -DBUILD_BENCHMARKS=ON ..
+
+# Build the benchmarks
+make -j$(nproc 2>/dev/null || sysctl -n hw.ncpu 2>/dev/null || echo 4) tree_benchmarks
+
+# Run the benchmarks, writing machine-readable results next to the console output
+mkdir -p benchmark_results
+RESULTS="benchmark_results/tree_benchmarks_$(git rev-parse --short HEAD 2>/dev/null || echo local)_$(date +%Y%m%d_%H%M%S).json"
+./benchmarks/tree_benchmarks --benchmark_out="$RESULTS" --benchmark_out_format=json "$@"
+
+echo "Benchmark results written to build/$RESULTS"
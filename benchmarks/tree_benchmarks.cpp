@@ -0,0 +1,1115 @@
+#include "key_generators.hpp"
+#include "models/b_tree_set.hpp"
+#include "models/binary_tree_set.hpp"
+#include "models/compact_tree_set.hpp"
+#include "models/concurrent_skip_list_set.hpp"
+#include "models/persistent_tree_set.hpp"
+#include "models/set_file.hpp"
+#include "models/string_set.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace models;
+using benchmarks::generateKeys;
+using benchmarks::KeyOrder;
+
+namespace
+{
+
+const KeyOrder allOrders[] = {KeyOrder::Random, KeyOrder::Sorted, KeyOrder::ReverseSorted, KeyOrder::Zipfian};
+
+//? Seed for probe sequences, so lookups do not replay the insertion order
+constexpr uint64_t probeSeed = 7;
+
+template <typename Set, typename T> std::unique_ptr<Set> buildSet(const std::vector<T> &keys)
+{
+    auto set = std::make_unique<Set>();
+    for (const T &key : keys)
+    {
+        set->insert(key);
+    }
+    return set;
+}
+
+//? Destroying a set is not part of what insert/insertRange measure
+template <typename Set> void destroyUntimed(benchmark::State &state, std::unique_ptr<Set> &set)
+{
+    state.PauseTiming();
+    set.reset();
+    state.ResumeTiming();
+}
+
+//? Parallel builds and set algebra run on one pool for the whole suite, with the default thread count and grain size
+WorkStealingPool &benchmarkPool()
+{
+    static WorkStealingPool pool;
+    return pool;
+}
+
+template <typename Set, typename T> void BM_Insert(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        auto set = std::make_unique<Set>();
+        for (const T &key : keys)
+        {
+            set->insert(key);
+        }
+        benchmark::DoNotOptimize(set->size());
+        destroyUntimed(state, set);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Set, typename T> void BM_InsertRange(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        auto set = std::make_unique<Set>();
+        set->insertRange(keys);
+        benchmark::DoNotOptimize(set->size());
+        destroyUntimed(state, set);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Set, typename T> void BM_FromSorted(benchmark::State &state, KeyOrder order)
+{
+    //? Unsorted orders include the sort, sorted orders show the linear build on its own
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        auto set = std::make_unique<Set>(Set::fromSorted(keys.begin(), keys.end()));
+        benchmark::DoNotOptimize(set->size());
+        destroyUntimed(state, set);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Set, typename T> void BM_ParallelFromSorted(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        auto set = std::make_unique<Set>(Set::fromSorted(keys.begin(), keys.end(), benchmarkPool()));
+        benchmark::DoNotOptimize(set->size());
+        destroyUntimed(state, set);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//? The parallel build on a pool of state.range(1) threads in total, to show how it scales with the thread count
+template <typename Set, typename T> void BM_ParallelBuildScaling(benchmark::State &state)
+{
+    const auto keys = generateKeys<T>(KeyOrder::Random, static_cast<size_t>(state.range(0)));
+    WorkStealingPool pool(static_cast<size_t>(state.range(1) - 1));
+    for (auto _ : state)
+    {
+        auto set = std::make_unique<Set>(Set::fromSorted(keys.begin(), keys.end(), pool));
+        benchmark::DoNotOptimize(set->size());
+        destroyUntimed(state, set);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Set, typename T> void BM_Contains(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    const auto probes = generateKeys<T>(order, keys.size(), probeSeed);
+    const auto set = buildSet<Set>(keys);
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(set->contains(probes[next]));
+        if (++next == probes.size())
+        {
+            next = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+//? Number of nodes above the value equal to key, read without going through contains(), which would splay
+template <typename Set, typename T> size_t searchDepth(const Set &set, const T &key)
+{
+    size_t depth = 0;
+    for (const BinaryNode<T> *node = set.getRoot(); node && (node->value() < key || key < node->value()); ++depth)
+    {
+        node = key < node->value() ? node->left() : node->right();
+    }
+    return depth;
+}
+
+//? Lookups of skewed probes (Zipfian or HotSet) in a set holding every key, so a few hot keys make up most of the
+//? stream. The depth counter is the average depth of each probe's value just before it is looked up, over a replay
+//? afterwards
+template <typename Set, typename T> void BM_SkewedContains(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(KeyOrder::Random, static_cast<size_t>(state.range(0)));
+    const auto probes = generateKeys<T>(order, keys.size(), probeSeed);
+    const auto set = buildSet<Set>(keys);
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(set->contains(probes[next]));
+        if (++next == probes.size())
+        {
+            next = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    const size_t replayed = std::min<size_t>(probes.size(), 100'000);
+    size_t depth = 0;
+    for (size_t i = 0; i < replayed; ++i)
+    {
+        depth += searchDepth(*set, probes[i]);
+        set->contains(probes[i]);
+    }
+    state.counters["depth"] = static_cast<double>(depth) / static_cast<double>(replayed);
+}
+
+//? Each iteration looks up the next batch_size probes, compare items_per_second with contains
+template <typename Set, typename T> void BM_ContainsBatch(benchmark::State &state, KeyOrder order)
+{
+    constexpr size_t batch_size = 1024;
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    auto probes = generateKeys<T>(order, keys.size(), probeSeed);
+    const auto set = buildSet<Set>(keys);
+
+    //? Pad the probes to whole batches, so no batch wraps around the end
+    for (size_t i = 0; probes.size() % batch_size != 0; ++i)
+    {
+        probes.push_back(probes[i]);
+    }
+    std::unique_ptr<bool[]> found(new bool[batch_size]);
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        set->containsBatch(probes.data() + next, batch_size, found.get());
+        benchmark::DoNotOptimize(found.get());
+        benchmark::ClobberMemory();
+        next += batch_size;
+        if (next == probes.size())
+        {
+            next = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+//? Node memory of a set divided by its size: the arena's reserved slabs, or the compact set's node vector
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+double bytesPerValue(const BinaryTreeSet<T, Balance, Allocator, Compare, Metrics> &set)
+{
+    return static_cast<double>(set.allocationStats().bytes_reserved) / static_cast<double>(set.size());
+}
+
+template <typename T, typename Compare> double bytesPerValue(const CompactTreeSet<T, Compare> &set)
+{
+    return static_cast<double>(set.memoryUsage()) / static_cast<double>(set.size());
+}
+
+//? Inserts the keys one by one like BM_Insert, and reports the memory the nodes take up afterwards
+template <typename Set, typename T> void BM_Footprint(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    double bytes = 0;
+    for (auto _ : state)
+    {
+        auto set = std::make_unique<Set>();
+        for (const T &key : keys)
+        {
+            set->insert(key);
+        }
+        bytes = bytesPerValue(*set);
+        destroyUntimed(state, set);
+    }
+    state.counters["bytes_per_value"] = bytes;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//? Visits the keys starting with prefix: the radix tree walks to the prefix's subtree, the AVL tree seeks its lower
+//? bound and iterates until a key no longer matches
+template <typename Visit> size_t scanPrefix(const StringSet &set, const std::string &prefix, Visit &&visit)
+{
+    size_t visited = 0;
+    set.prefixScan(prefix, [&](const std::string &key) {
+        visit(key);
+        ++visited;
+    });
+    return visited;
+}
+
+template <typename Visit>
+size_t scanPrefix(const AvlTreeSet<std::string> &set, const std::string &prefix, Visit &&visit)
+{
+    size_t visited = 0;
+    for (auto it = set.lower_bound(prefix); it != set.end() && it->compare(0, prefix.size(), prefix) == 0; ++it)
+    {
+        visit(*it);
+        ++visited;
+    }
+    return visited;
+}
+
+//? Each probe key without its last two digits is a prefix matching up to 100 keys
+template <typename Set> void BM_PrefixScan(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<std::string>(order, static_cast<size_t>(state.range(0)));
+    auto prefixes = generateKeys<std::string>(order, keys.size(), probeSeed);
+    for (std::string &prefix : prefixes)
+    {
+        prefix.resize(prefix.size() - 2);
+    }
+    const auto set = buildSet<Set>(keys);
+
+    size_t next = 0;
+    size_t visited = 0;
+    for (auto _ : state)
+    {
+        visited += scanPrefix(*set, prefixes[next], [](const std::string &key) { benchmark::DoNotOptimize(key); });
+        if (++next == prefixes.size())
+        {
+            next = 0;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(visited));
+}
+
+template <typename Set, typename T> void BM_Rank(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    const auto probes = generateKeys<T>(order, keys.size(), probeSeed);
+    const auto set = buildSet<Set>(keys);
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(set->rank(probes[next]));
+        if (++next == probes.size())
+        {
+            next = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Set, typename T> void BM_Select(benchmark::State &state, KeyOrder order)
+{
+    const auto set = buildSet<Set>(generateKeys<T>(order, static_cast<size_t>(state.range(0))));
+
+    //? A multiplicative stride visits the positions in a scattered order
+    size_t k = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(*set->select(k));
+        k = (k + 2654435761u) % set->size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Set, typename T> void BM_Find(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    const auto probes = generateKeys<T>(order, keys.size(), probeSeed);
+    const auto set = buildSet<Set>(keys);
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(set->find(probes[next]));
+        if (++next == probes.size())
+        {
+            next = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Set, typename T> void BM_Erase(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    const auto probes = generateKeys<T>(order, keys.size(), probeSeed);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto set = buildSet<Set>(keys);
+        state.ResumeTiming();
+
+        for (const T &key : probes)
+        {
+            benchmark::DoNotOptimize(set->erase(key));
+        }
+        destroyUntimed(state, set);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Set, typename T> void BM_Merge(benchmark::State &state, KeyOrder order)
+{
+    //? Merge the second half of the keys into a set holding the first half
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    const auto middle = keys.begin() + static_cast<std::ptrdiff_t>(keys.size() / 2);
+    const std::vector<T> firstHalf(keys.begin(), middle), secondHalf(middle, keys.end());
+    const auto source = buildSet<Set>(secondHalf);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto target = buildSet<Set>(firstHalf);
+        state.ResumeTiming();
+
+        target->merge(*source);
+        benchmark::DoNotOptimize(target->size());
+        destroyUntimed(state, target);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(secondHalf.size()));
+}
+
+enum class Algebra
+{
+    Union,
+    Intersection,
+    Difference,
+    SymmetricDifference
+};
+
+template <typename Set, typename T, Algebra algebra, bool parallel = false>
+void BM_SetAlgebra(benchmark::State &state, KeyOrder order)
+{
+    //? The target holds the first two thirds of the keys and the source the last two thirds, so they share a third
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    const auto third = static_cast<std::ptrdiff_t>(keys.size() / 3);
+    const std::vector<T> targetKeys(keys.begin(), keys.end() - third), sourceKeys(keys.begin() + third, keys.end());
+    const auto source = buildSet<Set>(sourceKeys);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto target = buildSet<Set>(targetKeys);
+        state.ResumeTiming();
+
+        if constexpr (parallel && algebra == Algebra::Union)
+        {
+            target->unionWith(*source, benchmarkPool());
+        }
+        else if constexpr (parallel && algebra == Algebra::Intersection)
+        {
+            target->intersectWith(*source, benchmarkPool());
+        }
+        else if constexpr (algebra == Algebra::Union)
+        {
+            target->unionWith(*source);
+        }
+        else if constexpr (algebra == Algebra::Intersection)
+        {
+            target->intersectWith(*source);
+        }
+        else if constexpr (algebra == Algebra::Difference)
+        {
+            target->differenceWith(*source);
+        }
+        else
+        {
+            target->symmetricDifference(*source);
+        }
+        benchmark::DoNotOptimize(target->size());
+        destroyUntimed(state, target);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(targetKeys.size() + sourceKeys.size()));
+}
+
+template <typename Set, typename T> void BM_Clear(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto set = buildSet<Set>(keys);
+        state.ResumeTiming();
+
+        set->clear();
+        benchmark::DoNotOptimize(set->size());
+        destroyUntimed(state, set);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+enum class Traversal
+{
+    Inorder,
+    InorderFunction,
+    Preorder,
+    Postorder,
+    Iterator
+};
+
+template <typename Set, typename T, Traversal traversal> void BM_Traverse(benchmark::State &state, KeyOrder order)
+{
+    const auto set = buildSet<Set>(generateKeys<T>(order, static_cast<size_t>(state.range(0))));
+    for (auto _ : state)
+    {
+        size_t visited = 0;
+        auto visit = [&visited](const T &value) {
+            benchmark::DoNotOptimize(value);
+            ++visited;
+        };
+
+        if constexpr (traversal == Traversal::Inorder)
+        {
+            set->traverseInorder(visit);
+        }
+        else if constexpr (traversal == Traversal::InorderFunction)
+        {
+            set->traverseInorder(std::function<void(const T &)>(visit));
+        }
+        else if constexpr (traversal == Traversal::Preorder)
+        {
+            set->traversePreorder(visit);
+        }
+        else if constexpr (traversal == Traversal::Iterator)
+        {
+            for (const T &value : *set)
+            {
+                visit(value);
+            }
+        }
+        else
+        {
+            set->traversePostorder(visit);
+        }
+        benchmark::DoNotOptimize(visited);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(set->size()));
+}
+
+enum class StaticQuery
+{
+    Contains,
+    LowerBound,
+    Rank
+};
+
+//? Queries on the frozen, Eytzinger ordered copy of an AVL tree
+template <typename T, StaticQuery query> void BM_StaticSet(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    const auto probes = generateKeys<T>(order, keys.size(), probeSeed);
+    const StaticSet<T> set = buildSet<AvlTreeSet<T>>(keys)->freeze();
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        if constexpr (query == StaticQuery::Contains)
+        {
+            benchmark::DoNotOptimize(set.contains(probes[next]));
+        }
+        else if constexpr (query == StaticQuery::LowerBound)
+        {
+            benchmark::DoNotOptimize(set.lower_bound(probes[next]));
+        }
+        else
+        {
+            benchmark::DoNotOptimize(set.rank(probes[next]));
+        }
+        if (++next == probes.size())
+        {
+            next = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename T> void BM_Freeze(benchmark::State &state, KeyOrder order)
+{
+    const auto tree = buildSet<AvlTreeSet<T>>(generateKeys<T>(order, static_cast<size_t>(state.range(0))));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tree->freeze());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(tree->size()));
+}
+
+//? The baseline for StaticSet lookups: std::lower_bound on the same values in a sorted vector
+template <typename T> void BM_ArrayLowerBound(benchmark::State &state, KeyOrder order)
+{
+    std::vector<T> keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    const auto probes = generateKeys<T>(order, keys.size(), probeSeed);
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::lower_bound(keys.begin(), keys.end(), probes[next]));
+        if (++next == probes.size())
+        {
+            next = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+//? The floor for traverseInorder: the same values scanned from a sorted array
+template <typename T> void BM_ArrayScan(benchmark::State &state, KeyOrder order)
+{
+    std::vector<T> keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    std::sort(keys.begin(), keys.end());
+    for (auto _ : state)
+    {
+        size_t visited = 0;
+        for (const T &value : keys)
+        {
+            benchmark::DoNotOptimize(value);
+            ++visited;
+        }
+        benchmark::DoNotOptimize(visited);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(keys.size()));
+}
+
+template <typename T> const char *typeName()
+{
+    if constexpr (std::is_same_v<T, int>)
+    {
+        return "int";
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        return "double";
+    }
+    else
+    {
+        return "string";
+    }
+}
+
+//? Where the set file benchmarks save their sets, removed again when each benchmark ends
+template <typename T> std::string setFilePath()
+{
+    return (std::filesystem::temp_directory_path() / (std::string("tree_benchmarks_") + typeName<T>() + ".set"))
+        .string();
+}
+
+template <typename Set, typename T> void BM_Save(benchmark::State &state, KeyOrder order)
+{
+    const auto set = buildSet<Set>(generateKeys<T>(order, static_cast<size_t>(state.range(0))));
+    const std::string path = setFilePath<T>();
+    for (auto _ : state)
+    {
+        set->save(path);
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(set->size()));
+}
+
+//? Startup from a saved set: BinaryTreeSet::load maps the file and links a balanced tree straight from it
+template <typename Set, typename T> void BM_Load(benchmark::State &state, KeyOrder order)
+{
+    const std::string path = setFilePath<T>();
+    buildSet<Set>(generateKeys<T>(order, static_cast<size_t>(state.range(0))))->save(path);
+    for (auto _ : state)
+    {
+        auto set = std::make_unique<Set>(Set::load(path));
+        benchmark::DoNotOptimize(set->size());
+        destroyUntimed(state, set);
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//? Startup without building anything: map the file and answer a first query
+template <typename T> void BM_MappedOpen(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    const std::string path = setFilePath<T>();
+    buildSet<AvlTreeSet<T>>(keys)->save(path);
+    for (auto _ : state)
+    {
+        const MappedSet<T> mapped(path);
+        benchmark::DoNotOptimize(mapped.contains(keys.front()));
+    }
+    std::remove(path.c_str());
+}
+
+template <typename T> void BM_MappedContains(benchmark::State &state, KeyOrder order)
+{
+    const auto keys = generateKeys<T>(order, static_cast<size_t>(state.range(0)));
+    const auto probes = generateKeys<T>(order, keys.size(), probeSeed);
+    const std::string path = setFilePath<T>();
+    buildSet<AvlTreeSet<T>>(keys)->save(path);
+    const MappedSet<T> mapped(path);
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mapped.contains(probes[next]));
+        if (++next == probes.size())
+        {
+            next = 0;
+        }
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations());
+}
+
+//? The baseline for ConcurrentSkipListSet: an AVL tree behind one mutex, so every operation runs alone
+template <typename T> class LockedAvlTreeSet
+{
+  private:
+    AvlTreeSet<T> set;
+    mutable std::mutex mutex;
+
+  public:
+    bool insert(const T &value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const size_t before = set.size();
+        set.insert(value);
+        return set.size() != before;
+    }
+
+    bool erase(const T &value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return set.erase(value);
+    }
+
+    bool contains(const T &value) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return set.contains(value);
+    }
+
+    template <typename Callback> void traverseInorder(Callback &&callback) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        set.traverseInorder(callback);
+    }
+};
+
+//? Every thread runs the same mix on one shared set: readPercent% contains, the rest split evenly between insert
+//? and erase. The set starts with every other key of [0, 2n), so writes keep its size around n
+template <typename Set> void BM_ConcurrentMix(benchmark::State &state, int readPercent)
+{
+    static std::unique_ptr<Set> set;
+    const int64_t keys = state.range(0);
+    if (state.thread_index() == 0)
+    {
+        set = std::make_unique<Set>();
+        for (int key : generateKeys<int>(KeyOrder::Random, static_cast<size_t>(keys)))
+        {
+            set->insert(key * 2);
+        }
+    }
+
+    //? xorshift64 per thread, so drawing operations does not contend
+    uint64_t random = 0x9E3779B97F4A7C15ull * static_cast<uint64_t>(state.thread_index() + 1);
+    for (auto _ : state)
+    {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        const int key = static_cast<int>(random % static_cast<uint64_t>(2 * keys));
+        const int operation = static_cast<int>((random >> 40) % 100);
+        if (operation < readPercent)
+        {
+            benchmark::DoNotOptimize(set->contains(key));
+        }
+        else if (operation % 2 == 0)
+        {
+            benchmark::DoNotOptimize(set->insert(key));
+        }
+        else
+        {
+            benchmark::DoNotOptimize(set->erase(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    //? Every thread has left the loop by now, Google Benchmark joins them at its end
+    if (state.thread_index() == 0)
+    {
+        set.reset();
+    }
+}
+
+//? One writer inserting and erasing while a background thread scans the whole set over and over: the time per
+//? write shows whether writers wait for scans
+template <typename Set> void BM_WritesDuringScans(benchmark::State &state)
+{
+    const int64_t keys = state.range(0);
+    Set set;
+    for (int key : generateKeys<int>(KeyOrder::Random, static_cast<size_t>(keys)))
+    {
+        set.insert(key * 2);
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<int64_t> scans{0};
+    std::thread scanner([&]() {
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            size_t visited = 0;
+            set.traverseInorder([&visited](int value) {
+                benchmark::DoNotOptimize(value);
+                ++visited;
+            });
+            benchmark::DoNotOptimize(visited);
+            scans++;
+        }
+    });
+
+    uint64_t random = 0x9E3779B97F4A7C15ull;
+    for (auto _ : state)
+    {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        const int key = static_cast<int>(random % static_cast<uint64_t>(keys)) * 2 + 1;
+        set.insert(key);
+        set.erase(key);
+    }
+    stop = true;
+    scanner.join();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["scans"] = static_cast<double>(scans.load());
+}
+
+using Function = void (*)(benchmark::State &, KeyOrder);
+
+struct Operation
+{
+    const char *name;
+    Function function;
+    benchmark::TimeUnit unit;
+    bool realTime = false; //? Multi-threaded operations are timed by the wall clock, not the main thread's CPU time
+};
+
+//? Sorted input turns an unbalanced tree into a linked list, so every build is O(n^2); cap those sizes so the suite
+//? still finishes while showing the degradation
+int64_t maxSize(KeyOrder order, bool degradesOnSortedInput)
+{
+    const bool degenerate = degradesOnSortedInput && (order == KeyOrder::Sorted || order == KeyOrder::ReverseSorted);
+    return degenerate ? 10'000 : 10'000'000;
+}
+
+template <typename T>
+void registerOperations(const std::string &setName, const std::vector<Operation> &operations,
+                        bool degradesOnSortedInput)
+{
+    for (const Operation &operation : operations)
+    {
+        for (KeyOrder order : allOrders)
+        {
+            const std::string name = std::string(operation.name) + "/" + setName + "<" + typeName<T>() + ">/" +
+                                     benchmarks::keyOrderName(order);
+            auto *registered = benchmark::RegisterBenchmark(name.c_str(), operation.function, order)
+                                   ->RangeMultiplier(10)
+                                   ->Range(1'000, maxSize(order, degradesOnSortedInput))
+                                   ->Unit(operation.unit);
+            if (operation.realTime)
+            {
+                registered->UseRealTime();
+            }
+        }
+    }
+}
+
+template <typename T, typename Balance> void registerBinaryTreeSuite(const std::string &setName)
+{
+    using Set = BinaryTreeSet<T, Balance>;
+    registerOperations<T>(setName,
+                          {
+                              {"insert", BM_Insert<Set, T>, benchmark::kMillisecond},
+                              {"insertRange", BM_InsertRange<Set, T>, benchmark::kMillisecond},
+                              {"fromSorted", BM_FromSorted<Set, T>, benchmark::kMillisecond},
+                              {"parallelFromSorted", BM_ParallelFromSorted<Set, T>, benchmark::kMillisecond, true},
+                              {"contains", BM_Contains<Set, T>, benchmark::kNanosecond},
+                              {"containsBatch", BM_ContainsBatch<Set, T>, benchmark::kMicrosecond},
+                              {"find", BM_Find<Set, T>, benchmark::kNanosecond},
+                              {"rank", BM_Rank<Set, T>, benchmark::kNanosecond},
+                              {"select", BM_Select<Set, T>, benchmark::kNanosecond},
+                              {"erase", BM_Erase<Set, T>, benchmark::kMillisecond},
+                              {"merge", BM_Merge<Set, T>, benchmark::kMillisecond},
+                              {"unionWith", BM_SetAlgebra<Set, T, Algebra::Union>, benchmark::kMillisecond},
+                              {"intersectWith", BM_SetAlgebra<Set, T, Algebra::Intersection>,
+                               benchmark::kMillisecond},
+                              {"differenceWith", BM_SetAlgebra<Set, T, Algebra::Difference>,
+                               benchmark::kMillisecond},
+                              {"symmetricDifference", BM_SetAlgebra<Set, T, Algebra::SymmetricDifference>,
+                               benchmark::kMillisecond},
+                              {"parallelUnionWith", BM_SetAlgebra<Set, T, Algebra::Union, true>,
+                               benchmark::kMillisecond, true},
+                              {"parallelIntersectWith", BM_SetAlgebra<Set, T, Algebra::Intersection, true>,
+                               benchmark::kMillisecond, true},
+                              {"clear", BM_Clear<Set, T>, benchmark::kMillisecond},
+                              {"traverseInorder", BM_Traverse<Set, T, Traversal::Inorder>, benchmark::kMillisecond},
+                              {"traverseInorderFunction", BM_Traverse<Set, T, Traversal::InorderFunction>,
+                               benchmark::kMillisecond},
+                              {"traversePreorder", BM_Traverse<Set, T, Traversal::Preorder>, benchmark::kMillisecond},
+                              {"traversePostorder", BM_Traverse<Set, T, Traversal::Postorder>,
+                               benchmark::kMillisecond},
+                              {"iterate", BM_Traverse<Set, T, Traversal::Iterator>, benchmark::kMillisecond},
+                          },
+                          !Balance::rebalances);
+}
+
+//? BTreeSet has no node handles (find) and no pre/postorder, the shared operations use the same names as the
+//? binary trees so results line up side by side
+template <typename T> void registerBTreeSuite()
+{
+    using Set = BTreeSet<T>;
+    registerOperations<T>("BTreeSet",
+                          {
+                              {"insert", BM_Insert<Set, T>, benchmark::kMillisecond},
+                              {"insertRange", BM_InsertRange<Set, T>, benchmark::kMillisecond},
+                              {"contains", BM_Contains<Set, T>, benchmark::kNanosecond},
+                              {"erase", BM_Erase<Set, T>, benchmark::kMillisecond},
+                              {"merge", BM_Merge<Set, T>, benchmark::kMillisecond},
+                              {"clear", BM_Clear<Set, T>, benchmark::kMillisecond},
+                              {"traverseInorder", BM_Traverse<Set, T, Traversal::Inorder>, benchmark::kMillisecond},
+                          },
+                          false);
+}
+
+template <typename T> void registerArrayBaseline()
+{
+    registerOperations<T>("SortedArray",
+                          {
+                              {"traverseInorder", BM_ArrayScan<T>, benchmark::kMillisecond},
+                              {"lower_bound", BM_ArrayLowerBound<T>, benchmark::kNanosecond},
+                          },
+                          false);
+}
+
+template <typename T> void registerStaticSuite()
+{
+    registerOperations<T>("StaticSet",
+                          {
+                              {"freeze", BM_Freeze<T>, benchmark::kMillisecond},
+                              {"contains", BM_StaticSet<T, StaticQuery::Contains>, benchmark::kNanosecond},
+                              {"lower_bound", BM_StaticSet<T, StaticQuery::LowerBound>, benchmark::kNanosecond},
+                              {"rank", BM_StaticSet<T, StaticQuery::Rank>, benchmark::kNanosecond},
+                          },
+                          false);
+}
+
+//? Throughput of the mixed workload as threads are added, at several read/write ratios (items_per_second sums over
+//? all threads)
+template <typename Set> void registerConcurrentSuite(const std::string &setName)
+{
+    const int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int readPercent : {100, 90, 50})
+    {
+        const std::string name = "concurrentMix/" + setName + "<int>/read" + std::to_string(readPercent);
+        benchmark::RegisterBenchmark(name.c_str(), BM_ConcurrentMix<Set>, readPercent)
+            ->Arg(100'000)
+            ->ThreadRange(1, maxThreads)
+            ->UseRealTime()
+            ->Unit(benchmark::kNanosecond);
+    }
+}
+
+//? CompactTreeSet against the AvlTreeSet it shrinks, footprint reports the bytes per value next to the insert time
+template <typename T> void registerCompactSuite()
+{
+    using Set = CompactTreeSet<T>;
+    registerOperations<T>("CompactTreeSet",
+                          {
+                              {"insert", BM_Insert<Set, T>, benchmark::kMillisecond},
+                              {"fromSorted", BM_FromSorted<Set, T>, benchmark::kMillisecond},
+                              {"contains", BM_Contains<Set, T>, benchmark::kNanosecond},
+                              {"erase", BM_Erase<Set, T>, benchmark::kMillisecond},
+                              {"traverseInorder", BM_Traverse<Set, T, Traversal::Inorder>, benchmark::kMillisecond},
+                              {"footprint", BM_Footprint<Set, T>, benchmark::kMillisecond},
+                          },
+                          false);
+    registerOperations<T>("AvlTreeSet", {{"footprint", BM_Footprint<AvlTreeSet<T>, T>, benchmark::kMillisecond}},
+                          false);
+}
+
+//? The radix tree against the AVL tree on the same string keys, which share their first 10 bytes and more
+void registerStringSetSuite()
+{
+    using Set = StringSet;
+    registerOperations<std::string>("StringSet",
+                                    {
+                                        {"insert", BM_Insert<Set, std::string>, benchmark::kMillisecond},
+                                        {"contains", BM_Contains<Set, std::string>, benchmark::kNanosecond},
+                                        {"erase", BM_Erase<Set, std::string>, benchmark::kMillisecond},
+                                        {"traverseInorder", BM_Traverse<Set, std::string, Traversal::Inorder>,
+                                         benchmark::kMillisecond},
+                                        {"prefixScan", BM_PrefixScan<Set>, benchmark::kNanosecond},
+                                    },
+                                    false);
+    registerOperations<std::string>(
+        "AvlTreeSet", {{"prefixScan", BM_PrefixScan<AvlTreeSet<std::string>>, benchmark::kNanosecond}}, false);
+}
+
+//? Splay trees against the AVL tree: the usual operations, and lookups of Zipf skewed probes where the hot values
+//? splayed near the root should beat the balanced tree's log2(n) depth
+template <typename T> void registerSplaySuite()
+{
+    using Set = SplayTreeSet<T>;
+    registerOperations<T>("SplayTreeSet",
+                          {
+                              {"insert", BM_Insert<Set, T>, benchmark::kMillisecond},
+                              {"contains", BM_Contains<Set, T>, benchmark::kNanosecond},
+                              {"erase", BM_Erase<Set, T>, benchmark::kMillisecond},
+                          },
+                          false);
+
+    const std::vector<std::pair<std::string, void (*)(benchmark::State &, KeyOrder)>> sets = {
+        {"AvlTreeSet", BM_SkewedContains<AvlTreeSet<T>, T>},
+        {"SplayTreeSet", BM_SkewedContains<SplayTreeSet<T>, T>},
+        {"SampledSplayTreeSet", BM_SkewedContains<SampledSplayTreeSet<T>, T>},
+    };
+    for (KeyOrder order : {KeyOrder::Zipfian, KeyOrder::HotSet})
+    {
+        for (const auto &[setName, function] : sets)
+        {
+            const std::string name = "skewedContains/" + setName + "<" + typeName<T>() + ">/" +
+                                     benchmarks::keyOrderName(order);
+            benchmark::RegisterBenchmark(name.c_str(), function, order)
+                ->RangeMultiplier(10)
+                ->Range(1'000, 1'000'000)
+                ->Unit(benchmark::kNanosecond);
+        }
+    }
+}
+
+//? The same AVL tree recording TreeMetrics, to compare with AvlTreeSet: the cost of the counters and the two clock
+//? reads per operation
+template <typename T> void registerMetricsSuite()
+{
+    using Set = BinaryTreeSet<T, AvlBalanced, NodeArena<BinaryNode<T>>, std::less<>, TreeMetrics>;
+    registerOperations<T>("MeteredAvlTreeSet",
+                          {
+                              {"insert", BM_Insert<Set, T>, benchmark::kMillisecond},
+                              {"contains", BM_Contains<Set, T>, benchmark::kNanosecond},
+                          },
+                          false);
+}
+
+//? Parallel builds of random keys with 1, 2, 4, ... threads up to the core count
+template <typename T> void registerBuildScalingSuite()
+{
+    const int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const std::string name = std::string("parallelBuildScaling/AvlTreeSet<") + typeName<T>() + ">/random";
+    auto *registered = benchmark::RegisterBenchmark(name.c_str(), BM_ParallelBuildScaling<AvlTreeSet<T>, T>)
+                           ->ArgNames({"size", "threads"})
+                           ->UseRealTime()
+                           ->Unit(benchmark::kMillisecond);
+    for (int threads = 1;; threads = std::min(threads * 2, maxThreads))
+    {
+        registered->Args({10'000'000, threads});
+        if (threads == maxThreads)
+        {
+            break;
+        }
+    }
+}
+
+//? Saving, loading into a tree, and querying the file in place without a tree (MappedSet)
+template <typename T> void registerSetFileSuite()
+{
+    using Set = AvlTreeSet<T>;
+    registerOperations<T>("AvlTreeSet",
+                          {
+                              {"save", BM_Save<Set, T>, benchmark::kMillisecond},
+                              {"load", BM_Load<Set, T>, benchmark::kMillisecond},
+                          },
+                          false);
+    registerOperations<T>("MappedSet",
+                          {
+                              {"open", BM_MappedOpen<T>, benchmark::kMicrosecond},
+                              {"contains", BM_MappedContains<T>, benchmark::kNanosecond},
+                          },
+                          false);
+}
+
+template <typename Set> void registerScanSuite(const std::string &setName)
+{
+    const std::string name = "writesDuringScans/" + setName + "<int>";
+    benchmark::RegisterBenchmark(name.c_str(), BM_WritesDuringScans<Set>)
+        ->Arg(100'000)
+        ->UseRealTime()
+        ->Unit(benchmark::kMicrosecond);
+}
+
+//? Path copying makes every write allocate O(log n) nodes, these show what that costs against the mutable AVL tree
+template <typename T> void registerPersistentSuite()
+{
+    using Set = PersistentTreeSet<T>;
+    registerOperations<T>("PersistentTreeSet",
+                          {
+                              {"insert", BM_Insert<Set, T>, benchmark::kMillisecond},
+                              {"contains", BM_Contains<Set, T>, benchmark::kNanosecond},
+                              {"erase", BM_Erase<Set, T>, benchmark::kMillisecond},
+                              {"traverseInorder", BM_Traverse<Set, T, Traversal::Inorder>, benchmark::kMillisecond},
+                          },
+                          false);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    registerBinaryTreeSuite<int, Unbalanced>("BinaryTreeSet");
+    registerBinaryTreeSuite<double, Unbalanced>("BinaryTreeSet");
+    registerBinaryTreeSuite<std::string, Unbalanced>("BinaryTreeSet");
+    registerBinaryTreeSuite<int, AvlBalanced>("AvlTreeSet");
+    registerBinaryTreeSuite<double, AvlBalanced>("AvlTreeSet");
+    registerBinaryTreeSuite<std::string, AvlBalanced>("AvlTreeSet");
+    registerBTreeSuite<int>();
+    registerBTreeSuite<double>();
+    registerBTreeSuite<std::string>();
+    registerArrayBaseline<int>();
+    registerArrayBaseline<std::string>();
+    registerStaticSuite<int>();
+    registerStaticSuite<std::string>();
+    registerCompactSuite<int>();
+    registerCompactSuite<std::string>();
+    registerStringSetSuite();
+    registerSplaySuite<int>();
+    registerSplaySuite<std::string>();
+    registerMetricsSuite<int>();
+    registerBuildScalingSuite<int>();
+    registerBuildScalingSuite<std::string>();
+    registerConcurrentSuite<ConcurrentSkipListSet<int>>("ConcurrentSkipListSet");
+    registerConcurrentSuite<LockedAvlTreeSet<int>>("LockedAvlTreeSet");
+    registerConcurrentSuite<PersistentTreeSet<int>>("PersistentTreeSet");
+    registerPersistentSuite<int>();
+    registerPersistentSuite<std::string>();
+    registerScanSuite<PersistentTreeSet<int>>("PersistentTreeSet");
+    registerScanSuite<LockedAvlTreeSet<int>>("LockedAvlTreeSet");
+    registerSetFileSuite<int>();
+    registerSetFileSuite<std::string>();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
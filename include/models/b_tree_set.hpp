@@ -0,0 +1,236 @@
+#pragma once
+
+#include "node_arena.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace models
+{
+
+/**
+ * @brief Default minimum degree of a BTreeSet node, chosen so that a node's keys span about 256 bytes (4 cache lines)
+ *
+ * @tparam T The type of values stored in the set
+ * @return size_t The minimum degree t, nodes hold between t - 1 and 2t - 1 keys
+ */
+template <typename T> constexpr size_t defaultBTreeDegree()
+{
+    return std::max<size_t>(2, (256 / sizeof(T) + 1) / 2);
+}
+
+/**
+ * @brief An ordered set of unique values stored in a B-tree
+ *
+ * @tparam T The type of values stored in the set (supports int, double, std::string)
+ * @tparam MinDegree The minimum degree t of the tree: every node but the root holds between t - 1 and 2t - 1 sorted
+ * keys, and internal nodes have one more child than keys
+ *
+ * BTreeSet offers the same set operations as BinaryTreeSet, but keeps many sorted keys per node in one contiguous
+ * array, so a lookup touches O(log_t n) nodes instead of O(log2 n) and scans each node within a few cache lines.
+ * Leaves, which hold almost all of the keys, carry no child pointers at all. Nodes are allocated from a NodeArena.
+ * int and double nodes are searched with vector compares (see countLess), other types with a binary search.
+ *
+ * Insert and erase are the single-pass top-down algorithms (nodes are split or refilled on the way down), so like
+ * BinaryTreeSet nothing recurses. The tree is always perfectly balanced, every leaf is at the same depth.
+ */
+template <typename T, size_t MinDegree = defaultBTreeDegree<T>()> class BTreeSet
+{
+    static_assert(MinDegree >= 2, "A B-tree needs a minimum degree of at least 2");
+    //? 2 * MinDegree is max_keys + 1, the count of a full node's children
+    static_assert(2 * MinDegree <= std::numeric_limits<uint16_t>::max(),
+                  "Node key counts are 16-bit, so the minimum degree must be at most 32767");
+
+  private:
+    static constexpr size_t max_keys = 2 * MinDegree - 1;
+    static constexpr size_t min_keys = MinDegree - 1;
+
+    //? Leaves only hold keys, internal nodes extend them with child pointers
+    struct LeafNode
+    {
+        uint16_t count;
+        bool leaf;
+        T keys[max_keys];
+
+        LeafNode() : count(0), leaf(true)
+        {
+        }
+    };
+
+    struct InternalNode : LeafNode
+    {
+        LeafNode *children[max_keys + 1];
+
+        InternalNode() : LeafNode()
+        {
+            this->leaf = false;
+        }
+    };
+
+    LeafNode *root;
+    size_t tree_size;
+    int tree_height;
+    NodeArena<LeafNode> leaf_allocator;
+    NodeArena<InternalNode> internal_allocator;
+
+    //? Node helpers
+    static InternalNode *asInternal(LeafNode *node);
+    static const InternalNode *asInternal(const LeafNode *node);
+    static size_t lowerBound(const LeafNode *node, const T &value);
+    static bool matches(const LeafNode *node, size_t index, const T &value);
+    LeafNode *createLeaf();
+    InternalNode *createInternal();
+    void destroyNode(LeafNode *node);
+
+    //? Structural helpers used by insert and erase
+    void splitChild(InternalNode *parent, size_t index);
+    void mergeChildren(InternalNode *parent, size_t index);
+    void borrowFromLeft(InternalNode *parent, size_t index);
+    void borrowFromRight(InternalNode *parent, size_t index);
+    void ensureChildCanLose(InternalNode *parent, size_t &index);
+
+  public:
+    BTreeSet() : root(nullptr), tree_size(0), tree_height(-1)
+    {
+    }
+    ~BTreeSet()
+    {
+        clear();
+    }
+
+    BTreeSet(const BTreeSet &) = delete;
+    BTreeSet &operator=(const BTreeSet &) = delete;
+
+    //
+    //! ACCESSORS/GETTERS/FIELDS
+    //
+
+    /**
+     * @brief Get the total number of values in the set
+     *
+     * @return size_t The number of values currently in the set
+     */
+    size_t size() const
+    {
+        return tree_size;
+    }
+
+    /**
+     * @brief Check if the set is empty
+     *
+     * @return true if the set contains no values
+     * @return false if the set contains at least one value
+     */
+    bool empty() const
+    {
+        return tree_size == 0;
+    }
+
+    /**
+     * @brief Get the height of the B-tree
+     *
+     * @return int The number of edges from the root node down to the leaves
+     *
+     * - An empty tree has height -1
+     * - A tree whose root is a leaf has height 0
+     *
+     * Every leaf of a B-tree is at the same depth. The height is tracked on root splits and collapses, so this is O(1).
+     */
+    int height() const
+    {
+        return tree_height;
+    }
+
+    /**
+     * @brief Get the maximum number of keys a single node can hold
+     *
+     * @return size_t 2 * MinDegree - 1
+     */
+    static constexpr size_t nodeCapacity()
+    {
+        return max_keys;
+    }
+
+    /**
+     * @brief Get the allocation counters of the leaf and internal node arenas combined
+     *
+     * @return AllocationStats Node allocations/deallocations, calls to the system allocator and bytes reserved/in use
+     */
+    AllocationStats allocationStats() const;
+
+    //
+    //! MODIFICATION OPERATIONS
+    //
+
+    /**
+     * @brief Insert the provided value into the set
+     *
+     * @param value The value to insert
+     * @throws std::invalid_argument if T is std::string and the value is empty (same contract as BinaryNode)
+     *
+     * Full nodes met on the way down are split before descending into them, so the value can always be placed in
+     * its leaf without walking back up. If the value already exists in the set, it will not be inserted again.
+     */
+    void insert(const T &value);
+
+    /**
+     * @brief Inserts a copy of each element in the range if and only if there is no element with that value already
+     * present.
+     *
+     * @param range A vector containing elements to insert into the set
+     */
+    void insertRange(const std::vector<T> &range);
+
+    /**
+     * @brief Merges another B-tree set into this one
+     *
+     * @param set The set to merge into this one, it remains unchanged
+     */
+    void merge(const BTreeSet &set);
+
+    /**
+     * @brief Searches the set for the given value
+     *
+     * @param value The value to search for
+     * @return true if the value is found in the set
+     * @return false if the value is not found in the set
+     */
+    bool contains(const T &value) const;
+
+    /**
+     * @brief Removes the given value from the set
+     *
+     * @param value The value to remove
+     * @return true if the value was found and removed
+     * @return false if the value was not found in the set
+     *
+     * Children holding the minimum number of keys are refilled from a sibling (or merged with one) before
+     * descending into them, so the key can always be removed without walking back up. A key removed from an
+     * internal node is replaced by its predecessor or successor from a leaf.
+     */
+    bool erase(const T &value);
+
+    /**
+     * @brief Removes all values from the set and releases every node
+     */
+    void clear();
+
+    //
+    //! TRAVERSAL OPERATIONS
+    //
+
+    /**
+     * @brief Runs the callback on every value in ascending order
+     *
+     * @param callback A function to execute on each value during traversal
+     *
+     * Uses a fixed-size stack of (node, position) frames, the tree can never be deeper than it has room for.
+     */
+    void traverseInorder(std::function<void(const T &)> callback) const;
+};
+
+} // namespace models
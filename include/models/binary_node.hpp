@@ -1,11 +1,14 @@
 #pragma once
+#include <cstddef>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace models
 {
 // Forward declaration for friend class
-template <typename U> class BinaryTreeSet;
+template <typename U, typename Balance, typename Allocator, typename Compare, typename Metrics>
+class BinaryTreeSet;
 
 /**
  * @brief A node in a binary tree set
@@ -16,6 +19,9 @@ template <typename U> class BinaryTreeSet;
  * - data: The value stored in the node
  * - left: Pointer to left child node (contains values less than current node)
  * - right: Pointer to right child node (contains values greater than current node)
+ * - parent: Pointer to the parent node (nullptr for the root), used to walk the tree without recursion
+ * - height: Height of the subtree rooted at this node, maintained by the owning BinaryTreeSet
+ * - size: Number of nodes in the subtree rooted at this node, maintained by the owning BinaryTreeSet
  *
  * This class is designed to prevent accidental modification of tree structure.
  * Only read-only access to node values and child pointers is provided to users.
@@ -25,7 +31,9 @@ template <typename T> class BinaryNode
 {
   private:
     T data;
-    BinaryNode *left_, *right_;
+    BinaryNode *left_, *right_, *parent_;
+    int height_;
+    size_t size_;
 
     // Private methods for BinaryTreeSet to use internally
     // These methods are not available to users to prevent tree structure corruption
@@ -56,6 +64,27 @@ template <typename T> class BinaryNode
      */
     void setRightPtr(BinaryNode<T> *node);
 
+    /**
+     * @brief Set the parent pointer directly (private - only for BinaryTreeSet)
+     *
+     * @param node Pointer to the node to set as the parent, or nullptr for the root
+     */
+    void setParentPtr(BinaryNode<T> *node);
+
+    /**
+     * @brief Set the cached height of the subtree rooted at this node (private - only for BinaryTreeSet)
+     *
+     * @param height The height of this node's subtree (0 for a leaf)
+     */
+    void setHeight(int height);
+
+    /**
+     * @brief Set the cached size of the subtree rooted at this node (private - only for BinaryTreeSet)
+     *
+     * @param size The number of nodes in this node's subtree (1 for a leaf)
+     */
+    void setSize(size_t size);
+
     /**
      * @brief Get the left child node (non-const version - private for BinaryTreeSet)
      *
@@ -70,6 +99,13 @@ template <typename T> class BinaryNode
      */
     BinaryNode<T> *right();
 
+    /**
+     * @brief Get the parent node (non-const version - private for BinaryTreeSet)
+     *
+     * @return BinaryNode<T>* Pointer to the parent node, or nullptr if this node is the root
+     */
+    BinaryNode<T> *parent();
+
   public:
     /**
      * @brief Construct a new BinaryNode with the given value
@@ -83,12 +119,20 @@ template <typename T> class BinaryNode
      */
     BinaryNode(const T &value);
 
+    /**
+     * @brief Construct a new BinaryNode by moving the given value into it
+     *
+     * @param value The value to move into this node
+     * @throws std::invalid_argument if the value is invalid (e.g., empty string for std::string)
+     */
+    BinaryNode(T &&value);
+
     /**
      * @brief Get the value stored in this node
      *
-     * @return const T The value stored in this node
+     * @return const T& Reference to the value stored in this node
      */
-    const T value() const;
+    const T &value() const;
 
     /**
      * @brief Get the left child node (read-only access)
@@ -104,8 +148,30 @@ template <typename T> class BinaryNode
      */
     const BinaryNode<T> *right() const;
 
+    /**
+     * @brief Get the parent node (read-only access)
+     *
+     * @return const BinaryNode<T>* Pointer to the parent node, or nullptr if this node is the root
+     */
+    const BinaryNode<T> *parent() const;
+
+    /**
+     * @brief Get the height of the subtree rooted at this node
+     *
+     * @return int The number of edges on the longest path from this node down to a leaf (0 for a leaf)
+     */
+    int height() const;
+
+    /**
+     * @brief Get the number of nodes in the subtree rooted at this node
+     *
+     * @return size_t The number of nodes in this node's subtree, itself included (1 for a leaf)
+     */
+    size_t size() const;
+
     // Make BinaryTreeSet a friend class to access private members for tree operations
-    template <typename U> friend class BinaryTreeSet;
+    template <typename U, typename Balance, typename Allocator, typename Compare, typename Metrics>
+    friend class BinaryTreeSet;
 };
 
 //? Implementation
@@ -118,10 +184,12 @@ template <typename T> class BinaryNode
  * @tparam T The type of data stored in the node
  * @param value The value to store in this node
  *
- * Initializes a new BinaryNode with the specified value and sets both
- * left and right child pointers to nullptr.
+ * Initializes a new BinaryNode with the specified value and sets the
+ * left, right and parent pointers to nullptr.
  */
-template <typename T> BinaryNode<T>::BinaryNode(const T &value) : data(value), left_(nullptr), right_(nullptr)
+template <typename T>
+BinaryNode<T>::BinaryNode(const T &value)
+    : data(value), left_(nullptr), right_(nullptr), parent_(nullptr), height_(0), size_(1)
 {
 }
 
@@ -135,7 +203,8 @@ template <typename T> BinaryNode<T>::BinaryNode(const T &value) : data(value), l
  * cannot be empty, maintaining data integrity for the binary tree.
  */
 template <>
-inline BinaryNode<std::string>::BinaryNode(const std::string &value) : data(value), left_(nullptr), right_(nullptr)
+inline BinaryNode<std::string>::BinaryNode(const std::string &value)
+    : data(value), left_(nullptr), right_(nullptr), parent_(nullptr), height_(0), size_(1)
 {
     if (value.empty())
     {
@@ -143,15 +212,38 @@ inline BinaryNode<std::string>::BinaryNode(const std::string &value) : data(valu
     }
 }
 
+template <typename T>
+BinaryNode<T>::BinaryNode(T &&value)
+    : data(std::move(value)), left_(nullptr), right_(nullptr), parent_(nullptr), height_(0), size_(1)
+{
+}
+
+/**
+ * @brief Template specialization for std::string move constructor
+ *
+ * @param value The string value to move into this node
+ * @throws std::invalid_argument if the string is empty (the value is left untouched)
+ */
+template <>
+inline BinaryNode<std::string>::BinaryNode(std::string &&value)
+    : left_(nullptr), right_(nullptr), parent_(nullptr), height_(0), size_(1)
+{
+    if (value.empty())
+    {
+        throw std::invalid_argument("String value cannot be empty");
+    }
+    data = std::move(value);
+}
+
 /**
  * @brief Get the value stored in this node
  *
  * @tparam T The type of data stored in the node
- * @return const T The value stored in this node
+ * @return const T& Reference to the value stored in this node
  *
- * Returns a const reference to the data stored in this node.
+ * Returns a const reference to the data stored in this node, so comparisons during a search never copy it.
  */
-template <typename T> const T BinaryNode<T>::value() const
+template <typename T> const T &BinaryNode<T>::value() const
 {
     return data;
 }
@@ -219,6 +311,19 @@ template <typename T> const BinaryNode<T> *BinaryNode<T>::right() const
     return right_;
 }
 
+/**
+ * @brief Get the parent node (const version)
+ *
+ * @tparam T The type of data stored in the node
+ * @return const BinaryNode<T>* Pointer to the parent node, or nullptr if this node is the root
+ *
+ * Returns a const pointer to the parent node, allowing read-only access.
+ */
+template <typename T> const BinaryNode<T> *BinaryNode<T>::parent() const
+{
+    return parent_;
+}
+
 /**
  * @brief Get the left child node (non-const version - private for BinaryTreeSet)
  *
@@ -249,6 +354,21 @@ template <typename T> BinaryNode<T> *BinaryNode<T>::right()
     return right_;
 }
 
+/**
+ * @brief Get the parent node (non-const version - private for BinaryTreeSet)
+ *
+ * @tparam T The type of data stored in the node
+ * @return BinaryNode<T>* Pointer to the parent node, or nullptr if this node is the root
+ *
+ * Returns a non-const pointer to the parent node for internal tree operations.
+ * This method is private and only accessible by BinaryTreeSet to prevent
+ * accidental modification of tree structure.
+ */
+template <typename T> BinaryNode<T> *BinaryNode<T>::parent()
+{
+    return parent_;
+}
+
 /**
  * @brief Set the left child pointer directly (private method for BinaryTreeSet)
  *
@@ -281,6 +401,78 @@ template <typename T> void BinaryNode<T>::setRightPtr(BinaryNode<T> *node)
     right_ = node;
 }
 
+/**
+ * @brief Set the parent pointer directly (private method for BinaryTreeSet)
+ *
+ * @tparam T The type of data stored in the node
+ * @param node Pointer to the node to set as the parent, or nullptr for the root
+ *
+ * The parent pointer is not kept in sync by setLeftPtr/setRightPtr, BinaryTreeSet updates
+ * both sides of a link explicitly during tree restructuring operations.
+ * This method is private and only accessible by BinaryTreeSet to prevent
+ * accidental modification of tree structure.
+ */
+template <typename T> void BinaryNode<T>::setParentPtr(BinaryNode<T> *node)
+{
+    parent_ = node;
+}
+
+/**
+ * @brief Get the height of the subtree rooted at this node
+ *
+ * @tparam T The type of data stored in the node
+ * @return int The height of this node's subtree (0 for a leaf)
+ *
+ * The height is cached in the node and kept up to date by BinaryTreeSet on every structural change,
+ * so reading it is O(1).
+ */
+template <typename T> int BinaryNode<T>::height() const
+{
+    return height_;
+}
+
+/**
+ * @brief Set the cached height of the subtree rooted at this node (private method for BinaryTreeSet)
+ *
+ * @tparam T The type of data stored in the node
+ * @param height The height of this node's subtree
+ *
+ * This method is private and only accessible by BinaryTreeSet, which recomputes the height from the
+ * children after every insert, erase and rotation.
+ */
+template <typename T> void BinaryNode<T>::setHeight(int height)
+{
+    height_ = height;
+}
+
+/**
+ * @brief Get the number of nodes in the subtree rooted at this node
+ *
+ * @tparam T The type of data stored in the node
+ * @return size_t The number of nodes in this node's subtree, itself included
+ *
+ * Like the height, the size is cached in the node and kept up to date by BinaryTreeSet, which uses it to answer
+ * rank and select queries in O(log n).
+ */
+template <typename T> size_t BinaryNode<T>::size() const
+{
+    return size_;
+}
+
+/**
+ * @brief Set the cached size of the subtree rooted at this node (private method for BinaryTreeSet)
+ *
+ * @tparam T The type of data stored in the node
+ * @param size The number of nodes in this node's subtree
+ *
+ * This method is private and only accessible by BinaryTreeSet, which recomputes the size from the children
+ * on every path it modifies.
+ */
+template <typename T> void BinaryNode<T>::setSize(size_t size)
+{
+    size_ = size;
+}
+
 // Explicit template instantiations for supported types
 template class BinaryNode<int>;
 template class BinaryNode<double>;
@@ -1,34 +1,445 @@
 #pragma once
 
 #include "binary_node.hpp"
+#include "node_arena.hpp"
+#include "set_file.hpp"
+#include "static_set.hpp"
+#include "tree_metrics.hpp"
+#include "tree_policies.hpp"
+#include "work_stealing_pool.hpp"
 
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace models
 {
 
-template <typename T> class BinaryTreeSet
+/**
+ * @brief An ordered set of unique values stored in a binary search tree
+ *
+ * @tparam T The type of values stored in the set, any type the comparator can order
+ * @tparam Balance The balancing policy applied after each modification (see tree_policies.hpp):
+ * - Unbalanced: a plain binary search tree whose shape follows the insertion order (default)
+ * - AvlBalanced: an AVL tree, O(log n) worst case insert, find and erase
+ * - Splaying, SampledSplaying<Period>: a splay tree, accessed values move to the root, O(log n) amortized
+ * @tparam Allocator The node allocator policy (see node_arena.hpp):
+ * - NodeArena: nodes are carved from contiguous slabs and recycled through a free list (default)
+ * - HeapNodeAllocator: every node is a separate new/delete
+ * @tparam Compare A strict weak ordering on T, called as compare(a, b) for "a before b". Defaults to std::less<>,
+ * i.e. operator<. A stateless comparator takes no space, and a transparent one (with an is_transparent member type,
+ * like std::less<>) enables lookups by other key types. Use std::greater<> for descending order, or compare a
+ * single field of a struct to key it by that field
+ * @tparam Metrics The metrics policy (see tree_metrics.hpp):
+ * - NoMetrics: nothing is recorded, and the set is exactly as large and as fast as without the parameter (default)
+ * - TreeMetrics: insert, erase, contains and find record their comparisons, visited nodes, allocations, rotations,
+ *   depth and latency, read through metrics().snapshot(). Lookups then write to the set, so even const lookups must
+ *   not run concurrently
+ *
+ * Searches make one comparison per level: the descent only asks "is the value before this node", remembers the last
+ * node that is not after it, and tests that candidate for equality once at the bottom. The splaying policies compare
+ * twice per level instead, so lookups of the hot values they keep near the root stop there.
+ *
+ * The class is header-only, so it works with any T and Compare.
+ */
+template <typename T, typename Balance = Unbalanced, typename Allocator = NodeArena<BinaryNode<T>>,
+          typename Compare = std::less<>, typename Metrics = NoMetrics>
+class BinaryTreeSet : private CompareHolder<Compare>, private MetricsHolder<Metrics>
 {
   private:
-    BinaryNode<T> *root;
+    mutable BinaryNode<T> *root; //? The splaying policies move the root in const lookups
     size_t tree_size;
+    Allocator allocator;
 
-    //? Recursive helpers & primary logic
-    int findHeightRecursive(const BinaryNode<T> *node) const;
-    BinaryNode<T> *insertValueRecursive(BinaryNode<T> *node, const T &value, bool &inserted);
-    BinaryNode<T> *findValueRecursive(const BinaryNode<T> *node, const T &value) const;
-    BinaryNode<T> *removeValueRecursive(BinaryNode<T> *node, const T &value, bool &removed);
-    void clearTreeRecursive(BinaryNode<T> *node);
+    //? Linking & balancing helpers
+    static int nodeHeight(const BinaryNode<T> *node);
+    static size_t nodeSize(const BinaryNode<T> *node);
+    static void updateNode(BinaryNode<T> *node);
+    void replaceChild(BinaryNode<T> *parent, BinaryNode<T> *child, BinaryNode<T> *replacement);
+    BinaryNode<T> *rotateLeft(BinaryNode<T> *node);
+    BinaryNode<T> *rotateRight(BinaryNode<T> *node);
+    BinaryNode<T> *rebalance(BinaryNode<T> *node);
+    void retraceFrom(BinaryNode<T> *node);
+    void rotateUp(BinaryNode<T> *node);
+    void splay(BinaryNode<T> *node);
+    void splayAccessed(BinaryNode<T> *node);
+    void buildBalanced(std::vector<T> &&values);
 
-    //? traversal helpers...
-    void traverseInorderRecursive(const BinaryNode<T> *node, std::function<void(const T &)> callback) const;
-    void traversePreorderRecursive(const BinaryNode<T> *node, std::function<void(const T &)> callback) const;
-    void traversePostorderRecursive(const BinaryNode<T> *node, std::function<void(const T &)> callback) const;
+    //? Set algebra helpers: flatten a tree into its sorted nodes, and link sorted nodes back into a balanced tree
+    void detachInorder(std::vector<BinaryNode<T> *> &nodes);
+    void linkBalanced(std::vector<BinaryNode<T> *> &nodes);
+    void linkRange(std::vector<BinaryNode<T> *> &nodes, size_t first, size_t last, BinaryNode<T> *parent, bool isLeft);
+    void attachNode(BinaryNode<T> *node, size_t count, BinaryNode<T> *parent, bool isLeft);
+    void relinkAfterFailure(std::vector<BinaryNode<T> *> &kept, std::vector<BinaryNode<T> *> &ours, size_t next);
+
+    //? Parallel set algebra helpers
+    enum class SetOperation
+    {
+        Union,
+        Intersection,
+        Difference,
+        SymmetricDifference
+    };
+    template <typename Node> static void collectSubtree(Node *node, std::vector<Node *> &out);
+    template <typename Node>
+    static std::vector<Node *> flattenParallel(Node *root, size_t size, WorkStealingPool &pool);
+    void linkRangeParallel(std::vector<BinaryNode<T> *> &nodes, size_t first, size_t last, BinaryNode<T> *parent,
+                           bool isLeft, WorkStealingPool &pool, size_t grainSize);
+    //? With a donor (donor == &other), other's nodes are relinked instead of copied and other is left empty
+    void parallelSetOperation(const BinaryTreeSet &other, SetOperation operation, WorkStealingPool &pool,
+                              size_t grainSize, BinaryTreeSet *donor = nullptr);
+    void buildBalancedParallel(std::vector<T> &&values, WorkStealingPool &pool, size_t grainSize);
+
+    //? Set algebra walks both sets in order, which only works if they are ordered alike. Comparators with an
+    //? operator== are checked in debug builds, others (std::less, lambdas) cannot be
+    template <typename C, typename = void> struct HasEquality : std::false_type
+    {
+    };
+    template <typename C>
+    struct HasEquality<C, std::void_t<decltype(std::declval<const C &>() == std::declval<const C &>())>>
+        : std::true_type
+    {
+    };
+    void assertSameOrdering([[maybe_unused]] const BinaryTreeSet &other) const
+    {
+        if constexpr (HasEquality<Compare>::value)
+        {
+            assert(this->comparator() == other.comparator() && "Set algebra needs both sets ordered alike");
+        }
+    }
+
+    //? Insertion helpers: find where a new value hangs off the tree, then link a node created for it there
+    BinaryNode<T> *insertionParent(const T &value, bool &duplicate) const;
+    void linkLeaf(BinaryNode<T> *node, BinaryNode<T> *parent);
+
+    template <typename A, typename B> bool less(const A &left, const B &right) const
+    {
+        return this->comparator()(left, right);
+    }
+
+    //? less() in the searches of insert, erase, contains and find, counted by the metrics policy
+    template <typename A, typename B> bool countedLess(const A &left, const B &right) const
+    {
+        this->metricsState().comparison();
+        return this->comparator()(left, right);
+    }
+
+    //? Heterogeneous lookup keys: with a transparent comparator, types other than T that it can compare with T in
+    //? both directions, such as std::string_view or const char * for a std::string set. Arithmetic keys for an
+    //? arithmetic T keep converting to T, so contains(2.5) on an int set behaves as before
+    template <typename Key, typename = void> struct IsLookupKey : std::false_type
+    {
+    };
+    template <typename Key>
+    struct IsLookupKey<Key, std::void_t<typename Compare::is_transparent,
+                                        decltype(std::declval<const Compare &>()(std::declval<const Key &>(),
+                                                                                 std::declval<const T &>())),
+                                        decltype(std::declval<const Compare &>()(std::declval<const T &>(),
+                                                                                 std::declval<const Key &>()))>>
+        : std::bool_constant<!std::is_same_v<Key, T> && !(std::is_arithmetic_v<Key> && std::is_arithmetic_v<T>)>
+    {
+    };
+    template <typename Key> using EnableIfLookupKey = std::enable_if_t<IsLookupKey<Key>::value, int>;
+
+    //? The last node where the descent turned left is the smallest value that is not before key
+    template <typename Key> BinaryNode<T> *lowerBoundNode(const Key &key) const
+    {
+        BinaryNode<T> *node = root;
+        BinaryNode<T> *bound = nullptr;
+        while (node)
+        {
+            this->metricsState().visit();
+            if (countedLess(node->value(), key))
+            {
+                node = node->right();
+            }
+            else
+            {
+                bound = node;
+                node = node->left();
+            }
+        }
+        return bound;
+    }
+
+    template <typename Key> BinaryNode<T> *findNode(const Key &key) const
+    {
+        BinaryNode<T> *node = lowerBoundNode(key);
+        return node && !countedLess(key, node->value()) ? node : nullptr;
+    }
+
+    //? The splaying policies keep hot values near the root, so their searches stop at an equal node, at the cost of
+    //? a second comparison per level. last receives the last node visited, the one to splay after a miss
+    template <typename Key> BinaryNode<T> *searchNode(const Key &key, BinaryNode<T> *&last) const
+    {
+        BinaryNode<T> *node = root;
+        last = nullptr;
+        while (node)
+        {
+            last = node;
+            this->metricsState().visit();
+            if (countedLess(key, node->value()))
+            {
+                node = node->left();
+            }
+            else if (countedLess(node->value(), key))
+            {
+                node = node->right();
+            }
+            else
+            {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    //? contains() and find(): findNode, or with a splaying policy a search that splays what it reached
+    template <typename Key> BinaryNode<T> *lookupNode(const Key &key) const
+    {
+        if constexpr (Balance::splays)
+        {
+            BinaryNode<T> *last;
+            BinaryNode<T> *node = searchNode(key, last);
+            if (last && Balance::splayLookup())
+            {
+                const_cast<BinaryTreeSet *>(this)->splay(node ? node : last);
+            }
+            return node;
+        }
+        else
+        {
+            return findNode(key);
+        }
+    }
+
+    //? Number of lookups a batch keeps in flight, enough to cover the line fill buffers of current cores
+    static constexpr size_t batch_lanes = 16;
+
+    template <typename Emit> void lowerBoundBatch(const T *keys, size_t count, Emit &&emit) const;
+
+    //? Iterative lookup & navigation helpers, none of them use more than O(1) extra space. The navigation helpers
+    //? are defined here so iterators and templated traversals inline them into the caller's loop
+
+    static const BinaryNode<T> *leftmost(const BinaryNode<T> *node)
+    {
+        while (node && node->left())
+        {
+            node = node->left();
+        }
+        return node;
+    }
+
+    static const BinaryNode<T> *rightmost(const BinaryNode<T> *node)
+    {
+        while (node && node->right())
+        {
+            node = node->right();
+        }
+        return node;
+    }
+
+    static const BinaryNode<T> *nextInorder(const BinaryNode<T> *node)
+    {
+        if (node->right())
+        {
+            return leftmost(node->right());
+        }
+
+        //? Climb until we arrive from a left child, that parent is the next larger value
+        const BinaryNode<T> *parent = node->parent();
+        while (parent && node == parent->right())
+        {
+            node = parent;
+            parent = parent->parent();
+        }
+        return parent;
+    }
+
+    static const BinaryNode<T> *previousInorder(const BinaryNode<T> *node)
+    {
+        if (node->left())
+        {
+            return rightmost(node->left());
+        }
+
+        const BinaryNode<T> *parent = node->parent();
+        while (parent && node == parent->left())
+        {
+            node = parent;
+            parent = parent->parent();
+        }
+        return parent;
+    }
+
+    static const BinaryNode<T> *nextPreorder(const BinaryNode<T> *node)
+    {
+        if (node->left())
+        {
+            return node->left();
+        }
+        if (node->right())
+        {
+            return node->right();
+        }
+
+        //? Leaf: climb until an ancestor has an unvisited right subtree
+        const BinaryNode<T> *parent = node->parent();
+        while (parent && (node == parent->right() || !parent->right()))
+        {
+            node = parent;
+            parent = parent->parent();
+        }
+        return parent ? parent->right() : nullptr;
+    }
+
+    static const BinaryNode<T> *firstPostorder(const BinaryNode<T> *node)
+    {
+        //? The first node in postorder is the leaf reached by preferring left children, then right children
+        while (node)
+        {
+            if (node->left())
+            {
+                node = node->left();
+            }
+            else if (node->right())
+            {
+                node = node->right();
+            }
+            else
+            {
+                break;
+            }
+        }
+        return node;
+    }
+
+    static const BinaryNode<T> *nextPostorder(const BinaryNode<T> *node)
+    {
+        const BinaryNode<T> *parent = node->parent();
+        if (parent && node == parent->left() && parent->right())
+        {
+            return firstPostorder(parent->right());
+        }
+        return parent;
+    }
+
+    //? Callbacks may return void to visit everything, or something convertible to bool to stop early on false
+    template <typename Callback> static bool visit(Callback &callback, const BinaryNode<T> *node)
+    {
+        if constexpr (std::is_void_v<std::invoke_result_t<Callback &, const T &>>)
+        {
+            callback(node->value());
+            return true;
+        }
+        else
+        {
+            return static_cast<bool>(callback(node->value()));
+        }
+    }
 
   public:
-    BinaryTreeSet() : root(nullptr), tree_size(0)
+    /**
+     * @brief A bidirectional iterator over the values of the set in ascending order
+     *
+     * The iterator is a node pointer: ++ and -- follow child and parent pointers, so iteration needs no auxiliary
+     * stack and any iterator can be resumed later. Like std::set, values are read-only, and erasing a value only
+     * invalidates iterators to that value.
+     */
+    class const_iterator
+    {
+      private:
+        const BinaryNode<T> *node;
+        const BinaryTreeSet *set;
+
+        const_iterator(const BinaryNode<T> *node, const BinaryTreeSet *set) : node(node), set(set)
+        {
+        }
+        friend class BinaryTreeSet;
+
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() : node(nullptr), set(nullptr)
+        {
+        }
+
+        reference operator*() const
+        {
+            return node->value();
+        }
+
+        pointer operator->() const
+        {
+            return &node->value();
+        }
+
+        const_iterator &operator++()
+        {
+            node = nextInorder(node);
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        const_iterator &operator--()
+        {
+            //? Stepping back from end() lands on the largest value
+            node = node ? previousInorder(node) : rightmost(set->root);
+            return *this;
+        }
+
+        const_iterator operator--(int)
+        {
+            const_iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator &other) const
+        {
+            return node == other.node;
+        }
+
+        bool operator!=(const const_iterator &other) const
+        {
+            return node != other.node;
+        }
+    };
+
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_reference = const T &;
+    using iterator = const_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reverse_iterator = const_reverse_iterator;
+
+    BinaryTreeSet() : CompareHolder<Compare>(Compare()), root(nullptr), tree_size(0)
+    {
+    }
+
+    /**
+     * @brief Create an empty set ordered by the given comparator
+     *
+     * @param compare The comparator, copied into the set (stateless comparators take no space)
+     */
+    explicit BinaryTreeSet(const Compare &compare) : CompareHolder<Compare>(compare), root(nullptr), tree_size(0)
     {
     }
     ~BinaryTreeSet()
@@ -36,10 +447,127 @@ template <typename T> class BinaryTreeSet
         clear();
     }
 
+    BinaryTreeSet(const BinaryTreeSet &) = delete;
+    BinaryTreeSet &operator=(const BinaryTreeSet &) = delete;
+
+    /**
+     * @brief Take over the nodes of another set, which is left empty
+     *
+     * Nodes are not copied or reallocated, the allocator holding them moves along with them.
+     */
+    BinaryTreeSet(BinaryTreeSet &&other) noexcept;
+    BinaryTreeSet &operator=(BinaryTreeSet &&other) noexcept;
+
+    /**
+     * @brief Build a height-minimal set from a range of values in linear time
+     *
+     * @tparam InputIt An input iterator whose values convert to T, pass std::move_iterator to move values (such as
+     * std::string keys) into the nodes instead of copying them
+     * @param first The beginning of the range
+     * @param last The end of the range
+     * @param compare The comparator of the new set
+     * @return BinaryTreeSet A new set holding every distinct value of the range
+     * @throws std::invalid_argument if T is std::string and the range holds an empty string
+     *
+     * Sorted input (the common case for snapshot files) is detected in one pass and built in O(n), anything else is
+     * sorted first. Duplicates are dropped. Every node is allocated from a single block, and each subtree is built
+     * from the middle of its range, so the height is floor(log2 n) and the result is a valid AVL tree as well.
+     */
+    template <typename InputIt>
+    static BinaryTreeSet fromSorted(InputIt first, InputIt last, const Compare &compare = Compare())
+    {
+        BinaryTreeSet set(compare);
+        set.buildBalanced(std::vector<T>(first, last));
+        return set;
+    }
+
+    /**
+     * @brief Parallel fromSorted, for large and unsorted ranges
+     *
+     * @param first The beginning of the range, use std::make_move_iterator to move the values instead of copying
+     * @param last The end of the range
+     * @param pool The thread pool running the build, its size sets the number of threads
+     * @param grainSize The number of values below which work is not split any further
+     * @param compare The comparator of the new set
+     * @return BinaryTreeSet The same set fromSorted(first, last, compare) returns
+     * @throws std::invalid_argument if T is std::string and the range holds an empty string
+     *
+     * Runs as a sample sort: splitters drawn from a sample cut the values into about eight buckets per thread, every
+     * block of the input is counted and scattered into the buckets in parallel, and then each bucket is sorted,
+     * deduplicated and turned into nodes by one task, through its own allocator. Equal values always land in the
+     * same bucket, so no duplicates cross bucket borders. Sorted input skips the scatter and is cut at block
+     * borders instead. The nodes are finally linked by parallel halves, like the parallel set algebra. T has to be
+     * default constructible for the scatter buffer.
+     */
+    template <typename InputIt>
+    static BinaryTreeSet fromSorted(InputIt first, InputIt last, WorkStealingPool &pool,
+                                    size_t grainSize = default_parallel_grain, const Compare &compare = Compare())
+    {
+        BinaryTreeSet set(compare);
+        set.buildBalancedParallel(std::vector<T>(first, last), pool, grainSize);
+        return set;
+    }
+
+    /**
+     * @brief Read a set back from a file written by save()
+     *
+     * @param path The set file
+     * @param compare The comparator of the new set, which must order values like the one of the saved set
+     * @return BinaryTreeSet A new set holding the values of the file
+     * @throws std::runtime_error if the file cannot be read or holds another key type
+     *
+     * The file is memory-mapped and its sorted values are linked into a balanced tree in O(n) by fromSorted, without
+     * a single comparison-based insert. To query a saved set without building a tree at all, use MappedSet.
+     */
+    static BinaryTreeSet load(const std::string &path, const Compare &compare = Compare())
+    {
+        const MappedSet<T, Compare> mapped(path, compare);
+        return fromSorted(mapped.begin(), mapped.end(), compare);
+    }
+
+    /**
+     * @brief Write the set to a file in sorted, pointer-free form (see SetFileHeader)
+     *
+     * @param path The file to create or overwrite
+     * @throws std::runtime_error if the file cannot be written
+     *
+     * T must be trivially copyable, or std::string (stored in an offset-addressed string pool). The file can be
+     * mapped and queried in place by MappedSet, from any number of processes sharing its pages, or turned back into
+     * a tree by load().
+     */
+    void save(const std::string &path) const
+    {
+        writeSetFile<T>(path, tree_size, [this](auto &&callback) { traverseInorder(callback); });
+    }
+
+    /**
+     * @brief Copy the set into an immutable StaticSet, laid out for searching
+     *
+     * @return StaticSet<T, Compare> A set with the same values and comparator, in Eytzinger order
+     *
+     * The values are copied straight from an inorder traversal into their final slots, in O(n). Use this once a set
+     * is complete and only queried from then on.
+     */
+    StaticSet<T, Compare> freeze() const
+    {
+        return StaticSet<T, Compare>(
+            tree_size, [this](auto &&callback) { traverseInorder(callback); }, this->comparator());
+    }
+
     //
     //! ACCESSORS/GETTERS/FIELDS
     //
 
+    /**
+     * @brief Get a copy of the comparator that orders the set
+     *
+     * @return Compare The comparator
+     */
+    Compare key_comp() const
+    {
+        return this->comparator();
+    }
+
     /**
      * @brief Get the root node of the binary tree with read-only access
      *
@@ -76,6 +604,36 @@ template <typename T> class BinaryTreeSet
         return tree_size;
     }
 
+    /**
+     * @brief Get the allocation counters of the node allocator backing this tree
+     *
+     * @return AllocationStats Node allocations/deallocations, calls to the system allocator and bytes reserved/in use
+     */
+    AllocationStats allocationStats() const
+    {
+        return allocator.stats();
+    }
+
+    /**
+     * @brief Get the metrics policy of this tree, e.g. metrics().snapshot() with TreeMetrics
+     *
+     * @return const Metrics& The policy, recording until the tree is destroyed
+     */
+    const Metrics &metrics() const
+    {
+        return this->metricsState();
+    }
+
+    /**
+     * @brief Get the metrics policy of this tree, e.g. to reset() it after exporting a snapshot
+     *
+     * @return Metrics& The policy
+     */
+    Metrics &metrics()
+    {
+        return this->metricsState();
+    }
+
     /**
      * @brief Check if the binary tree is empty (the root node pointer is a nullptr)
      *
@@ -96,9 +654,151 @@ template <typename T> class BinaryTreeSet
      * - An empty tree has height -1
      * - A tree with only a root node has height 0
      * - Otherwise, height is max(left_subtree_height, right_subtree_height) + 1
+     *
+     * Heights are cached in every node and maintained on insert and erase, so this is O(1).
      */
     int height() const;
 
+    //
+    //! ITERATORS
+    //
+
+    /**
+     * @brief Get an iterator to the smallest value, or end() if the set is empty
+     *
+     * @return const_iterator Iterator to the first value in ascending order
+     */
+    const_iterator begin() const;
+
+    /**
+     * @brief Get the past-the-end iterator
+     *
+     * @return const_iterator Iterator one past the largest value, decrementing it yields the largest value
+     */
+    const_iterator end() const
+    {
+        return const_iterator(nullptr, this);
+    }
+
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /**
+     * @brief Get a reverse iterator to the largest value
+     *
+     * @return const_reverse_iterator Iterator to the first value in descending order
+     */
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    /**
+     * @brief Get the past-the-end reverse iterator
+     *
+     * @return const_reverse_iterator Iterator one past the smallest value in descending order
+     */
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crbegin() const
+    {
+        return rbegin();
+    }
+
+    const_reverse_iterator crend() const
+    {
+        return rend();
+    }
+
+    /**
+     * @brief Find the first value that is not less than the given value
+     *
+     * @param value The value to compare against
+     * @return const_iterator Iterator to the first value >= value, or end() if there is none
+     */
+    const_iterator lower_bound(const T &value) const;
+
+    /**
+     * @brief Find the first value that is greater than the given value
+     *
+     * @param value The value to compare against
+     * @return const_iterator Iterator to the first value > value, or end() if there is none
+     */
+    const_iterator upper_bound(const T &value) const;
+
+    /**
+     * @brief Get the range of values equal to the given value
+     *
+     * @param value The value to compare against
+     * @return std::pair<const_iterator, const_iterator> lower_bound(value) and upper_bound(value), the range holds
+     * at most one value since the set holds unique values
+     */
+    std::pair<const_iterator, const_iterator> equal_range(const T &value) const;
+
+    //
+    //! ORDER STATISTICS
+    //
+
+    /**
+     * @brief Count the values that are less than the given value
+     *
+     * @param value The value to rank, it does not have to be in the set
+     * @return size_t The number of smaller values, which is the 0-based position of value if it is in the set
+     *
+     * Every node caches the size of its subtree, so this is a single O(h) descent.
+     */
+    size_t rank(const T &value) const;
+
+    /**
+     * @brief Get the k-th smallest value
+     *
+     * @param k The 0-based position in ascending order
+     * @return const_iterator Iterator to the value with rank k, or end() if k >= size()
+     */
+    const_iterator select(size_t k) const;
+
+    /**
+     * @brief Count the values in the half-open range [first, last)
+     *
+     * @param first The inclusive lower bound
+     * @param last The exclusive upper bound
+     * @return size_t The number of values v with first <= v < last, 0 if last <= first. O(h)
+     */
+    size_t countRange(const T &first, const T &last) const;
+
+    /**
+     * @brief Call a callback on every value in the half-open range [first, last) in ascending order
+     *
+     * @param first The inclusive lower bound
+     * @param last The exclusive upper bound
+     * @param callback Called with each value, see the templated traverseInorder for early termination
+     * @return bool True if every value in the range was visited, false if the callback stopped early
+     *
+     * Finds the first value in O(h) and then walks in order, so it costs O(h + k) for k visited values.
+     */
+    template <typename Callback> bool forEachInRange(const T &first, const T &last, Callback &&callback) const
+    {
+        for (const BinaryNode<T> *node = lower_bound(first).node; node && less(node->value(), last);
+             node = nextInorder(node))
+        {
+            if (!visit(callback, node))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
     //
     //! MODIFICATION OPERATIONS
     //
@@ -115,9 +815,31 @@ template <typename T> class BinaryTreeSet
      *
      * If the value already exists in the tree, it will not be inserted again.
      * The tree_size is incremented only when a new value is successfully inserted.
+     * With the AvlBalanced policy, the path back to the root is rebalanced with rotations afterwards.
+     * With a splaying policy, the new node (or the equal value already present) is splayed to the root.
      */
     void insert(const T &value);
 
+    /**
+     * @brief Insert the provided value into the tree, moving it into the new node
+     *
+     * @param value The value to insert, left in a moved-from state only if it was inserted
+     */
+    void insert(T &&value);
+
+    /**
+     * @brief Construct a value from the given arguments and insert it
+     *
+     * @param args Arguments forwarded to the constructor of T
+     *
+     * The value is built once and moved into its node, so emplace("abc") on a std::string set allocates the
+     * string a single time. Like insert, nothing is inserted if an equal value is already present.
+     */
+    template <typename... Args> void emplace(Args &&...args)
+    {
+        insert(T(std::forward<Args>(args)...));
+    }
+
     /**
      * @brief Inserts a copy of each element in the range if and only if there is no element with that value already
      * present.
@@ -133,6 +855,19 @@ template <typename T> class BinaryTreeSet
      */
     void insertRange(const std::vector<T> &range);
 
+    /**
+     * @brief Parallel insertRange, for large and unsorted ranges
+     *
+     * @param range The values to insert, duplicates and values already in the set are skipped
+     * @param pool The thread pool running the work
+     * @param grainSize The number of values below which work is not split any further
+     *
+     * The range is built into a set with the parallel fromSorted, whose nodes become this tree if it was empty and
+     * are otherwise merged in with the parallel unionWith, relinked rather than copied. Either way the result is
+     * rebuilt balanced, and the metrics recorded so far are kept.
+     */
+    void insertRange(const std::vector<T> &range, WorkStealingPool &pool, size_t grainSize = default_parallel_grain);
+
     /**
      * @brief Merges another binary tree set into this one
      *
@@ -143,36 +878,209 @@ template <typename T> class BinaryTreeSet
      * The input set remains unchanged after the merge operation.
      *
      * The tree_size will increase by the number of new unique values that were merged in.
+     * This costs O(m log(n + m)) and keeps the current shape, unionWith rebuilds in O(n + m) instead. Values are
+     * inserted one by one with this set's comparator, so unlike unionWith, set may be ordered by a different one.
      */
-    void merge(const BinaryTreeSet<T> &set);
+    void merge(const BinaryTreeSet &set);
+
+    //
+    //! SET ALGEBRA
+    //
+    // Each operation walks both sets in order like a merge of two sorted lists, then links the resulting nodes into
+    // a height-minimal tree, so it runs in O(n + m) for either balancing policy. Nodes of this set that are kept are
+    // relinked in place, never copied.
+    //
+    // Walking both sets in order only matches equal values if they are ordered the same way, so other must use a
+    // comparator equal to this set's. With stateful comparators (ModuloLess{10} against ModuloLess{7}) that is up to
+    // the caller: the result would silently not be a search tree. When Compare has an operator==, debug builds
+    // assert it.
+    //
 
     /**
-     * @brief Searches the tree for a node with the given value.
-     *
-     * @param value The value to search for in the tree
-     * @return true if the value is found in the tree
-     * @return false if the value is not found in the tree
+     * @brief Adds every value of another set to this one (this = this | other)
      *
+     * @param other The set to take values from, it remains unchanged. Must use a comparator equal to this set's
      */
-    bool contains(const T &value) const;
+    void unionWith(const BinaryTreeSet &other);
 
     /**
-     * @brief Searches for and returns a node containing the specified value
+     * @brief Adds every value of another set to this one, taking over its nodes instead of copying them
      *
-     * @param value The value to search for in the tree
-     * @return BinaryNode<T>* Pointer to the node containing the value if found, nullptr otherwise
+     * @param other The set to take values from, it is left empty. Must use a comparator equal to this set's
      *
-     * This method traverses the binary search tree to find a node containing the given value.
-     * If a matching node is found, a pointer to that node is returned.
-     * If no node contains the value, nullptr is returned.
+     * The allocator of other is absorbed into this one (see NodeArena::adopt), so its nodes join this tree at their
+     * current addresses without being reallocated. Nodes holding a value this set already has are destroyed.
      */
-    BinaryNode<T> *find(const T &value) const;
+    void unionWith(BinaryTreeSet &&other);
 
     /**
-     * @brief Removes a node with the specified value from the binary search tree
+     * @brief Keeps only the values that are also in another set (this = this & other)
      *
-     * @param value The value to remove from the tree
-     * @return true if a node containing the value was found and removed
+     * @param other The set to intersect with, it remains unchanged. Must use a comparator equal to this set's
+     */
+    void intersectWith(const BinaryTreeSet &other);
+
+    /**
+     * @brief Removes every value that is in another set (this = this - other)
+     *
+     * @param other The set whose values are removed, it remains unchanged. Must use a comparator equal to
+     * this set's
+     */
+    void differenceWith(const BinaryTreeSet &other);
+
+    /**
+     * @brief Keeps the values that are in exactly one of the two sets (this = this ^ other)
+     *
+     * @param other The set to compare against, it remains unchanged. Must use a comparator equal to this set's
+     */
+    void symmetricDifference(const BinaryTreeSet &other);
+
+    /**
+     * @brief symmetricDifference that takes over the nodes of other instead of copying them
+     *
+     * @param other The set to compare against, it is left empty. Must use a comparator equal to this set's
+     */
+    void symmetricDifference(BinaryTreeSet &&other);
+
+    //
+    //! PARALLEL SET ALGEBRA
+    //
+    // Divide and conquer versions of the operations above. Both sets are flattened by parallel subtree walks, then
+    // split recursively: the middle value of the larger side is the pivot and a binary search splits the smaller side
+    // at it, until a piece holds at most grainSize values. Pieces are merged by the pool in parallel, each with its
+    // own allocator that is adopted afterwards, and the result is linked into a height-minimal tree by parallel halves.
+    // That is O(n + m) work with O(log(n + m)) levels of forking. If copying a value throws, this set is left
+    // unchanged (but rebuilt balanced) and the exception is rethrown. As above, other must be ordered by a comparator
+    // equal to this set's.
+    //
+
+    /**
+     * @brief Parallel merge of another set into this one, the result of unionWith(set, pool, grainSize)
+     *
+     * @param set The set to merge into this one, it remains unchanged. Must use a comparator equal to this set's
+     * @param pool The thread pool running the work
+     * @param grainSize The number of values below which work is not split any further
+     */
+    void merge(const BinaryTreeSet &set, WorkStealingPool &pool, size_t grainSize = default_parallel_grain);
+
+    /**
+     * @brief Parallel unionWith (this = this | other)
+     *
+     * @param other The set to take values from, it remains unchanged. Must use a comparator equal to this set's
+     * @param pool The thread pool running the work
+     * @param grainSize The number of values below which work is not split any further
+     */
+    void unionWith(const BinaryTreeSet &other, WorkStealingPool &pool, size_t grainSize = default_parallel_grain);
+
+    /**
+     * @brief Parallel intersectWith (this = this & other)
+     *
+     * @param other The set to intersect with, it remains unchanged. Must use a comparator equal to this set's
+     * @param pool The thread pool running the work
+     * @param grainSize The number of values below which work is not split any further
+     */
+    void intersectWith(const BinaryTreeSet &other, WorkStealingPool &pool, size_t grainSize = default_parallel_grain);
+
+    /**
+     * @brief Parallel differenceWith (this = this - other)
+     *
+     * @param other The set whose values are removed, it remains unchanged. Must use a comparator equal to
+     * this set's
+     * @param pool The thread pool running the work
+     * @param grainSize The number of values below which work is not split any further
+     */
+    void differenceWith(const BinaryTreeSet &other, WorkStealingPool &pool, size_t grainSize = default_parallel_grain);
+
+    /**
+     * @brief Parallel symmetricDifference (this = this ^ other)
+     *
+     * @param other The set to compare against, it remains unchanged. Must use a comparator equal to this set's
+     * @param pool The thread pool running the work
+     * @param grainSize The number of values below which work is not split any further
+     */
+    void symmetricDifference(const BinaryTreeSet &other, WorkStealingPool &pool,
+                             size_t grainSize = default_parallel_grain);
+
+    /**
+     * @brief Searches the tree for a node with the given value.
+     *
+     * @param value The value to search for in the tree
+     * @return true if the value is found in the tree
+     * @return false if the value is not found in the tree
+     *
+     * With a splaying policy the value found, or the last node visited, is splayed to the root.
+     */
+    bool contains(const T &value) const;
+
+    /**
+     * @brief Searches the tree for a value equal to a key of another type
+     *
+     * @param key A key that compares with T without converting, e.g. std::string_view for a std::string set
+     * @return true if a value equal to the key is in the tree
+     *
+     * No temporary T is built: contains(std::string_view) compares the view against the stored strings directly.
+     */
+    template <typename Key, EnableIfLookupKey<Key> = 0> bool contains(const Key &key) const
+    {
+        MetricsScope<Metrics> scope(this->metricsState(), TreeOperation::Contains);
+        return lookupNode(key) != nullptr;
+    }
+
+    /**
+     * @brief Searches for and returns a node containing the specified value
+     *
+     * @param value The value to search for in the tree
+     * @return BinaryNode<T>* Pointer to the node containing the value if found, nullptr otherwise
+     *
+     * This method traverses the binary search tree to find a node containing the given value.
+     * If a matching node is found, a pointer to that node is returned.
+     * If no node contains the value, nullptr is returned.
+     * With a splaying policy the node found, or the last node visited, is splayed to the root.
+     */
+    BinaryNode<T> *find(const T &value) const;
+
+    /**
+     * @brief Searches for the node holding a value equal to a key of another type
+     *
+     * @param key A key that compares with T without converting, see the heterogeneous contains
+     * @return BinaryNode<T>* Pointer to the matching node, nullptr if there is none
+     */
+    template <typename Key, EnableIfLookupKey<Key> = 0> BinaryNode<T> *find(const Key &key) const
+    {
+        MetricsScope<Metrics> scope(this->metricsState(), TreeOperation::Find);
+        return lookupNode(key);
+    }
+
+    /**
+     * @brief Check many values at once, with their tree walks interleaved
+     *
+     * @param keys The values to look for
+     * @param count The number of values in keys
+     * @param out Receives contains(keys[i]) in out[i], for each of the count values
+     *
+     * A single lookup waits on one cache miss per level, as each node's address comes from its parent. Here up to
+     * 16 lookups advance one level in turn, and each prefetches the next node it needs, so their misses overlap
+     * instead of queuing. A lookup that reaches the bottom hands its lane to the next key. Worth it once the tree is
+     * larger than the cache; for small trees the plain loop is just as fast. Batched lookups never splay.
+     */
+    void containsBatch(const T *keys, size_t count, bool *out) const;
+
+    /**
+     * @brief Find the nodes of many values at once, with their tree walks interleaved
+     *
+     * @param keys The values to look for
+     * @param count The number of values in keys
+     * @param out Receives find(keys[i]) in out[i], for each of the count values
+     *
+     * See containsBatch().
+     */
+    void findBatch(const T *keys, size_t count, BinaryNode<T> **out) const;
+
+    /**
+     * @brief Removes a node with the specified value from the binary search tree
+     *
+     * @param value The value to remove from the tree
+     * @return true if a node containing the value was found and removed
      * @return false if the value was not found in the tree
      *
      * This method searches for and removes a node containing the given value from the tree,
@@ -184,6 +1092,8 @@ template <typename T> class BinaryTreeSet
      * (the smallest value in its right subtree).
      *
      * The tree_size is decremented when a value is successfully removed.
+     * With the AvlBalanced policy, the path back to the root is rebalanced with rotations afterwards.
+     * With a splaying policy, the parent of the node that went missing is splayed to the root.
      */
     bool erase(const T &value);
 
@@ -193,6 +1103,10 @@ template <typename T> class BinaryTreeSet
      * This method deletes all nodes in the tree and sets the root to nullptr.
      * After calling clear(), the tree will be empty and tree_size will be 0.
      * All memory used by the tree nodes will be properly deallocated.
+     *
+     * With the NodeArena allocator and a trivially destructible T (int, double), every slab is returned at once
+     * without visiting the nodes. Otherwise nodes are destroyed by rotating left children up into a right spine
+     * and deleting along it, so clearing never recurses and is safe for trees of any height.
      */
     void clear();
 
@@ -200,26 +1114,43 @@ template <typename T> class BinaryTreeSet
     //! TRAVERSAL OPERATIONS
     //
 
-    /**
-     * Runs the callback in ascending order on every node in the tree:
-     * ==> Left recursively first
-     * ==> Node (self) second
-     * ==> Right recursively last
-     */
     /**
      * @brief Performs an inorder traversal of the binary tree, executing a callback on each node
      *
      * @param callback A function to execute on each node's value during traversal
      *
      * Visits the nodes in the following order:
-     * 1. Recursively traverse the left subtree
+     * 1. Traverse the left subtree
      * 2. Visit the current node (execute callback)
-     * 3. Recursively traverse the right subtree
+     * 3. Traverse the right subtree
      *
      * This traversal visits nodes in ascending order for a binary search tree.
+     * The walk follows parent pointers instead of recursing, so it uses O(1) extra space at any tree height.
      */
     void traverseInorder(std::function<void(const T &)> callback) const;
 
+    /**
+     * @brief Performs an inorder traversal with any callable, stopping early if it returns false
+     *
+     * @param callback Called with each value in ascending order. If it returns something convertible to bool, the
+     * traversal stops after the first call that returns false
+     * @return bool True if every value was visited, false if the callback stopped the traversal
+     *
+     * Unlike the std::function overload the callback is neither copied nor called indirectly, so the compiler can
+     * inline it into the walk. Lambdas and other function objects pick this overload automatically.
+     */
+    template <typename Callback> bool traverseInorder(Callback &&callback) const
+    {
+        for (const BinaryNode<T> *node = leftmost(root); node; node = nextInorder(node))
+        {
+            if (!visit(callback, node))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
     /**
      * @brief Performs a preorder traversal of the binary tree, executing a callback on each node
      *
@@ -227,27 +1158,1638 @@ template <typename T> class BinaryTreeSet
      *
      * Visits the nodes in the following order:
      * 1. Visit the current node (execute callback)
-     * 2. Recursively traverse the left subtree
-     * 3. Recursively traverse the right subtree
+     * 2. Traverse the left subtree
+     * 3. Traverse the right subtree
      *
      * This traversal visits the root before its children, making it useful for copying/cloning trees
-     * or generating prefix expressions.
+     * or generating prefix expressions. Like traverseInorder it uses O(1) extra space.
      */
     void traversePreorder(std::function<void(const T &)> callback) const;
 
+    /**
+     * @brief Performs a preorder traversal with any callable, stopping early if it returns false
+     *
+     * @param callback Called with each value in preorder, see the templated traverseInorder
+     * @return bool True if every value was visited, false if the callback stopped the traversal
+     */
+    template <typename Callback> bool traversePreorder(Callback &&callback) const
+    {
+        for (const BinaryNode<T> *node = root; node; node = nextPreorder(node))
+        {
+            if (!visit(callback, node))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
     /**
      * @brief Performs a postorder traversal of the binary tree, executing a callback on each node
      *
      * @param callback A function to execute on each node's value during traversal
      *
      * Visits the nodes in the following order:
-     * 1. Recursively traverse the left subtree
-     * 2. Recursively traverse the right subtree
+     * 1. Traverse the left subtree
+     * 2. Traverse the right subtree
      * 3. Visit the current node (execute callback)
      *
      * This traversal visits all children before their parent nodes, making it useful for operations
      * that require processing child nodes first, such as deletion or calculating expression trees.
+     * Like traverseInorder it uses O(1) extra space.
      */
     void traversePostorder(std::function<void(const T &)> callback) const;
+
+    /**
+     * @brief Performs a postorder traversal with any callable, stopping early if it returns false
+     *
+     * @param callback Called with each value in postorder, see the templated traverseInorder
+     * @return bool True if every value was visited, false if the callback stopped the traversal
+     */
+    template <typename Callback> bool traversePostorder(Callback &&callback) const
+    {
+        for (const BinaryNode<T> *node = firstPostorder(root); node; node = nextPostorder(node))
+        {
+            if (!visit(callback, node))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
 };
+
+/**
+ * @brief A BinaryTreeSet that stays AVL balanced, with O(log n) worst case insert, find and erase
+ */
+template <typename T, typename Compare = std::less<>>
+using AvlTreeSet = BinaryTreeSet<T, AvlBalanced, NodeArena<BinaryNode<T>>, Compare>;
+
+/**
+ * @brief A BinaryTreeSet that splays every value it inserts, erases or looks up to the root
+ */
+template <typename T, typename Compare = std::less<>>
+using SplayTreeSet = BinaryTreeSet<T, Splaying, NodeArena<BinaryNode<T>>, Compare>;
+
+/**
+ * @brief A splay tree whose lookups only splay once in Period on average, for read-mostly workloads
+ */
+template <typename T, unsigned Period = 8, typename Compare = std::less<>>
+using SampledSplayTreeSet = BinaryTreeSet<T, SampledSplaying<Period>, NodeArena<BinaryNode<T>>, Compare>;
+
+//? Implementation
+//? Implementation
+//? Implementation
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+int BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::nodeHeight(const BinaryNode<T> *node)
+{
+    return node ? node->height() : -1;
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+size_t BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::nodeSize(const BinaryNode<T> *node)
+{
+    return node ? node->size() : 0;
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::updateNode(BinaryNode<T> *node)
+{
+    node->setHeight(1 + std::max(nodeHeight(node->left()), nodeHeight(node->right())));
+    node->setSize(1 + nodeSize(node->left()) + nodeSize(node->right()));
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::replaceChild(BinaryNode<T> *parent, BinaryNode<T> *child,
+                                                                          BinaryNode<T> *replacement)
+{
+    if (!parent)
+    {
+        root = replacement;
+    }
+    else if (parent->left() == child)
+    {
+        parent->setLeftPtr(replacement);
+    }
+    else
+    {
+        parent->setRightPtr(replacement);
+    }
+
+    if (replacement)
+    {
+        replacement->setParentPtr(parent);
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+BinaryNode<T> *BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::rotateLeft(BinaryNode<T> *node)
+{
+    this->metricsState().rotation();
+    BinaryNode<T> *pivot = node->right();
+    node->setRightPtr(pivot->left());
+    if (pivot->left())
+    {
+        pivot->left()->setParentPtr(node);
+    }
+
+    replaceChild(node->parent(), node, pivot);
+    pivot->setLeftPtr(node);
+    node->setParentPtr(pivot);
+
+    updateNode(node);
+    updateNode(pivot);
+    return pivot;
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+BinaryNode<T> *BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::rotateRight(BinaryNode<T> *node)
+{
+    this->metricsState().rotation();
+    BinaryNode<T> *pivot = node->left();
+    node->setLeftPtr(pivot->right());
+    if (pivot->right())
+    {
+        pivot->right()->setParentPtr(node);
+    }
+
+    replaceChild(node->parent(), node, pivot);
+    pivot->setRightPtr(node);
+    node->setParentPtr(pivot);
+
+    updateNode(node);
+    updateNode(pivot);
+    return pivot;
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+BinaryNode<T> *BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::rebalance(BinaryNode<T> *node)
+{
+    updateNode(node);
+
+    if constexpr (Balance::rebalances)
+    {
+        const int balance = nodeHeight(node->left()) - nodeHeight(node->right());
+
+        //? Left heavy: a left-right case is first turned into a left-left case
+        if (balance > 1)
+        {
+            if (nodeHeight(node->left()->left()) < nodeHeight(node->left()->right()))
+            {
+                rotateLeft(node->left());
+            }
+            return rotateRight(node);
+        }
+
+        //? Right heavy: a right-left case is first turned into a right-right case
+        if (balance < -1)
+        {
+            if (nodeHeight(node->right()->right()) < nodeHeight(node->right()->left()))
+            {
+                rotateRight(node->right());
+            }
+            return rotateLeft(node);
+        }
+    }
+    return node;
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::retraceFrom(BinaryNode<T> *node)
+{
+    //? Walk up the modified path fixing heights (and balance) until a subtree keeps its old height, because no
+    //? height or balance above it can have changed. Every subtree size up to the root has, so the rest of the way
+    //? only sizes are recomputed
+    while (node)
+    {
+        const int previousHeight = node->height();
+        BinaryNode<T> *subtree = rebalance(node);
+        node = subtree->parent();
+        if (subtree->height() == previousHeight)
+        {
+            break;
+        }
+    }
+    for (; node; node = node->parent())
+    {
+        node->setSize(1 + nodeSize(node->left()) + nodeSize(node->right()));
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::rotateUp(BinaryNode<T> *node)
+{
+    BinaryNode<T> *parent = node->parent();
+    if (parent->left() == node)
+    {
+        rotateRight(parent);
+    }
+    else
+    {
+        rotateLeft(parent);
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::splay(BinaryNode<T> *node)
+{
+    //? The rotations read the cached heights and sizes of the subtrees hanging off the path, whose roots the search
+    //? never touched. They stay in place during the splay, so their loads can all be started now instead of one miss
+    //? per rotation
+    for (const BinaryNode<T> *current = node; current; current = current->parent())
+    {
+        prefetchRead(current->left());
+        prefetchRead(current->right());
+    }
+
+    //? Bottom-up splaying, two levels per step. Every ancestor of node takes part in a rotation, and the rotations
+    //? recompute the heights and sizes of the nodes they move, so the cached values are right once node is the root
+    while (BinaryNode<T> *parent = node->parent())
+    {
+        BinaryNode<T> *grandparent = parent->parent();
+        if (!grandparent)
+        {
+            rotateUp(node); //? Zig
+        }
+        else if ((grandparent->left() == parent) == (parent->left() == node))
+        {
+            rotateUp(parent); //? Zig-zig: the parent goes first, which is what halves the depth along the path
+            rotateUp(node);
+        }
+        else
+        {
+            rotateUp(node); //? Zig-zag
+            rotateUp(node);
+        }
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::splayAccessed(BinaryNode<T> *node)
+{
+    if constexpr (Balance::splays)
+    {
+        if (node)
+        {
+            splay(node);
+        }
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::BinaryTreeSet(BinaryTreeSet &&other) noexcept
+    : CompareHolder<Compare>(other.comparator()), MetricsHolder<Metrics>(std::move(other)),
+      root(std::exchange(other.root, nullptr)), tree_size(std::exchange(other.tree_size, 0)),
+      allocator(std::move(other.allocator))
+{
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+BinaryTreeSet<T, Balance, Allocator, Compare, Metrics> &
+BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::operator=(BinaryTreeSet &&other) noexcept
+{
+    if (this != &other)
+    {
+        clear();
+        //? The nodes are ordered by other's comparator, so it comes along, even without copy assignment (see
+        //? CompareHolder)
+        CompareHolder<Compare>::operator=(other);
+        MetricsHolder<Metrics>::operator=(std::move(other));
+        root = std::exchange(other.root, nullptr);
+        tree_size = std::exchange(other.tree_size, 0);
+        allocator = std::move(other.allocator);
+    }
+    return *this;
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::buildBalanced(std::vector<T> &&values)
+{
+    const Compare &compare = this->comparator();
+    if (!std::is_sorted(values.begin(), values.end(), compare))
+    {
+        std::sort(values.begin(), values.end(), compare);
+    }
+    //? Equal neighbours are the ones where the first is not less than the second
+    values.erase(std::unique(values.begin(), values.end(),
+                             [&compare](const T &left, const T &right) { return !compare(left, right); }),
+                 values.end());
+
+    std::vector<BinaryNode<T> *> nodes;
+    nodes.reserve(values.size());
+    allocator.reserve(values.size());
+    try
+    {
+        for (T &value : values)
+        {
+            nodes.push_back(allocator.create(std::move(value)));
+        }
+    }
+    catch (...)
+    {
+        for (BinaryNode<T> *node : nodes)
+        {
+            allocator.destroy(node);
+        }
+        throw;
+    }
+    linkBalanced(nodes);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::detachInorder(std::vector<BinaryNode<T> *> &nodes)
+{
+    //? Same walk as clear(): rotate left children up until the current node has none, then it is the next
+    //? smallest node. The tree is torn apart on the way, every node is relinked by linkBalanced afterwards
+    BinaryNode<T> *node = root;
+    while (node)
+    {
+        BinaryNode<T> *left = node->left();
+        if (left)
+        {
+            node->setLeftPtr(left->right());
+            left->setRightPtr(node);
+            node = left;
+        }
+        else
+        {
+            nodes.push_back(node);
+            node = node->right();
+        }
+    }
+
+    root = nullptr;
+    tree_size = 0;
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::linkBalanced(std::vector<BinaryNode<T> *> &nodes)
+{
+    root = nullptr;
+    tree_size = nodes.size();
+    linkRange(nodes, 0, nodes.size(), nullptr, false);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::attachNode(BinaryNode<T> *node, size_t count,
+                                                                        BinaryNode<T> *parent, bool isLeft)
+{
+    //? Halves differ in size by at most one, so a subtree of count nodes is exactly floor(log2 count) high
+    int height = 0;
+    for (size_t remaining = count; remaining > 1; remaining /= 2)
+    {
+        height++;
+    }
+    node->setHeight(height);
+    node->setSize(count);
+    node->setLeftPtr(nullptr);
+    node->setRightPtr(nullptr);
+
+    node->setParentPtr(parent);
+    if (!parent)
+    {
+        root = node;
+    }
+    else if (isLeft)
+    {
+        parent->setLeftPtr(node);
+    }
+    else
+    {
+        parent->setRightPtr(node);
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::linkRange(std::vector<BinaryNode<T> *> &nodes,
+                                                                       size_t first, size_t last, BinaryNode<T> *parent,
+                                                                       bool isLeft)
+{
+    //? Each pending range becomes the subtree hanging off parent, rooted at its middle node. Left halves are
+    //? popped first, and at most one right half per level waits on the stack.
+    struct Range
+    {
+        size_t first, last;
+        BinaryNode<T> *parent;
+        bool isLeft;
+    };
+    if (first >= last)
+    {
+        return;
+    }
+    std::vector<Range> pending = {{first, last, parent, isLeft}};
+
+    while (!pending.empty())
+    {
+        const Range range = pending.back();
+        pending.pop_back();
+
+        const size_t count = range.last - range.first;
+        const size_t middle = range.first + count / 2;
+        BinaryNode<T> *node = nodes[middle];
+        attachNode(node, count, range.parent, range.isLeft);
+
+        if (middle + 1 < range.last)
+        {
+            pending.push_back({middle + 1, range.last, node, false});
+        }
+        if (range.first < middle)
+        {
+            pending.push_back({range.first, middle, node, true});
+        }
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::relinkAfterFailure(std::vector<BinaryNode<T> *> &kept,
+                                                                                std::vector<BinaryNode<T> *> &ours,
+                                                                                size_t next)
+{
+    //? Every kept node is smaller than ours[next], so the two still form one sorted sequence
+    kept.insert(kept.end(), ours.begin() + static_cast<std::ptrdiff_t>(next), ours.end());
+    linkBalanced(kept);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+int BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::height() const
+{
+    return nodeHeight(root);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+BinaryNode<T> *BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::insertionParent(const T &value,
+                                                                                       bool &duplicate) const
+{
+    //? The splaying policies stop at an equal node, and return it as the parent so insert splays it
+    if constexpr (Balance::splays)
+    {
+        BinaryNode<T> *last;
+        BinaryNode<T> *equal = searchNode(value, last);
+        duplicate = equal != nullptr;
+        return duplicate ? equal : last;
+    }
+
+    //? One comparison per level: remember the last node that is not greater than value, the only one that can be
+    //? equal to it, and test it once at the bottom (no duplicates are inserted)
+    BinaryNode<T> *parent = nullptr;
+    BinaryNode<T> *candidate = nullptr;
+    BinaryNode<T> *node = root;
+    while (node)
+    {
+        parent = node;
+        this->metricsState().visit();
+        if (countedLess(value, node->value()))
+        {
+            node = node->left();
+        }
+        else
+        {
+            candidate = node;
+            node = node->right();
+        }
+    }
+    duplicate = candidate && !countedLess(candidate->value(), value);
+    return parent;
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::linkLeaf(BinaryNode<T> *node, BinaryNode<T> *parent)
+{
+    node->setParentPtr(parent);
+    if (!parent)
+    {
+        root = node;
+    }
+    else if (less(node->value(), parent->value()))
+    {
+        parent->setLeftPtr(node);
+    }
+    else
+    {
+        parent->setRightPtr(node);
+    }
+
+    tree_size++;
+    retraceFrom(parent);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::insert(const T &value)
+{
+    MetricsScope<Metrics> scope(this->metricsState(), TreeOperation::Insert);
+    bool duplicate;
+    BinaryNode<T> *parent = insertionParent(value, duplicate);
+    if (duplicate)
+    {
+        splayAccessed(parent);
+        return;
+    }
+    BinaryNode<T> *node = allocator.create(value);
+    this->metricsState().allocation();
+    linkLeaf(node, parent);
+    splayAccessed(node);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::insert(T &&value)
+{
+    MetricsScope<Metrics> scope(this->metricsState(), TreeOperation::Insert);
+    bool duplicate;
+    BinaryNode<T> *parent = insertionParent(value, duplicate);
+    if (duplicate)
+    {
+        splayAccessed(parent);
+        return;
+    }
+    BinaryNode<T> *node = allocator.create(std::move(value));
+    this->metricsState().allocation();
+    linkLeaf(node, parent);
+    splayAccessed(node);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::insertRange(const std::vector<T> &range)
+{
+    for (const auto &value : range)
+    {
+        insert(value);
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::insertRange(const std::vector<T> &range,
+                                                                         WorkStealingPool &pool, size_t grainSize)
+{
+    BinaryTreeSet other(this->comparator());
+    other.buildBalancedParallel(std::vector<T>(range), pool, grainSize);
+    if (empty())
+    {
+        allocator.adopt(std::move(other.allocator));
+        root = std::exchange(other.root, nullptr);
+        tree_size = std::exchange(other.tree_size, 0);
+    }
+    else if (!other.empty())
+    {
+        parallelSetOperation(other, SetOperation::Union, pool, grainSize, &other);
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::merge(const BinaryTreeSet &set)
+{
+    set.traverseInorder([this](const T &value) { this->insert(value); });
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::unionWith(const BinaryTreeSet &other)
+{
+    assertSameOrdering(other);
+    if (this == &other || other.empty())
+    {
+        return;
+    }
+
+    std::vector<BinaryNode<T> *> ours, result;
+    ours.reserve(tree_size);
+    result.reserve(tree_size + other.tree_size);
+    detachInorder(ours);
+
+    size_t next = 0;
+    const BinaryNode<T> *theirs = leftmost(other.root);
+    try
+    {
+        while (next < ours.size() || theirs)
+        {
+            if (!theirs || (next < ours.size() && less(ours[next]->value(), theirs->value())))
+            {
+                result.push_back(ours[next++]);
+            }
+            else if (next == ours.size() || less(theirs->value(), ours[next]->value()))
+            {
+                result.push_back(allocator.create(theirs->value()));
+                theirs = nextInorder(theirs);
+            }
+            else
+            {
+                result.push_back(ours[next++]);
+                theirs = nextInorder(theirs);
+            }
+        }
+    }
+    catch (...)
+    {
+        relinkAfterFailure(result, ours, next);
+        throw;
+    }
+    linkBalanced(result);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::unionWith(BinaryTreeSet &&other)
+{
+    assertSameOrdering(other);
+    if (this == &other || other.empty())
+    {
+        return;
+    }
+
+    std::vector<BinaryNode<T> *> ours, theirs, result;
+    ours.reserve(tree_size);
+    theirs.reserve(other.tree_size);
+    result.reserve(tree_size + other.tree_size);
+    allocator.adopt(std::move(other.allocator));
+    detachInorder(ours);
+    other.detachInorder(theirs);
+
+    size_t i = 0, j = 0;
+    while (i < ours.size() || j < theirs.size())
+    {
+        if (j == theirs.size() || (i < ours.size() && less(ours[i]->value(), theirs[j]->value())))
+        {
+            result.push_back(ours[i++]);
+        }
+        else if (i == ours.size() || less(theirs[j]->value(), ours[i]->value()))
+        {
+            result.push_back(theirs[j++]);
+        }
+        else
+        {
+            result.push_back(ours[i++]);
+            allocator.destroy(theirs[j++]);
+        }
+    }
+    linkBalanced(result);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::intersectWith(const BinaryTreeSet &other)
+{
+    assertSameOrdering(other);
+    if (this == &other)
+    {
+        return;
+    }
+
+    std::vector<BinaryNode<T> *> ours;
+    ours.reserve(tree_size);
+    detachInorder(ours);
+
+    //? Kept nodes are compacted to the front of ours, nothing here can throw
+    size_t kept = 0;
+    const BinaryNode<T> *theirs = leftmost(other.root);
+    for (BinaryNode<T> *node : ours)
+    {
+        while (theirs && less(theirs->value(), node->value()))
+        {
+            theirs = nextInorder(theirs);
+        }
+        if (theirs && !less(node->value(), theirs->value()))
+        {
+            ours[kept++] = node;
+        }
+        else
+        {
+            allocator.destroy(node);
+        }
+    }
+    ours.resize(kept);
+    linkBalanced(ours);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::differenceWith(const BinaryTreeSet &other)
+{
+    assertSameOrdering(other);
+    if (this == &other)
+    {
+        clear();
+        return;
+    }
+
+    std::vector<BinaryNode<T> *> ours;
+    ours.reserve(tree_size);
+    detachInorder(ours);
+
+    size_t kept = 0;
+    const BinaryNode<T> *theirs = leftmost(other.root);
+    for (BinaryNode<T> *node : ours)
+    {
+        while (theirs && less(theirs->value(), node->value()))
+        {
+            theirs = nextInorder(theirs);
+        }
+        if (theirs && !less(node->value(), theirs->value()))
+        {
+            allocator.destroy(node);
+        }
+        else
+        {
+            ours[kept++] = node;
+        }
+    }
+    ours.resize(kept);
+    linkBalanced(ours);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::symmetricDifference(const BinaryTreeSet &other)
+{
+    assertSameOrdering(other);
+    if (this == &other)
+    {
+        clear();
+        return;
+    }
+
+    std::vector<BinaryNode<T> *> ours, result;
+    ours.reserve(tree_size);
+    result.reserve(tree_size + other.tree_size);
+    detachInorder(ours);
+
+    size_t next = 0;
+    const BinaryNode<T> *theirs = leftmost(other.root);
+    try
+    {
+        while (next < ours.size() || theirs)
+        {
+            if (!theirs || (next < ours.size() && less(ours[next]->value(), theirs->value())))
+            {
+                result.push_back(ours[next++]);
+            }
+            else if (next == ours.size() || less(theirs->value(), ours[next]->value()))
+            {
+                result.push_back(allocator.create(theirs->value()));
+                theirs = nextInorder(theirs);
+            }
+            else
+            {
+                allocator.destroy(ours[next++]);
+                theirs = nextInorder(theirs);
+            }
+        }
+    }
+    catch (...)
+    {
+        relinkAfterFailure(result, ours, next);
+        throw;
+    }
+    linkBalanced(result);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::symmetricDifference(BinaryTreeSet &&other)
+{
+    assertSameOrdering(other);
+    if (this == &other)
+    {
+        clear();
+        return;
+    }
+
+    std::vector<BinaryNode<T> *> ours, theirs, result;
+    ours.reserve(tree_size);
+    theirs.reserve(other.tree_size);
+    result.reserve(tree_size + other.tree_size);
+    allocator.adopt(std::move(other.allocator));
+    detachInorder(ours);
+    other.detachInorder(theirs);
+
+    size_t i = 0, j = 0;
+    while (i < ours.size() || j < theirs.size())
+    {
+        if (j == theirs.size() || (i < ours.size() && less(ours[i]->value(), theirs[j]->value())))
+        {
+            result.push_back(ours[i++]);
+        }
+        else if (i == ours.size() || less(theirs[j]->value(), ours[i]->value()))
+        {
+            result.push_back(theirs[j++]);
+        }
+        else
+        {
+            allocator.destroy(ours[i++]);
+            allocator.destroy(theirs[j++]);
+        }
+    }
+    linkBalanced(result);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+template <typename Node>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::collectSubtree(Node *node, std::vector<Node *> &out)
+{
+    std::vector<Node *> stack;
+    while (node || !stack.empty())
+    {
+        while (node)
+        {
+            stack.push_back(node);
+            node = node->left();
+        }
+        node = stack.back();
+        stack.pop_back();
+        out.push_back(node);
+        node = node->right();
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+template <typename Node>
+std::vector<Node *> BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::flattenParallel(Node *root, size_t size,
+                                                                                            WorkStealingPool &pool)
+{
+    //? Nodes above the cut depth are listed one by one, the subtrees hanging below it are collected by separate
+    //? tasks. Cutting 2 levels below one subtree per thread leaves room for stealing when subtrees are uneven.
+    int cut = 2;
+    for (size_t threads = pool.workerCount() + 1; threads > 1; threads /= 2)
+    {
+        cut++;
+    }
+
+    struct Item
+    {
+        Node *node;
+        bool subtree;
+    };
+    std::vector<Item> items;
+    std::vector<std::pair<Node *, int>> stack;
+    Node *node = root;
+    int depth = 0;
+    while (true)
+    {
+        while (node && depth < cut)
+        {
+            stack.push_back({node, depth});
+            node = node->left();
+            depth++;
+        }
+        if (node)
+        {
+            items.push_back({node, true});
+        }
+        if (stack.empty())
+        {
+            break;
+        }
+        items.push_back({stack.back().first, false});
+        node = stack.back().first->right();
+        depth = stack.back().second + 1;
+        stack.pop_back();
+    }
+
+    std::vector<std::vector<Node *>> parts(items.size());
+    pool.parallelFor(0, items.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (items[i].subtree)
+            {
+                collectSubtree(items[i].node, parts[i]);
+            }
+            else
+            {
+                parts[i].push_back(items[i].node);
+            }
+        }
+    });
+
+    std::vector<Node *> nodes;
+    nodes.reserve(size);
+    for (const std::vector<Node *> &part : parts)
+    {
+        nodes.insert(nodes.end(), part.begin(), part.end());
+    }
+    return nodes;
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::linkRangeParallel(std::vector<BinaryNode<T> *> &nodes,
+                                                                               size_t first, size_t last,
+                                                                               BinaryNode<T> *parent, bool isLeft,
+                                                                               WorkStealingPool &pool, size_t grainSize)
+{
+    if (last - first <= grainSize)
+    {
+        linkRange(nodes, first, last, parent, isLeft);
+        return;
+    }
+
+    //? The two halves only write to their own nodes and to different child pointers of node
+    const size_t middle = first + (last - first) / 2;
+    BinaryNode<T> *node = nodes[middle];
+    attachNode(node, last - first, parent, isLeft);
+    pool.parallelInvoke([&]() { linkRangeParallel(nodes, first, middle, node, true, pool, grainSize); },
+                        [&]() { linkRangeParallel(nodes, middle + 1, last, node, false, pool, grainSize); });
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::parallelSetOperation(const BinaryTreeSet &other,
+                                                                                  SetOperation operation,
+                                                                                  WorkStealingPool &pool,
+                                                                                  size_t grainSize,
+                                                                                  BinaryTreeSet *donor)
+{
+    assertSameOrdering(other);
+    const bool keepOnlyOurs = operation != SetOperation::Intersection;
+    const bool keepShared = operation == SetOperation::Union || operation == SetOperation::Intersection;
+    const bool keepOnlyTheirs = operation == SetOperation::Union || operation == SetOperation::SymmetricDifference;
+    grainSize = std::max<size_t>(grainSize, 2);
+
+    std::vector<BinaryNode<T> *> ours = flattenParallel(root, tree_size, pool);
+    const std::vector<const BinaryNode<T> *> theirs =
+        flattenParallel(static_cast<const BinaryNode<T> *>(other.root), other.tree_size, pool);
+
+    //? Split on the middle value of the larger side until every piece is small enough. A value present in both
+    //? sets always lands in the same piece, because the smaller side is split at the pivot's lower bound.
+    struct Piece
+    {
+        size_t oursFirst, oursLast, theirsFirst, theirsLast;
+    };
+    std::vector<Piece> pieces;
+    std::vector<Piece> pending = {{0, ours.size(), 0, theirs.size()}};
+    while (!pending.empty())
+    {
+        const Piece piece = pending.back();
+        pending.pop_back();
+
+        const size_t oursCount = piece.oursLast - piece.oursFirst;
+        const size_t theirsCount = piece.theirsLast - piece.theirsFirst;
+        if (oursCount + theirsCount <= grainSize)
+        {
+            pieces.push_back(piece);
+            continue;
+        }
+
+        Piece left = piece, right = piece;
+        if (oursCount >= theirsCount)
+        {
+            const size_t middle = piece.oursFirst + oursCount / 2;
+            const T &pivot = ours[middle]->value();
+            const auto split = std::lower_bound(
+                theirs.begin() + static_cast<std::ptrdiff_t>(piece.theirsFirst),
+                theirs.begin() + static_cast<std::ptrdiff_t>(piece.theirsLast), pivot,
+                [this](const BinaryNode<T> *node, const T &value) { return less(node->value(), value); });
+            left.oursLast = right.oursFirst = middle;
+            left.theirsLast = right.theirsFirst = static_cast<size_t>(split - theirs.begin());
+        }
+        else
+        {
+            const size_t middle = piece.theirsFirst + theirsCount / 2;
+            const T &pivot = theirs[middle]->value();
+            const auto split = std::lower_bound(
+                ours.begin() + static_cast<std::ptrdiff_t>(piece.oursFirst),
+                ours.begin() + static_cast<std::ptrdiff_t>(piece.oursLast), pivot,
+                [this](const BinaryNode<T> *node, const T &value) { return less(node->value(), value); });
+            left.theirsLast = right.theirsFirst = middle;
+            left.oursLast = right.oursFirst = static_cast<size_t>(split - ours.begin());
+        }
+        pending.push_back(right);
+        pending.push_back(left);
+    }
+
+    //? Every piece copies values of other through its own allocator, so no two threads touch the same free list.
+    //? A donor's nodes are not copied but kept or dropped like ours, theirs only holds them as const for reading.
+    std::vector<Allocator> allocators(pieces.size());
+    std::vector<std::vector<BinaryNode<T> *>> results(pieces.size()), created(pieces.size()), dropped(pieces.size());
+    try
+    {
+        pool.parallelFor(0, pieces.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p)
+            {
+                const Piece &piece = pieces[p];
+                size_t i = piece.oursFirst, j = piece.theirsFirst;
+                while (i < piece.oursLast || j < piece.theirsLast)
+                {
+                    if (j == piece.theirsLast || (i < piece.oursLast && less(ours[i]->value(), theirs[j]->value())))
+                    {
+                        (keepOnlyOurs ? results[p] : dropped[p]).push_back(ours[i++]);
+                    }
+                    else if (i == piece.oursLast || less(theirs[j]->value(), ours[i]->value()))
+                    {
+                        if (donor)
+                        {
+                            BinaryNode<T> *node = const_cast<BinaryNode<T> *>(theirs[j]);
+                            (keepOnlyTheirs ? results[p] : dropped[p]).push_back(node);
+                        }
+                        else if (keepOnlyTheirs)
+                        {
+                            created[p].push_back(allocators[p].create(theirs[j]->value()));
+                            results[p].push_back(created[p].back());
+                        }
+                        j++;
+                    }
+                    else
+                    {
+                        (keepShared ? results[p] : dropped[p]).push_back(ours[i++]);
+                        if (donor)
+                        {
+                            dropped[p].push_back(const_cast<BinaryNode<T> *>(theirs[j]));
+                        }
+                        j++;
+                    }
+                }
+            }
+        });
+    }
+    catch (...)
+    {
+        //? Nothing of ours or a donor's has been destroyed yet: drop the copies and put our nodes back
+        for (size_t p = 0; p < pieces.size(); ++p)
+        {
+            for (BinaryNode<T> *node : created[p])
+            {
+                allocators[p].destroy(node);
+            }
+        }
+        linkBalanced(ours);
+        throw;
+    }
+
+    //? Dropped nodes live in this set's slabs or the donor's, so they go back through allocator once both the
+    //? pieces and the donor are adopted
+    for (Allocator &pieceAllocator : allocators)
+    {
+        allocator.adopt(std::move(pieceAllocator));
+    }
+    if (donor)
+    {
+        allocator.adopt(std::move(donor->allocator));
+        donor->root = nullptr;
+        donor->tree_size = 0;
+    }
+    for (const std::vector<BinaryNode<T> *> &nodes : dropped)
+    {
+        for (BinaryNode<T> *node : nodes)
+        {
+            allocator.destroy(node);
+        }
+    }
+
+    std::vector<size_t> offsets(pieces.size() + 1, 0);
+    for (size_t p = 0; p < pieces.size(); ++p)
+    {
+        offsets[p + 1] = offsets[p] + results[p].size();
+    }
+    std::vector<BinaryNode<T> *> result(offsets.back());
+    pool.parallelFor(0, pieces.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p)
+        {
+            std::copy(results[p].begin(), results[p].end(), result.begin() + static_cast<std::ptrdiff_t>(offsets[p]));
+        }
+    });
+
+    root = nullptr;
+    tree_size = result.size();
+    if (!result.empty())
+    {
+        linkRangeParallel(result, 0, result.size(), nullptr, false, pool, grainSize);
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::buildBalancedParallel(std::vector<T> &&values,
+                                                                                   WorkStealingPool &pool,
+                                                                                   size_t grainSize)
+{
+    grainSize = std::max<size_t>(grainSize, 2);
+    const size_t count = values.size();
+    if (count <= grainSize)
+    {
+        buildBalanced(std::move(values));
+        return;
+    }
+    const Compare &compare = this->comparator();
+
+    //? A few buckets per thread even out uneven bucket sizes, blocks are the same number of input slices
+    const size_t bucketCount = std::min((count + grainSize - 1) / grainSize, 8 * (pool.workerCount() + 1));
+    const size_t blockSize = (count + bucketCount - 1) / bucketCount;
+    const size_t blockCount = (count + blockSize - 1) / blockSize;
+
+    std::vector<char> blockSorted(blockCount);
+    pool.parallelFor(0, blockCount, 1, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+        {
+            //? Each block also checks the border to the next one
+            const auto first = values.begin() + static_cast<std::ptrdiff_t>(b * blockSize);
+            const auto last = values.begin() + static_cast<std::ptrdiff_t>(std::min(count, (b + 1) * blockSize + 1));
+            blockSorted[b] = std::is_sorted(first, last, compare);
+        }
+    });
+    const bool sorted = std::find(blockSorted.begin(), blockSorted.end(), 0) == blockSorted.end();
+
+    //? bounds[k] is where bucket k starts in buckets
+    std::vector<T> scattered;
+    std::vector<size_t> bounds(bucketCount + 1, count);
+    bounds[0] = 0;
+    if (sorted)
+    {
+        //? Cut at block borders, moved forward past values equal to the one before
+        for (size_t k = 1; k < bucketCount; ++k)
+        {
+            size_t bound = std::max(bounds[k - 1], std::min(count, k * blockSize));
+            while (bound > 0 && bound < count && !compare(values[bound - 1], values[bound]))
+            {
+                bound++;
+            }
+            bounds[k] = bound;
+        }
+    }
+    else
+    {
+        //? Splitters are every oversample-th value of a sorted sample spread evenly over the input
+        constexpr size_t oversample = 32;
+        std::vector<T> sample;
+        sample.reserve(bucketCount * oversample);
+        for (size_t i = 0; i < bucketCount * oversample; ++i)
+        {
+            sample.push_back(values[(i * count) / (bucketCount * oversample)]);
+        }
+        std::sort(sample.begin(), sample.end(), compare);
+        std::vector<T> splitters;
+        splitters.reserve(bucketCount - 1);
+        for (size_t k = 1; k < bucketCount; ++k)
+        {
+            splitters.push_back(sample[k * oversample]);
+        }
+        //? A value's bucket is the number of splitters not after it, equal values share a bucket
+        const auto bucketOf = [&splitters, &compare](const T &value) {
+            return static_cast<size_t>(std::upper_bound(splitters.begin(), splitters.end(), value, compare) -
+                                       splitters.begin());
+        };
+
+        //? counts[b * bucketCount + k] is the number of values of block b in bucket k, turned into the position
+        //? where block b writes its first value of bucket k
+        std::vector<size_t> counts(blockCount * bucketCount, 0);
+        pool.parallelFor(0, blockCount, 1, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b)
+            {
+                for (size_t i = b * blockSize; i < std::min(count, (b + 1) * blockSize); ++i)
+                {
+                    counts[b * bucketCount + bucketOf(values[i])]++;
+                }
+            }
+        });
+        size_t offset = 0;
+        for (size_t k = 0; k < bucketCount; ++k)
+        {
+            bounds[k] = offset;
+            for (size_t b = 0; b < blockCount; ++b)
+            {
+                const size_t blockValues = counts[b * bucketCount + k];
+                counts[b * bucketCount + k] = offset;
+                offset += blockValues;
+            }
+        }
+
+        scattered.resize(count);
+        pool.parallelFor(0, blockCount, 1, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b)
+            {
+                size_t *next = counts.data() + b * bucketCount;
+                for (size_t i = b * blockSize; i < std::min(count, (b + 1) * blockSize); ++i)
+                {
+                    scattered[next[bucketOf(values[i])]++] = std::move(values[i]);
+                }
+            }
+        });
+        values.swap(scattered);
+        scattered = std::vector<T>();
+    }
+
+    //? Sort and deduplicate each bucket in place, the distinct values of bucket k end at ends[k]
+    std::vector<size_t> ends(bucketCount);
+    pool.parallelFor(0, bucketCount, 1, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k)
+        {
+            const auto first = values.begin() + static_cast<std::ptrdiff_t>(bounds[k]);
+            const auto last = values.begin() + static_cast<std::ptrdiff_t>(bounds[k + 1]);
+            if (!sorted)
+            {
+                std::sort(first, last, compare);
+            }
+            const auto unique =
+                std::unique(first, last, [&compare](const T &left, const T &right) { return !compare(left, right); });
+            ends[k] = static_cast<size_t>(unique - values.begin());
+        }
+    });
+    std::vector<size_t> offsets(bucketCount + 1, 0);
+    for (size_t k = 0; k < bucketCount; ++k)
+    {
+        offsets[k + 1] = offsets[k] + (ends[k] - bounds[k]);
+    }
+
+    //? Every bucket creates its nodes through its own allocator, adopted afterwards as in parallelSetOperation
+    std::vector<Allocator> allocators(bucketCount);
+    std::vector<BinaryNode<T> *> nodes(offsets.back(), nullptr);
+    try
+    {
+        pool.parallelFor(0, bucketCount, 1, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k)
+            {
+                allocators[k].reserve(ends[k] - bounds[k]);
+                for (size_t i = bounds[k]; i < ends[k]; ++i)
+                {
+                    nodes[offsets[k] + i - bounds[k]] = allocators[k].create(std::move(values[i]));
+                }
+            }
+        });
+    }
+    catch (...)
+    {
+        for (size_t k = 0; k < bucketCount; ++k)
+        {
+            for (size_t i = offsets[k]; i < offsets[k + 1] && nodes[i]; ++i)
+            {
+                allocators[k].destroy(nodes[i]);
+            }
+        }
+        throw;
+    }
+    values = std::vector<T>();
+    for (Allocator &bucketAllocator : allocators)
+    {
+        allocator.adopt(std::move(bucketAllocator));
+    }
+
+    root = nullptr;
+    tree_size = nodes.size();
+    linkRangeParallel(nodes, 0, nodes.size(), nullptr, false, pool, grainSize);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::merge(const BinaryTreeSet &set, WorkStealingPool &pool,
+                                                                   size_t grainSize)
+{
+    unionWith(set, pool, grainSize);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::unionWith(const BinaryTreeSet &other,
+                                                                       WorkStealingPool &pool, size_t grainSize)
+{
+    if (this != &other && !other.empty())
+    {
+        parallelSetOperation(other, SetOperation::Union, pool, grainSize);
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::intersectWith(const BinaryTreeSet &other,
+                                                                           WorkStealingPool &pool, size_t grainSize)
+{
+    if (this != &other)
+    {
+        parallelSetOperation(other, SetOperation::Intersection, pool, grainSize);
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::differenceWith(const BinaryTreeSet &other,
+                                                                            WorkStealingPool &pool, size_t grainSize)
+{
+    if (this == &other)
+    {
+        clear();
+        return;
+    }
+    parallelSetOperation(other, SetOperation::Difference, pool, grainSize);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::symmetricDifference(const BinaryTreeSet &other,
+                                                                                 WorkStealingPool &pool,
+                                                                                 size_t grainSize)
+{
+    if (this == &other)
+    {
+        clear();
+        return;
+    }
+    parallelSetOperation(other, SetOperation::SymmetricDifference, pool, grainSize);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+typename BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::const_iterator
+BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::begin() const
+{
+    return const_iterator(leftmost(root), this);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+typename BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::const_iterator
+BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::lower_bound(const T &value) const
+{
+    return const_iterator(lowerBoundNode(value), this);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+typename BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::const_iterator
+BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::upper_bound(const T &value) const
+{
+    const BinaryNode<T> *node = root;
+    const BinaryNode<T> *bound = nullptr;
+    while (node)
+    {
+        if (less(value, node->value()))
+        {
+            bound = node;
+            node = node->left();
+        }
+        else
+        {
+            node = node->right();
+        }
+    }
+    return const_iterator(bound, this);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+std::pair<typename BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::const_iterator,
+          typename BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::const_iterator>
+BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::equal_range(const T &value) const
+{
+    const_iterator first = lower_bound(value);
+    const_iterator last = first;
+    if (last != end() && !less(value, *last))
+    {
+        ++last;
+    }
+    return {first, last};
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+size_t BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::rank(const T &value) const
+{
+    //? Every time the descent turns right, the node and its whole left subtree are smaller than value
+    size_t smaller = 0;
+    const BinaryNode<T> *node = root;
+    while (node)
+    {
+        if (less(node->value(), value))
+        {
+            smaller += nodeSize(node->left()) + 1;
+            node = node->right();
+        }
+        else
+        {
+            node = node->left();
+        }
+    }
+    return smaller;
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+typename BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::const_iterator
+BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::select(size_t k) const
+{
+    const BinaryNode<T> *node = root;
+    while (node)
+    {
+        const size_t leftSize = nodeSize(node->left());
+        if (k < leftSize)
+        {
+            node = node->left();
+        }
+        else if (k == leftSize)
+        {
+            break;
+        }
+        else
+        {
+            k -= leftSize + 1;
+            node = node->right();
+        }
+    }
+    return const_iterator(node, this);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+size_t BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::countRange(const T &first, const T &last) const
+{
+    if (!less(first, last))
+    {
+        return 0;
+    }
+    return rank(last) - rank(first);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+bool BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::contains(const T &value) const
+{
+    MetricsScope<Metrics> scope(this->metricsState(), TreeOperation::Contains);
+    return lookupNode(value) != nullptr;
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+BinaryNode<T> *BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::find(const T &value) const
+{
+    MetricsScope<Metrics> scope(this->metricsState(), TreeOperation::Find);
+    return lookupNode(value);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+template <typename Emit>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::lowerBoundBatch(const T *keys, size_t count,
+                                                                             Emit &&emit) const
+{
+    if (!root)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            emit(i, nullptr);
+        }
+        return;
+    }
+
+    //? Each lane is one lookup in progress: the key it searches for, the node it is at and its lower bound so far
+    size_t index[batch_lanes];
+    BinaryNode<T> *node[batch_lanes];
+    BinaryNode<T> *bound[batch_lanes];
+    size_t active = 0;
+    size_t next = 0;
+    for (; active < batch_lanes && next < count; ++active, ++next)
+    {
+        index[active] = next;
+        node[active] = root;
+        bound[active] = nullptr;
+    }
+
+    //? Round robin over the lanes, one level each. By the time a lane comes round again, the node it prefetched has
+    //? had the other lanes' steps to arrive
+    while (active > 0)
+    {
+        for (size_t lane = 0; lane < active;)
+        {
+            BinaryNode<T> *current = node[lane];
+            if (less(current->value(), keys[index[lane]]))
+            {
+                current = current->right();
+            }
+            else
+            {
+                bound[lane] = current;
+                current = current->left();
+            }
+
+            if (current)
+            {
+                prefetchRead(current);
+                node[lane++] = current;
+                continue;
+            }
+
+            emit(index[lane], bound[lane]);
+            if (next < count)
+            {
+                index[lane] = next++;
+                node[lane] = root;
+                bound[lane] = nullptr;
+                ++lane;
+            }
+            else
+            {
+                //? No keys left: the last lane takes this slot and still gets its step in this round
+                --active;
+                index[lane] = index[active];
+                node[lane] = node[active];
+                bound[lane] = bound[active];
+            }
+        }
+    }
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::containsBatch(const T *keys, size_t count, bool *out) const
+{
+    lowerBoundBatch(keys, count, [this, keys, out](size_t i, const BinaryNode<T> *bound) {
+        out[i] = bound && !less(keys[i], bound->value());
+    });
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::findBatch(const T *keys, size_t count,
+                                                                       BinaryNode<T> **out) const
+{
+    lowerBoundBatch(keys, count, [this, keys, out](size_t i, BinaryNode<T> *bound) {
+        out[i] = bound && !less(keys[i], bound->value()) ? bound : nullptr;
+    });
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+bool BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::erase(const T &value)
+{
+    MetricsScope<Metrics> scope(this->metricsState(), TreeOperation::Erase);
+    //? The splaying policies splay the deepest node the erase touched: the last node visited after a miss, or the
+    //? node where retracing starts
+    BinaryNode<T> *last = nullptr;
+    BinaryNode<T> *node = Balance::splays ? searchNode(value, last) : findNode(value);
+    if (!node)
+    {
+        splayAccessed(last);
+        return false;
+    }
+
+    //? Node with two children: the inorder successor (smallest node in the right subtree, which has no left child)
+    //? is relinked into its place, so no value is copied and iterators to the successor stay valid
+    if (node->left() && node->right())
+    {
+        BinaryNode<T> *successor = node->right();
+        this->metricsState().visit();
+        while (successor->left())
+        {
+            successor = successor->left();
+            this->metricsState().visit();
+        }
+
+        //? Retracing starts where a node went missing: the successor's old parent, or the successor itself if it
+        //? was the right child of node
+        BinaryNode<T> *retraceStart = successor;
+        if (successor->parent() != node)
+        {
+            retraceStart = successor->parent();
+            replaceChild(retraceStart, successor, successor->right());
+            successor->setRightPtr(node->right());
+            node->right()->setParentPtr(successor);
+        }
+        successor->setLeftPtr(node->left());
+        node->left()->setParentPtr(successor);
+        replaceChild(node->parent(), node, successor);
+        successor->setHeight(node->height());
+        successor->setSize(node->size());
+        allocator.destroy(node);
+        this->metricsState().deallocation();
+
+        tree_size--;
+        retraceFrom(retraceStart);
+        splayAccessed(retraceStart);
+        return true;
+    }
+
+    //? Node with only one child or no child: splice its child into its place
+    BinaryNode<T> *child = node->left() ? node->left() : node->right();
+    BinaryNode<T> *parent = node->parent();
+    replaceChild(parent, node, child);
+    allocator.destroy(node);
+    this->metricsState().deallocation();
+
+    tree_size--;
+    retraceFrom(parent);
+    splayAccessed(parent);
+    return true;
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::clear()
+{
+    if constexpr (!Allocator::bulk_release || !std::is_trivially_destructible_v<BinaryNode<T>>)
+    {
+        //? Rotate every left child up until the current node has none, then destroy it and continue down the
+        //? right spine
+        BinaryNode<T> *node = root;
+        while (node)
+        {
+            BinaryNode<T> *left = node->left();
+            if (left)
+            {
+                node->setLeftPtr(left->right());
+                left->setRightPtr(node);
+                node = left;
+            }
+            else
+            {
+                BinaryNode<T> *next = node->right();
+                allocator.destroy(node);
+                node = next;
+            }
+        }
+    }
+    allocator.release();
+
+    root = nullptr;
+    tree_size = 0;
+}
+
+//? The std::function overloads forward to the templated walks; the explicit template argument keeps overload
+//? resolution from picking the non-template function again
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::traverseInorder(
+    std::function<void(const T &)> callback) const
+{
+    traverseInorder<std::function<void(const T &)> &>(callback);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::traversePreorder(
+    std::function<void(const T &)> callback) const
+{
+    traversePreorder<std::function<void(const T &)> &>(callback);
+}
+
+template <typename T, typename Balance, typename Allocator, typename Compare, typename Metrics>
+void BinaryTreeSet<T, Balance, Allocator, Compare, Metrics>::traversePostorder(
+    std::function<void(const T &)> callback) const
+{
+    traversePostorder<std::function<void(const T &)> &>(callback);
+}
+
 } // namespace models
\ No newline at end of file
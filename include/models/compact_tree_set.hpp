@@ -0,0 +1,579 @@
+#pragma once
+
+#include "tree_policies.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace models
+{
+
+/**
+ * @brief An ordered set stored as an AVL tree whose nodes live in one vector and link by 32-bit indices
+ *
+ * @tparam T The type of values stored in the set, any type the comparator can order
+ * @tparam Compare A strict weak ordering on T, as for BinaryTreeSet. Defaults to std::less<>
+ *
+ * A node is the value and two 32-bit links, nothing else: for int that is 12 bytes, against 48 for a BinaryNode<int>
+ * with its parent pointer, cached height and subtree size. The low 31 bits of a link are the index of the child,
+ * and the top bit says that this side is the taller one, so the AVL balance factor costs no extra space. There are
+ * no parent links, insert and erase remember their path on a small stack instead, and no per-node allocations: the
+ * vector stays dense, an erased node's slot is filled by moving the last node into it.
+ *
+ * Lookups are the same one-comparison-per-level descent as BinaryTreeSet. The set holds up to 2^31 - 1 values.
+ * There are no node handles and no order statistics, which are what the extra fields of BinaryNode pay for.
+ */
+template <typename T, typename Compare = std::less<>> class CompactTreeSet : private CompareHolder<Compare>
+{
+  private:
+    static constexpr uint32_t taller_bit = uint32_t(1) << 31;
+    static constexpr uint32_t index_mask = taller_bit - 1;
+    static constexpr uint32_t nil = index_mask;
+
+    //? An AVL tree of 2^31 nodes is at most 45 levels high
+    static constexpr int max_height = 64;
+
+    struct Node
+    {
+        T value;
+        uint32_t left;  //? Child index, plus taller_bit when the left subtree is the taller one
+        uint32_t right; //? Child index, plus taller_bit when the right subtree is the taller one
+
+        explicit Node(const T &value) : value(value), left(nil), right(nil)
+        {
+        }
+        explicit Node(T &&value) : value(std::move(value)), left(nil), right(nil)
+        {
+        }
+    };
+
+    std::vector<Node> nodes;
+    uint32_t root;
+
+    template <typename A, typename B> bool less(const A &left, const B &right) const
+    {
+        return this->comparator()(left, right);
+    }
+
+    //
+    //! SECTION Packed links
+    //
+
+    uint32_t child(uint32_t node, bool right) const
+    {
+        return (right ? nodes[node].right : nodes[node].left) & index_mask;
+    }
+
+    //? Keeps the balance bit of the link
+    void setChild(uint32_t node, bool right, uint32_t index)
+    {
+        uint32_t &link = right ? nodes[node].right : nodes[node].left;
+        link = (link & taller_bit) | index;
+    }
+
+    //? -1 when the left subtree is one level higher, +1 when the right one is, 0 when they are equal
+    int balance(uint32_t node) const
+    {
+        return static_cast<int>(nodes[node].right >> 31) - static_cast<int>(nodes[node].left >> 31);
+    }
+
+    void setBalance(uint32_t node, int balance)
+    {
+        nodes[node].left = (nodes[node].left & index_mask) | (balance < 0 ? taller_bit : 0);
+        nodes[node].right = (nodes[node].right & index_mask) | (balance > 0 ? taller_bit : 0);
+    }
+
+    //? Hooks a subtree back into the tree where path[depth - 1] led, or at the root
+    void replaceSubtree(const uint32_t *path, const bool *turns, int depth, uint32_t subtree)
+    {
+        if (depth == 0)
+        {
+            root = subtree;
+        }
+        else
+        {
+            setChild(path[depth - 1], turns[depth - 1], subtree);
+        }
+    }
+
+    //
+    //! SECTION Balancing
+    //
+
+    uint32_t rotate(uint32_t node, bool left);
+    uint32_t rebalance(uint32_t node, bool &shorter);
+    uint32_t buildRange(size_t first, size_t last, int &height);
+
+    uint32_t createNode(const T &value)
+    {
+        if (nodes.size() >= nil)
+        {
+            throw std::runtime_error("CompactTreeSet cannot hold more than 2^31 - 1 values");
+        }
+        nodes.emplace_back(value);
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+    void removeSlot(uint32_t slot);
+
+    //? The last node where the descent turned left is the smallest value that is not before key
+    template <typename Key> uint32_t lowerBoundIndex(const Key &key) const
+    {
+        uint32_t node = root;
+        uint32_t bound = nil;
+        while (node != nil)
+        {
+            const bool right = less(nodes[node].value, key);
+            if (!right)
+            {
+                bound = node;
+            }
+            node = child(node, right);
+        }
+        return bound;
+    }
+
+  public:
+    //
+    //! SECTION Construction
+    //
+
+    /**
+     * @brief Create an empty set
+     */
+    explicit CompactTreeSet(const Compare &compare = Compare()) : CompareHolder<Compare>(compare), root(nil)
+    {
+    }
+
+    /**
+     * @brief Build a set from a range of values in linear time
+     *
+     * @param first The beginning of the range
+     * @param last The end of the range
+     * @param compare The comparator of the new set
+     * @return CompactTreeSet A set holding every distinct value of the range
+     *
+     * Unsorted ranges are sorted first, duplicates are dropped. The nodes are stored in sorted order and each
+     * subtree is rooted at the middle of its range, so an inorder walk reads the vector front to back.
+     */
+    template <typename InputIt>
+    static CompactTreeSet fromSorted(InputIt first, InputIt last, const Compare &compare = Compare())
+    {
+        std::vector<T> sorted(first, last);
+        if (!std::is_sorted(sorted.begin(), sorted.end(), compare))
+        {
+            std::sort(sorted.begin(), sorted.end(), compare);
+        }
+        sorted.erase(std::unique(sorted.begin(), sorted.end(),
+                                 [&compare](const T &left, const T &right) { return !compare(left, right); }),
+                     sorted.end());
+
+        CompactTreeSet set(compare);
+        if (sorted.size() >= nil)
+        {
+            throw std::runtime_error("CompactTreeSet cannot hold more than 2^31 - 1 values");
+        }
+        set.nodes.reserve(sorted.size());
+        for (T &value : sorted)
+        {
+            set.nodes.emplace_back(std::move(value));
+        }
+        int height = 0;
+        set.root = set.buildRange(0, set.nodes.size(), height);
+        return set;
+    }
+
+    //
+    //! SECTION Queries
+    //
+
+    /**
+     * @brief Get a copy of the comparator
+     *
+     * @return Compare The comparator ordering the set
+     */
+    Compare key_comp() const
+    {
+        return this->comparator();
+    }
+
+    /**
+     * @brief Get the number of values
+     *
+     * @return size_t The number of values
+     */
+    size_t size() const
+    {
+        return nodes.size();
+    }
+
+    /**
+     * @brief Check if the set is empty
+     *
+     * @return true If size() is 0
+     */
+    bool empty() const
+    {
+        return nodes.empty();
+    }
+
+    /**
+     * @brief Get the height of the tree, -1 when empty and 0 for a single value
+     *
+     * @return int The number of edges on the longest root to leaf path
+     *
+     * Nodes store no heights, but the balance bits point to the taller side at every level, so following them from
+     * the root finds a deepest leaf in O(log n).
+     */
+    int height() const;
+
+    /**
+     * @brief Get the bytes held by the node vector, including its unused capacity
+     *
+     * @return size_t capacity() * the size of one node. Heap memory owned by the values (long strings) is not counted
+     */
+    size_t memoryUsage() const
+    {
+        return nodes.capacity() * sizeof(Node);
+    }
+
+    /**
+     * @brief Get the size of one node
+     *
+     * @return size_t The bytes per value when the vector is full, 12 for int
+     */
+    static constexpr size_t nodeSize()
+    {
+        return sizeof(Node);
+    }
+
+    /**
+     * @brief Check if a value is in the set
+     *
+     * @param key The value, or with a transparent comparator any key comparable with T
+     * @return true If the value is in the set
+     */
+    template <typename Key> bool contains(const Key &key) const
+    {
+        const uint32_t node = lowerBoundIndex(key);
+        return node != nil && !less(key, nodes[node].value);
+    }
+
+    /**
+     * @brief Visit the values in order
+     *
+     * @param callback Called with each value. If it returns bool, returning false stops the traversal
+     * @return true If every value was visited, false if the callback stopped early
+     */
+    template <typename Callback> bool traverseInorder(Callback &&callback) const;
+
+    //
+    //! SECTION Modification
+    //
+
+    /**
+     * @brief Insert a value, unless an equal one is already in the set
+     *
+     * @param value The value to insert
+     * @return true If the value was inserted
+     * @throws std::runtime_error if the set already holds 2^31 - 1 values
+     *
+     * Rebalances on the way back up the remembered path, with at most one single or double rotation.
+     */
+    bool insert(const T &value);
+
+    /**
+     * @brief Remove a value
+     *
+     * @param value The value to remove
+     * @return true If the value was in the set
+     *
+     * A node with two children takes over the value of its in-order successor, and the successor's node is
+     * unlinked instead. The last node of the vector then moves into the freed slot, which costs one more descent to
+     * find its parent, and keeps the vector dense.
+     */
+    bool erase(const T &value);
+
+    /**
+     * @brief Make room for count values in total without reallocating
+     *
+     * @param count The number of values the set will hold
+     */
+    void reserve(size_t count)
+    {
+        nodes.reserve(count);
+    }
+
+    /**
+     * @brief Release the unused capacity of the node vector
+     */
+    void shrinkToFit()
+    {
+        nodes.shrink_to_fit();
+    }
+
+    /**
+     * @brief Remove every value
+     */
+    void clear()
+    {
+        nodes.clear();
+        root = nil;
+    }
+};
+
+//
+//? Implementation
+//
+
+template <typename T, typename Compare> uint32_t CompactTreeSet<T, Compare>::rotate(uint32_t node, bool left)
+{
+    //? A left rotation lifts the right child, a right rotation the left one. Balance bits are fixed by the caller
+    const uint32_t pivot = child(node, left);
+    setChild(node, left, child(pivot, !left));
+    setChild(pivot, !left, node);
+    return pivot;
+}
+
+template <typename T, typename Compare>
+uint32_t CompactTreeSet<T, Compare>::rebalance(uint32_t node, bool &shorter)
+{
+    //? node has a balance of +2 or -2, stored as +1 or -1 with the heavy side in heavy. shorter tells whether the
+    //? subtree ends up one level lower than before the rotation, which only matters to erase
+    const bool heavyRight = balance(node) > 0;
+    const int sign = heavyRight ? 1 : -1;
+    const uint32_t heavy = child(node, heavyRight);
+    const int heavyBalance = balance(heavy);
+
+    if (heavyBalance == -sign)
+    {
+        //? Double rotation: the inner grandchild becomes the root of the subtree
+        const uint32_t inner = child(heavy, !heavyRight);
+        const int innerBalance = balance(inner);
+        setChild(node, heavyRight, rotate(heavy, !heavyRight));
+        const uint32_t top = rotate(node, heavyRight);
+        setBalance(node, innerBalance == sign ? -sign : 0);
+        setBalance(heavy, innerBalance == -sign ? sign : 0);
+        setBalance(top, 0);
+        shorter = true;
+        return top;
+    }
+
+    const uint32_t top = rotate(node, heavyRight);
+    if (heavyBalance == 0)
+    {
+        //? Only erase gets here: the subtree keeps its height
+        setBalance(node, sign);
+        setBalance(top, -sign);
+        shorter = false;
+    }
+    else
+    {
+        setBalance(node, 0);
+        setBalance(top, 0);
+        shorter = true;
+    }
+    return top;
+}
+
+template <typename T, typename Compare>
+uint32_t CompactTreeSet<T, Compare>::buildRange(size_t first, size_t last, int &height)
+{
+    if (first == last)
+    {
+        height = -1;
+        return nil;
+    }
+    const size_t middle = first + (last - first) / 2;
+    const auto node = static_cast<uint32_t>(middle);
+    int leftHeight = 0, rightHeight = 0;
+    setChild(node, false, buildRange(first, middle, leftHeight));
+    setChild(node, true, buildRange(middle + 1, last, rightHeight));
+    setBalance(node, rightHeight - leftHeight);
+    height = 1 + std::max(leftHeight, rightHeight);
+    return node;
+}
+
+template <typename T, typename Compare> int CompactTreeSet<T, Compare>::height() const
+{
+    int height = -1;
+    for (uint32_t node = root; node != nil; node = child(node, balance(node) > 0))
+    {
+        height++;
+    }
+    return height;
+}
+
+template <typename T, typename Compare>
+template <typename Callback>
+bool CompactTreeSet<T, Compare>::traverseInorder(Callback &&callback) const
+{
+    uint32_t stack[max_height];
+    int depth = 0;
+    uint32_t node = root;
+    while (node != nil || depth > 0)
+    {
+        while (node != nil)
+        {
+            stack[depth++] = node;
+            node = child(node, false);
+        }
+        node = stack[--depth];
+        if constexpr (std::is_same_v<std::invoke_result_t<Callback &, const T &>, void>)
+        {
+            callback(nodes[node].value);
+        }
+        else if (!callback(nodes[node].value))
+        {
+            return false;
+        }
+        node = child(node, true);
+    }
+    return true;
+}
+
+template <typename T, typename Compare> bool CompactTreeSet<T, Compare>::insert(const T &value)
+{
+    uint32_t path[max_height];
+    bool turns[max_height]; //? true where the path went right
+    int depth = 0;
+    for (uint32_t node = root; node != nil;)
+    {
+        const bool right = less(nodes[node].value, value);
+        if (!right && !less(value, nodes[node].value))
+        {
+            return false;
+        }
+        path[depth] = node;
+        turns[depth++] = right;
+        node = child(node, right);
+    }
+
+    const uint32_t created = createNode(value);
+    replaceSubtree(path, turns, depth, created);
+
+    //? Walk back up while the subtree below grew taller
+    while (depth > 0)
+    {
+        const uint32_t node = path[--depth];
+        const int grown = balance(node) + (turns[depth] ? 1 : -1);
+        if (grown == 0)
+        {
+            setBalance(node, 0);
+            break;
+        }
+        if (grown == 1 || grown == -1)
+        {
+            setBalance(node, grown);
+            continue;
+        }
+        //? The stored balance already points to the heavy side, a rotation restores the height from before
+        bool shorter = false;
+        replaceSubtree(path, turns, depth, rebalance(node, shorter));
+        break;
+    }
+    return true;
+}
+
+template <typename T, typename Compare> bool CompactTreeSet<T, Compare>::erase(const T &value)
+{
+    uint32_t path[max_height];
+    bool turns[max_height];
+    int depth = 0;
+    uint32_t node = root;
+    while (node != nil)
+    {
+        const bool right = less(nodes[node].value, value);
+        if (!right && !less(value, nodes[node].value))
+        {
+            break;
+        }
+        path[depth] = node;
+        turns[depth++] = right;
+        node = child(node, right);
+    }
+    if (node == nil)
+    {
+        return false;
+    }
+
+    //? With two children, the successor (leftmost of the right subtree) gives up its value and its node instead
+    uint32_t removed = node;
+    if (child(node, false) != nil && child(node, true) != nil)
+    {
+        path[depth] = node;
+        turns[depth++] = true;
+        removed = child(node, true);
+        while (child(removed, false) != nil)
+        {
+            path[depth] = removed;
+            turns[depth++] = false;
+            removed = child(removed, false);
+        }
+        nodes[node].value = std::move(nodes[removed].value);
+    }
+    const uint32_t orphan = child(removed, false) != nil ? child(removed, false) : child(removed, true);
+    replaceSubtree(path, turns, depth, orphan);
+
+    //? Walk back up while the subtree below got shorter
+    while (depth > 0)
+    {
+        const uint32_t parent = path[--depth];
+        const int shrunk = balance(parent) - (turns[depth] ? 1 : -1);
+        if (shrunk == 1 || shrunk == -1)
+        {
+            setBalance(parent, shrunk);
+            break;
+        }
+        if (shrunk == 0)
+        {
+            setBalance(parent, 0);
+            continue;
+        }
+        //? The stored balance is the opposite of the side that shrank, i.e. already the heavy side
+        bool shorter = false;
+        replaceSubtree(path, turns, depth, rebalance(parent, shorter));
+        if (!shorter)
+        {
+            break;
+        }
+    }
+
+    removeSlot(removed);
+    return true;
+}
+
+template <typename T, typename Compare> void CompactTreeSet<T, Compare>::removeSlot(uint32_t slot)
+{
+    const auto last = static_cast<uint32_t>(nodes.size() - 1);
+    if (slot != last)
+    {
+        //? The last node moves into the unlinked slot, so whatever linked to it has to link to slot instead
+        uint32_t parent = nil;
+        bool right = false;
+        for (uint32_t node = root; node != last;)
+        {
+            parent = node;
+            right = less(nodes[node].value, nodes[last].value);
+            node = child(node, right);
+        }
+        nodes[slot] = std::move(nodes[last]);
+        if (parent == nil)
+        {
+            root = slot;
+        }
+        else
+        {
+            setChild(parent, right, slot);
+        }
+    }
+    nodes.pop_back();
+}
+
+} // namespace models
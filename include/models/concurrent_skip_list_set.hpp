@@ -0,0 +1,531 @@
+#pragma once
+
+#include "epoch_reclamation.hpp"
+#include "tree_policies.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace models
+{
+
+/**
+ * @brief An ordered set of unique values that any number of threads can read and modify at the same time
+ *
+ * @tparam T The type of values stored in the set, any copyable type the comparator can order
+ * @tparam Compare A strict weak ordering on T, as for BinaryTreeSet. Defaults to std::less<>
+ *
+ * The set is a lazy skip list (Herlihy, Lev, Luchangco and Shavit): every value sits in a tower of forward links,
+ * the tower heights are random with P(height > h) = 4^-h, so a search skips along the top levels and drops down
+ * when it would overshoot, O(log n) expected steps.
+ *
+ * - contains() and traverseInorder() are lock-free: they never write shared memory except to pin the epoch domain,
+ *   so readers scale with cores and are never blocked by writers
+ * - insert() and erase() search without locks, then lock only the predecessors they relink (and erase() the victim
+ *   itself) and validate that those have not changed in the meantime, retrying the search if they have. Writers to
+ *   different parts of the set do not contend
+ * - erase() first marks the victim as logically deleted, which is the instant it leaves the set, then unlinks it.
+ *   Unlinked nodes are retired to an EpochDomain and freed only once no reader can still be standing on them
+ *
+ * A balanced tree was not used because rotations move many links at once, which readers cannot follow without
+ * locks; skip list links only ever change one at a time.
+ */
+template <typename T, typename Compare = std::less<>>
+class ConcurrentSkipListSet : private CompareHolder<Compare>
+{
+  public:
+    /**
+     * @brief The number of levels of the tallest tower, enough for about 4^16 values
+     */
+    static constexpr int max_level = 16;
+
+  private:
+    struct Node
+    {
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage; //? Left empty in the head sentinel
+        int top_level;
+        std::atomic<bool> marked;
+        std::atomic<bool> fully_linked;
+        std::atomic<bool> locked;
+
+        explicit Node(int topLevel) : top_level(topLevel), marked(false), fully_linked(false), locked(false)
+        {
+        }
+
+        const T &value() const
+        {
+            return *std::launder(reinterpret_cast<const T *>(&storage));
+        }
+
+        //? The tower of forward links is allocated in the same block, right after the node
+        std::atomic<Node *> &next(int level)
+        {
+            unsigned char *links = reinterpret_cast<unsigned char *>(this) + links_offset;
+            return reinterpret_cast<std::atomic<Node *> *>(links)[level];
+        }
+
+        void lock()
+        {
+            int spins = 0;
+            while (locked.exchange(true, std::memory_order_acquire))
+            {
+                while (locked.load(std::memory_order_relaxed))
+                {
+                    if (++spins > 64)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }
+
+        void unlock()
+        {
+            locked.store(false, std::memory_order_release);
+        }
+    };
+
+    static constexpr size_t link_alignment = alignof(std::atomic<Node *>);
+    static constexpr size_t links_offset = (sizeof(Node) + link_alignment - 1) / link_alignment * link_alignment;
+    static constexpr std::align_val_t node_alignment{alignof(Node) > link_alignment ? alignof(Node) : link_alignment};
+
+    Node *head;
+    std::atomic<size_t> set_size;
+    mutable EpochDomain epochs; //? Pinned by readers as well
+
+    //
+    //! SECTION Node lifetime
+    //
+
+    static Node *allocateNode(int topLevel);
+    static Node *createNode(const T &value, int topLevel);
+    static void destroyNode(void *node);
+    static int randomLevel();
+
+    //
+    //! SECTION Search
+    //
+
+    template <typename A, typename B> bool less(const A &a, const B &b) const
+    {
+        return this->comparator()(a, b);
+    }
+
+    int findPath(const T &value, Node **preds, Node **succs) const;
+    static void unlockAll(Node **locked, int count);
+
+    template <typename Callback> static bool visit(Callback &callback, const T &value)
+    {
+        if constexpr (std::is_same_v<std::invoke_result_t<Callback &, const T &>, void>)
+        {
+            callback(value);
+            return true;
+        }
+        else
+        {
+            return static_cast<bool>(callback(value));
+        }
+    }
+
+  public:
+    //
+    //! SECTION Constructors
+    //
+
+    ConcurrentSkipListSet() : ConcurrentSkipListSet(Compare())
+    {
+    }
+
+    /**
+     * @brief Create an empty set ordered by the given comparator
+     *
+     * @param compare The comparator, copied into the set
+     */
+    explicit ConcurrentSkipListSet(const Compare &compare);
+
+    /**
+     * @brief Destroy the set. No other thread may still be using it
+     */
+    ~ConcurrentSkipListSet();
+
+    ConcurrentSkipListSet(const ConcurrentSkipListSet &) = delete;
+    ConcurrentSkipListSet &operator=(const ConcurrentSkipListSet &) = delete;
+
+    /**
+     * @brief Get a copy of the comparator
+     *
+     * @return Compare The comparator ordering the set
+     */
+    Compare key_comp() const
+    {
+        return this->comparator();
+    }
+
+    //
+    //! SECTION Modification, safe to call from any number of threads
+    //
+
+    /**
+     * @brief Insert a value into the set
+     *
+     * @param value The value to insert
+     * @return true If the value was inserted
+     * @return false If the value was already in the set
+     */
+    bool insert(const T &value);
+
+    /**
+     * @brief Erase a value from the set
+     *
+     * @param value The value to erase
+     * @return true If this call erased the value
+     * @return false If the value was not in the set, or another thread erased it first
+     */
+    bool erase(const T &value);
+
+    //
+    //! SECTION Lock-free reads, safe to call from any number of threads
+    //
+
+    /**
+     * @brief Check if a value is in the set
+     *
+     * @param value The value to check for
+     * @return true If the value is in the set
+     * @return false Otherwise
+     */
+    bool contains(const T &value) const;
+
+    /**
+     * @brief Get the number of values in the set
+     *
+     * @return size_t The number of values, exact once concurrent modifications have finished
+     */
+    size_t size() const
+    {
+        return set_size.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Check if the set is empty
+     *
+     * @return true If size() is 0
+     */
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Visit the values of the set in order
+     *
+     * @param callback Called with each value. If it returns bool, returning false stops the traversal
+     * @return true If every value was visited, false if the callback stopped early
+     *
+     * The traversal is weakly consistent: it sees every value that stays in the set for the whole traversal, may or
+     * may not see values inserted or erased meanwhile, and never sees a value twice.
+     */
+    template <typename Callback> bool traverseInorder(Callback &&callback) const;
+};
+
+//? Implementation
+//? Implementation
+//? Implementation
+
+template <typename T, typename Compare>
+typename ConcurrentSkipListSet<T, Compare>::Node *ConcurrentSkipListSet<T, Compare>::allocateNode(int topLevel)
+{
+    void *block = ::operator new(links_offset + topLevel * sizeof(std::atomic<Node *>), node_alignment);
+    Node *node = new (block) Node(topLevel);
+    for (int level = 0; level < topLevel; ++level)
+    {
+        new (&node->next(level)) std::atomic<Node *>(nullptr);
+    }
+    return node;
+}
+
+template <typename T, typename Compare>
+typename ConcurrentSkipListSet<T, Compare>::Node *ConcurrentSkipListSet<T, Compare>::createNode(const T &value,
+                                                                                                  int topLevel)
+{
+    Node *node = allocateNode(topLevel);
+    try
+    {
+        new (&node->storage) T(value);
+    }
+    catch (...)
+    {
+        node->~Node();
+        ::operator delete(node, node_alignment);
+        throw;
+    }
+    return node;
+}
+
+template <typename T, typename Compare> void ConcurrentSkipListSet<T, Compare>::destroyNode(void *pointer)
+{
+    Node *node = static_cast<Node *>(pointer);
+    node->value().~T();
+    node->~Node();
+    ::operator delete(node, node_alignment);
+}
+
+template <typename T, typename Compare> int ConcurrentSkipListSet<T, Compare>::randomLevel()
+{
+    //? xorshift64, one generator per thread so writers do not share state
+    thread_local uint64_t state =
+        0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    //? Two random bits per level: each level is kept with probability 1/4
+    uint64_t bits = state;
+    int level = 1;
+    while (level < max_level && (bits & 3) == 0)
+    {
+        ++level;
+        bits >>= 2;
+    }
+    return level;
+}
+
+template <typename T, typename Compare>
+int ConcurrentSkipListSet<T, Compare>::findPath(const T &value, Node **preds, Node **succs) const
+{
+    //? Records, per level, the last node before value and the first node not before it (nullptr is past the end)
+    int found = -1;
+    Node *pred = head;
+    for (int level = max_level - 1; level >= 0; --level)
+    {
+        Node *current = pred->next(level).load(std::memory_order_acquire);
+        while (current && less(current->value(), value))
+        {
+            pred = current;
+            current = pred->next(level).load(std::memory_order_acquire);
+        }
+        if (found == -1 && current && !less(value, current->value()))
+        {
+            found = level;
+        }
+        preds[level] = pred;
+        succs[level] = current;
+    }
+    return found;
+}
+
+template <typename T, typename Compare>
+void ConcurrentSkipListSet<T, Compare>::unlockAll(Node **locked, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        locked[i]->unlock();
+    }
+}
+
+template <typename T, typename Compare>
+ConcurrentSkipListSet<T, Compare>::ConcurrentSkipListSet(const Compare &compare)
+    : CompareHolder<Compare>(compare), head(allocateNode(max_level)), set_size(0)
+{
+}
+
+template <typename T, typename Compare> ConcurrentSkipListSet<T, Compare>::~ConcurrentSkipListSet()
+{
+    Node *current = head->next(0).load(std::memory_order_relaxed);
+    while (current)
+    {
+        Node *next = current->next(0).load(std::memory_order_relaxed);
+        destroyNode(current);
+        current = next;
+    }
+    head->~Node();
+    ::operator delete(head, node_alignment);
+}
+
+template <typename T, typename Compare> bool ConcurrentSkipListSet<T, Compare>::insert(const T &value)
+{
+    Node *preds[max_level];
+    Node *succs[max_level];
+    const int topLevel = randomLevel();
+    Node *node = nullptr;
+
+    EpochDomain::Guard guard = epochs.pin();
+    while (true)
+    {
+        const int found = findPath(value, preds, succs);
+        if (found != -1)
+        {
+            Node *existing = succs[found];
+            if (!existing->marked.load(std::memory_order_acquire))
+            {
+                //? Another thread is still linking the value in: it is in the set once that finishes
+                while (!existing->fully_linked.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+                if (node)
+                {
+                    destroyNode(node);
+                }
+                return false;
+            }
+            //? The value is being erased, retry once it has been unlinked
+            continue;
+        }
+
+        if (!node)
+        {
+            node = createNode(value, topLevel);
+        }
+
+        //? Lock the predecessors bottom-up, i.e. in descending order like erase, and check nothing changed between
+        //? them and their successors since the search
+        Node *locked[max_level];
+        int lockedCount = 0;
+        bool valid = true;
+        for (int level = 0; valid && level < topLevel; ++level)
+        {
+            Node *pred = preds[level];
+            Node *succ = succs[level];
+            if (lockedCount == 0 || locked[lockedCount - 1] != pred)
+            {
+                pred->lock();
+                locked[lockedCount++] = pred;
+            }
+            valid = !pred->marked.load(std::memory_order_acquire) &&
+                    (!succ || !succ->marked.load(std::memory_order_acquire)) &&
+                    pred->next(level).load(std::memory_order_acquire) == succ;
+        }
+        if (!valid)
+        {
+            unlockAll(locked, lockedCount);
+            continue;
+        }
+
+        for (int level = 0; level < topLevel; ++level)
+        {
+            node->next(level).store(succs[level], std::memory_order_relaxed);
+        }
+        for (int level = 0; level < topLevel; ++level)
+        {
+            preds[level]->next(level).store(node, std::memory_order_release);
+        }
+        node->fully_linked.store(true, std::memory_order_release);
+        unlockAll(locked, lockedCount);
+        set_size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+}
+
+template <typename T, typename Compare> bool ConcurrentSkipListSet<T, Compare>::erase(const T &value)
+{
+    Node *preds[max_level];
+    Node *succs[max_level];
+    Node *victim = nullptr;
+    bool markedByUs = false;
+
+    EpochDomain::Guard guard = epochs.pin();
+    while (true)
+    {
+        const int found = findPath(value, preds, succs);
+        if (!markedByUs)
+        {
+            //? Only a fully linked node found at its top level is safe to erase, anything else is still being
+            //? inserted or already being erased
+            if (found == -1)
+            {
+                return false;
+            }
+            victim = succs[found];
+            if (!victim->fully_linked.load(std::memory_order_acquire) || victim->top_level - 1 != found ||
+                victim->marked.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            victim->lock();
+            if (victim->marked.load(std::memory_order_relaxed))
+            {
+                victim->unlock();
+                return false;
+            }
+            victim->marked.store(true, std::memory_order_release);
+            markedByUs = true;
+        }
+
+        Node *locked[max_level];
+        int lockedCount = 0;
+        bool valid = true;
+        for (int level = 0; valid && level < victim->top_level; ++level)
+        {
+            Node *pred = preds[level];
+            if (lockedCount == 0 || locked[lockedCount - 1] != pred)
+            {
+                pred->lock();
+                locked[lockedCount++] = pred;
+            }
+            valid = !pred->marked.load(std::memory_order_acquire) &&
+                    pred->next(level).load(std::memory_order_acquire) == victim;
+        }
+        if (!valid)
+        {
+            unlockAll(locked, lockedCount);
+            continue;
+        }
+
+        //? Unlink top-down, so the node stays reachable at level 0 until it has left every other level
+        for (int level = victim->top_level - 1; level >= 0; --level)
+        {
+            preds[level]->next(level).store(victim->next(level).load(std::memory_order_relaxed),
+                                            std::memory_order_release);
+        }
+        victim->unlock();
+        unlockAll(locked, lockedCount);
+        set_size.fetch_sub(1, std::memory_order_relaxed);
+        epochs.retire(victim, &destroyNode);
+        return true;
+    }
+}
+
+template <typename T, typename Compare> bool ConcurrentSkipListSet<T, Compare>::contains(const T &value) const
+{
+    EpochDomain::Guard guard = epochs.pin();
+    Node *pred = head;
+    Node *current = nullptr;
+    for (int level = max_level - 1; level >= 0; --level)
+    {
+        current = pred->next(level).load(std::memory_order_acquire);
+        while (current && less(current->value(), value))
+        {
+            pred = current;
+            current = pred->next(level).load(std::memory_order_acquire);
+        }
+    }
+    return current && !less(value, current->value()) && current->fully_linked.load(std::memory_order_acquire) &&
+           !current->marked.load(std::memory_order_acquire);
+}
+
+template <typename T, typename Compare>
+template <typename Callback>
+bool ConcurrentSkipListSet<T, Compare>::traverseInorder(Callback &&callback) const
+{
+    EpochDomain::Guard guard = epochs.pin();
+    for (Node *current = head->next(0).load(std::memory_order_acquire); current;
+         current = current->next(0).load(std::memory_order_acquire))
+    {
+        if (current->fully_linked.load(std::memory_order_acquire) && !current->marked.load(std::memory_order_acquire) &&
+            !visit(callback, current->value()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace models
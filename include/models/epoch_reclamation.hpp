@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace models
+{
+
+/**
+ * @brief Epoch-based memory reclamation for lock-free readers
+ *
+ * A thread pins the domain for the duration of one operation on a concurrent structure. Objects unlinked from the
+ * structure are retired instead of deleted, and only freed once every thread that could still hold a pointer to
+ * them has unpinned.
+ *
+ * The domain keeps a global epoch. Pinning publishes the current epoch in a slot; the epoch advances only when every
+ * pinned slot has caught up with it, so while a thread stays pinned the epoch can move at most one step past the
+ * epoch it published. An object retired in epoch e was unlinked before any thread pinned in epoch e + 1, so it is
+ * unreachable for everyone once the epoch reaches e + 2.
+ *
+ * Slots are claimed per pin, not per thread, so threads need no registration and may come and go freely.
+ */
+class EpochDomain
+{
+  private:
+    struct alignas(64) Slot
+    {
+        std::atomic<bool> in_use{false};
+        std::atomic<uint64_t> epoch{0};
+    };
+
+    struct Retired
+    {
+        void *object;
+        void (*deleter)(void *);
+        uint64_t epoch;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t slot_count;
+    std::atomic<uint64_t> global_epoch;
+    std::mutex retired_mutex;
+    std::vector<Retired> retired;
+    size_t retired_since_collect;
+
+    Slot *acquireSlot();
+    bool tryAdvance();
+
+  public:
+    /**
+     * @brief Number of retirements after which retire() tries to advance the epoch and free objects
+     */
+    static constexpr size_t collect_interval = 64;
+
+    /**
+     * @brief Keeps the domain pinned, from pin() until it is destroyed
+     *
+     * While a guard is alive, no object retired after the guard was created is freed.
+     */
+    class Guard
+    {
+      private:
+        Slot *slot;
+
+        explicit Guard(Slot *slot) : slot(slot)
+        {
+        }
+        friend class EpochDomain;
+
+      public:
+        Guard(Guard &&other) noexcept : slot(other.slot)
+        {
+            other.slot = nullptr;
+        }
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+        Guard &operator=(Guard &&) = delete;
+
+        ~Guard()
+        {
+            if (slot)
+            {
+                slot->in_use.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    /**
+     * @brief Create a domain
+     *
+     * @param slots The number of threads that can be pinned at the same time, further threads wait for a free
+     * slot. Defaults to four per hardware thread.
+     */
+    explicit EpochDomain(size_t slots = defaultSlotCount());
+
+    /**
+     * @brief Free every retired object. No thread may be pinned any more
+     */
+    ~EpochDomain();
+
+    EpochDomain(const EpochDomain &) = delete;
+    EpochDomain &operator=(const EpochDomain &) = delete;
+
+    /**
+     * @brief Get the default number of slots
+     *
+     * @return size_t Four per hardware thread, at least 64
+     */
+    static size_t defaultSlotCount();
+
+    /**
+     * @brief Pin the calling thread, protecting every object it reaches until the guard is destroyed
+     *
+     * @return Guard The pin, released when it goes out of scope
+     */
+    Guard pin();
+
+    /**
+     * @brief Hand over an object that is no longer reachable by threads pinning from now on
+     *
+     * @param object The object, already unlinked from the shared structure
+     * @param deleter Frees the object once no pinned thread can still reach it
+     *
+     * The caller should be pinned itself. Every collect_interval retirements, the domain tries to advance the epoch
+     * and frees the objects that have become safe.
+     */
+    void retire(void *object, void (*deleter)(void *));
+
+    /**
+     * @brief Try to advance the epoch and free every retired object that has become safe
+     */
+    void collect();
+
+    /**
+     * @brief Get the number of retired objects that have not been freed yet
+     *
+     * @return size_t The number of objects waiting for their epoch to pass
+     */
+    size_t pendingCount();
+
+    /**
+     * @brief Get the current global epoch
+     *
+     * @return uint64_t The epoch, which only grows
+     */
+    uint64_t epoch() const
+    {
+        return global_epoch.load();
+    }
+};
+
+} // namespace models
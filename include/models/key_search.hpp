@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+
+namespace models
+{
+
+/**
+ * @brief Instruction sets the node key search can run on
+ */
+enum class SearchKernel
+{
+    Scalar, //? Branchless counting loop, available everywhere
+    Sse2,   //? 4 ints / 2 doubles per compare (x86 baseline)
+    Avx2    //? 8 ints / 4 doubles per compare
+};
+
+/**
+ * @brief Get a printable name for a search kernel
+ *
+ * @param kernel The kernel to name
+ * @return const char* "scalar", "sse2" or "avx2"
+ */
+const char *searchKernelName(SearchKernel kernel);
+
+/**
+ * @brief Check whether this build and the running CPU can execute a search kernel
+ *
+ * @param kernel The kernel to check
+ * @return true if countLess can run with the kernel on this machine
+ */
+bool searchKernelSupported(SearchKernel kernel);
+
+/**
+ * @brief Get the kernel countLess dispatches to, picked once from the CPU features detected at runtime
+ *
+ * @return SearchKernel The widest supported kernel
+ */
+SearchKernel activeSearchKernel();
+
+/**
+ * @brief Count the keys of a sorted node that are strictly less than a value
+ *
+ * @param keys The sorted keys of the node
+ * @param count The number of keys
+ * @param value The value being searched for
+ * @return size_t The index of the first key not less than value (the lower bound)
+ *
+ * Every key is compared with vector instructions and the comparison masks are summed, so finding the child to
+ * descend into costs no data-dependent branches, unlike a binary search whose every step is a coin flip for the
+ * branch predictor.
+ */
+size_t countLess(const int *keys, size_t count, int value);
+size_t countLess(const double *keys, size_t count, double value);
+
+/**
+ * @brief countLess with an explicit kernel, used to check every kernel against the scalar one
+ *
+ * @param kernel The kernel to run, it must be supported (see searchKernelSupported)
+ */
+size_t countLess(SearchKernel kernel, const int *keys, size_t count, int value);
+size_t countLess(SearchKernel kernel, const double *keys, size_t count, double value);
+
+} // namespace models
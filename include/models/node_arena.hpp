@@ -0,0 +1,419 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace models
+{
+
+/**
+ * @brief Allocation counters reported by the node allocator policies
+ *
+ * - allocations: Number of nodes constructed through the allocator
+ * - deallocations: Number of nodes destroyed through the allocator (bulk releases are not counted per node)
+ * - system_allocations: Number of requests made to the system allocator (operator new)
+ * - bytes_reserved: Bytes currently obtained from the system allocator
+ * - bytes_in_use: Bytes currently occupied by live nodes
+ */
+struct AllocationStats
+{
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t system_allocations = 0;
+    size_t bytes_reserved = 0;
+    size_t bytes_in_use = 0;
+};
+
+/**
+ * @brief A slab/free-list arena for tree nodes (default allocator policy of BinaryTreeSet)
+ *
+ * @tparam Node The node type being allocated
+ *
+ * Nodes are carved out of large contiguous slabs with a bump pointer, so nodes created one after another sit next to
+ * each other in memory. Destroyed nodes go onto an intrusive free list and are reused before the bump pointer moves
+ * on. Slabs start small and double in size up to a cap, so small sets stay small and large sets make only a
+ * handful of calls to the system allocator.
+ *
+ * release() drops every slab at once without visiting the nodes, which lets a tree of trivially destructible values
+ * be cleared in O(number of slabs) instead of O(n).
+ */
+template <typename Node> class NodeArena
+{
+  private:
+    //? A free slot stores the link to the next free slot in the memory of the node it replaces
+    union Slot {
+        Slot *next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+    static_assert(alignof(Slot) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Slabs come from the default operator new");
+
+    struct Slab
+    {
+        Slot *slots;
+        size_t capacity;
+    };
+
+    static constexpr size_t first_slab_nodes = 32;
+    static constexpr size_t max_slab_nodes = 8192;
+
+    std::vector<Slab> slabs;
+    Slot *free_list;
+    Slot *bump;
+    Slot *bump_end;
+    AllocationStats counters;
+
+    Slot *acquireSlot();
+    void addSlab(size_t capacity);
+
+  public:
+    /**
+     * @brief True when release() can drop every node without visiting them
+     */
+    static constexpr bool bulk_release = true;
+
+    NodeArena();
+    ~NodeArena();
+
+    NodeArena(const NodeArena &) = delete;
+    NodeArena &operator=(const NodeArena &) = delete;
+
+    /**
+     * @brief Take over every slab of another arena, nodes keep their addresses and other is left empty
+     */
+    NodeArena(NodeArena &&other) noexcept;
+    NodeArena &operator=(NodeArena &&other) noexcept;
+
+    /**
+     * @brief Make sure the next count node creations are served from one contiguous block
+     *
+     * @param count The number of nodes about to be created
+     *
+     * If the current slab has less than count free slots, a slab of exactly count slots is allocated (the rest of
+     * the current slab is left unused). Free-listed slots are still handed out first.
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Take ownership of every slab of another arena, so its live nodes can be destroyed through this one
+     *
+     * @param other The arena to absorb, it is left empty
+     *
+     * Nodes keep their addresses. The free slots of other are appended to this arena's free list, and if this arena
+     * has no bump space left it continues from other's.
+     */
+    void adopt(NodeArena &&other);
+
+    /**
+     * @brief Construct a new node in the arena
+     *
+     * @param args The arguments forwarded to the node constructor
+     * @return Node* Pointer to the new node
+     *
+     * If the node constructor throws, the slot is returned to the free list and the exception propagates.
+     */
+    template <typename... Args> Node *create(Args &&...args);
+
+    /**
+     * @brief Destroy a node created by this arena and put its slot on the free list
+     *
+     * @param node The node to destroy
+     */
+    void destroy(Node *node);
+
+    /**
+     * @brief Return every slab to the system allocator at once
+     *
+     * Node destructors are not run. Callers must destroy nodes with non-trivial destructors first.
+     */
+    void release();
+
+    /**
+     * @brief Get the allocation counters for this arena
+     *
+     * @return AllocationStats The current allocation counts and byte totals
+     */
+    AllocationStats stats() const;
+};
+
+/**
+ * @brief An allocator policy that creates every node with its own new/delete
+ *
+ * @tparam Node The node type being allocated
+ *
+ * Kept as an opt-in alternative to NodeArena for comparison and for code that relies on nodes being independent
+ * heap objects. It cannot release nodes in bulk.
+ */
+template <typename Node> class HeapNodeAllocator
+{
+  private:
+    AllocationStats counters;
+
+  public:
+    /**
+     * @brief True when release() can drop every node without visiting them
+     */
+    static constexpr bool bulk_release = false;
+
+    /**
+     * @brief Construct a new node with operator new
+     *
+     * @param args The arguments forwarded to the node constructor
+     * @return Node* Pointer to the new node
+     */
+    template <typename... Args> Node *create(Args &&...args);
+
+    /**
+     * @brief No-op, every node is a separate allocation
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Take over the counters of another allocator, whose nodes can then be deleted through this one
+     *
+     * @param other The allocator to absorb, its counters are reset
+     */
+    void adopt(HeapNodeAllocator &&other);
+
+    /**
+     * @brief Delete a node created by this allocator
+     *
+     * @param node The node to delete
+     */
+    void destroy(Node *node);
+
+    /**
+     * @brief No-op, every node must be destroyed individually
+     */
+    void release();
+
+    /**
+     * @brief Get the allocation counters for this allocator
+     *
+     * @return AllocationStats The current allocation counts and byte totals
+     */
+    AllocationStats stats() const;
+};
+
+//? Implementation
+//? Implementation
+//? Implementation
+
+template <typename Node>
+NodeArena<Node>::NodeArena() : free_list(nullptr), bump(nullptr), bump_end(nullptr), counters()
+{
+}
+
+template <typename Node> NodeArena<Node>::~NodeArena()
+{
+    release();
+}
+
+template <typename Node>
+NodeArena<Node>::NodeArena(NodeArena &&other) noexcept
+    : slabs(std::move(other.slabs)), free_list(std::exchange(other.free_list, nullptr)),
+      bump(std::exchange(other.bump, nullptr)), bump_end(std::exchange(other.bump_end, nullptr)),
+      counters(std::exchange(other.counters, AllocationStats()))
+{
+    other.slabs.clear();
+}
+
+template <typename Node> NodeArena<Node> &NodeArena<Node>::operator=(NodeArena &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        slabs = std::move(other.slabs);
+        other.slabs.clear();
+        free_list = std::exchange(other.free_list, nullptr);
+        bump = std::exchange(other.bump, nullptr);
+        bump_end = std::exchange(other.bump_end, nullptr);
+        counters = std::exchange(other.counters, AllocationStats());
+    }
+    return *this;
+}
+
+/**
+ * @brief Allocate a new slab and point the bump allocator at it
+ *
+ * @tparam Node The node type being allocated
+ * @param capacity The number of node slots in the new slab
+ */
+template <typename Node> void NodeArena<Node>::addSlab(size_t capacity)
+{
+    Slot *slots = static_cast<Slot *>(::operator new(capacity * sizeof(Slot)));
+    slabs.push_back({slots, capacity});
+
+    bump = slots;
+    bump_end = slots + capacity;
+    counters.system_allocations++;
+    counters.bytes_reserved += capacity * sizeof(Slot);
+}
+
+/**
+ * @brief Take a slot from the free list, or from the current slab, growing the arena if both are exhausted
+ *
+ * @tparam Node The node type being allocated
+ * @return Slot* Uninitialized storage for one node
+ */
+template <typename Node> typename NodeArena<Node>::Slot *NodeArena<Node>::acquireSlot()
+{
+    if (free_list)
+    {
+        Slot *slot = free_list;
+        free_list = slot->next;
+        return slot;
+    }
+
+    if (bump == bump_end)
+    {
+        const size_t capacity = slabs.empty() ? first_slab_nodes : std::min(slabs.back().capacity * 2, max_slab_nodes);
+        addSlab(capacity);
+    }
+    return bump++;
+}
+
+template <typename Node> void NodeArena<Node>::reserve(size_t count)
+{
+    if (static_cast<size_t>(bump_end - bump) < count)
+    {
+        addSlab(count);
+    }
+}
+
+template <typename Node> void NodeArena<Node>::adopt(NodeArena &&other)
+{
+    if (this == &other)
+    {
+        return;
+    }
+
+    slabs.insert(slabs.end(), other.slabs.begin(), other.slabs.end());
+    other.slabs.clear();
+
+    if (other.free_list)
+    {
+        Slot *tail = other.free_list;
+        while (tail->next)
+        {
+            tail = tail->next;
+        }
+        tail->next = free_list;
+        free_list = other.free_list;
+    }
+    if (bump == bump_end)
+    {
+        bump = other.bump;
+        bump_end = other.bump_end;
+    }
+
+    counters.allocations += other.counters.allocations;
+    counters.deallocations += other.counters.deallocations;
+    counters.system_allocations += other.counters.system_allocations;
+    counters.bytes_reserved += other.counters.bytes_reserved;
+    counters.bytes_in_use += other.counters.bytes_in_use;
+
+    other.free_list = nullptr;
+    other.bump = nullptr;
+    other.bump_end = nullptr;
+    other.counters = AllocationStats();
+}
+
+template <typename Node> template <typename... Args> Node *NodeArena<Node>::create(Args &&...args)
+{
+    Slot *slot = acquireSlot();
+    Node *node;
+    try
+    {
+        node = ::new (static_cast<void *>(slot->storage)) Node(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        slot->next = free_list;
+        free_list = slot;
+        throw;
+    }
+
+    counters.allocations++;
+    counters.bytes_in_use += sizeof(Node);
+    return node;
+}
+
+template <typename Node> void NodeArena<Node>::destroy(Node *node)
+{
+    node->~Node();
+
+    Slot *slot = reinterpret_cast<Slot *>(node);
+    slot->next = free_list;
+    free_list = slot;
+
+    counters.deallocations++;
+    counters.bytes_in_use -= sizeof(Node);
+}
+
+template <typename Node> void NodeArena<Node>::release()
+{
+    for (const Slab &slab : slabs)
+    {
+        ::operator delete(slab.slots);
+    }
+    slabs.clear();
+
+    free_list = nullptr;
+    bump = nullptr;
+    bump_end = nullptr;
+    counters.bytes_reserved = 0;
+    counters.bytes_in_use = 0;
+}
+
+template <typename Node> AllocationStats NodeArena<Node>::stats() const
+{
+    return counters;
+}
+
+template <typename Node> template <typename... Args> Node *HeapNodeAllocator<Node>::create(Args &&...args)
+{
+    Node *node = new Node(std::forward<Args>(args)...);
+
+    counters.allocations++;
+    counters.system_allocations++;
+    counters.bytes_reserved += sizeof(Node);
+    counters.bytes_in_use += sizeof(Node);
+    return node;
+}
+
+template <typename Node> void HeapNodeAllocator<Node>::destroy(Node *node)
+{
+    delete node;
+
+    counters.deallocations++;
+    counters.bytes_reserved -= sizeof(Node);
+    counters.bytes_in_use -= sizeof(Node);
+}
+
+template <typename Node> void HeapNodeAllocator<Node>::reserve(size_t)
+{
+}
+
+template <typename Node> void HeapNodeAllocator<Node>::adopt(HeapNodeAllocator &&other)
+{
+    counters.allocations += other.counters.allocations;
+    counters.deallocations += other.counters.deallocations;
+    counters.system_allocations += other.counters.system_allocations;
+    counters.bytes_reserved += other.counters.bytes_reserved;
+    counters.bytes_in_use += other.counters.bytes_in_use;
+    other.counters = AllocationStats();
+}
+
+template <typename Node> void HeapNodeAllocator<Node>::release()
+{
+}
+
+template <typename Node> AllocationStats HeapNodeAllocator<Node>::stats() const
+{
+    return counters;
+}
+
+} // namespace models
@@ -0,0 +1,551 @@
+#pragma once
+
+#include "epoch_reclamation.hpp"
+#include "tree_policies.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace models
+{
+
+/**
+ * @brief An ordered set whose versions are immutable, so readers can scan a snapshot while a writer keeps going
+ *
+ * @tparam T The type of values stored in the set, any copyable type the comparator can order
+ * @tparam Compare A strict weak ordering on T, as for BinaryTreeSet. Defaults to std::less<>
+ *
+ * The set is a persistent AVL tree. Nodes are never modified once built: insert() and erase() copy the nodes on the
+ * path from the root to the change (O(log n) of them, rotations included) and share every other subtree with the
+ * previous version, then publish the new root with one atomic store.
+ *
+ * snapshot() takes the current root with one atomic load and a reference count increment, and returns a Snapshot
+ * handle that stays valid and unchanged for as long as it lives, however the set is modified meanwhile. Scanning a
+ * snapshot takes no lock at all. Writers are serialised by a mutex among themselves, but never wait for readers.
+ *
+ * Every node counts the parents and snapshots referring to it and is freed with the last of them. The set's own
+ * reference to a replaced root is dropped through an EpochDomain, so a reader between loading the root and counting
+ * its reference never sees it freed.
+ */
+template <typename T, typename Compare = std::less<>>
+class PersistentTreeSet : private CompareHolder<Compare>
+{
+  private:
+    struct Node
+    {
+        const T value;
+        const Node *const left;
+        const Node *const right;
+        const int height;
+        const size_t size;
+        mutable std::atomic<size_t> references;
+
+        Node(const T &value, const Node *left, const Node *right)
+            : value(value), left(left), right(right),
+              height(1 + std::max(PersistentTreeSet::nodeHeight(left), PersistentTreeSet::nodeHeight(right))),
+              size(1 + PersistentTreeSet::nodeSize(left) + PersistentTreeSet::nodeSize(right)), references(1)
+        {
+        }
+    };
+
+    std::atomic<const Node *> root;
+    std::mutex writer_mutex;
+    mutable EpochDomain epochs; //? Pinned by readers while they take a reference to the root
+
+    //
+    //! SECTION Node references
+    //
+
+    //? Functions returning a node hand over one reference to it, makeNode() and balance() take over the references
+    //? passed in for the children
+    static const Node *share(const Node *node)
+    {
+        if (node)
+        {
+            node->references.fetch_add(1, std::memory_order_relaxed);
+        }
+        return node;
+    }
+
+    static void release(const Node *node);
+    static void releaseRoot(void *node);
+
+    static int nodeHeight(const Node *node)
+    {
+        return node ? node->height : -1;
+    }
+
+    static size_t nodeSize(const Node *node)
+    {
+        return node ? node->size : 0;
+    }
+
+    //
+    //! SECTION Path copying
+    //
+
+    template <typename A, typename B> bool less(const A &a, const B &b) const
+    {
+        return this->comparator()(a, b);
+    }
+
+    static const Node *makeNode(const T &value, const Node *left, const Node *right)
+    {
+        return new Node(value, left, right);
+    }
+
+    static const Node *balance(const T &value, const Node *left, const Node *right);
+    const Node *insertInto(const Node *node, const T &value) const;
+    const Node *eraseFrom(const Node *node, const T &value) const;
+    static const Node *eraseMinimum(const Node *node);
+    void publish(const Node *newRoot);
+
+    template <typename Callback> static bool traverse(const Node *node, Callback &callback);
+
+  public:
+    /**
+     * @brief An immutable version of the set
+     *
+     * Copying a snapshot only counts one more reference. The version it refers to is freed, minus the nodes later
+     * versions share, once the set and every snapshot have let go of it.
+     */
+    class Snapshot : private CompareHolder<Compare>
+    {
+      private:
+        const Node *root;
+
+        Snapshot(const Node *root, const Compare &compare) : CompareHolder<Compare>(compare), root(root)
+        {
+        }
+        friend class PersistentTreeSet;
+
+      public:
+        Snapshot(const Snapshot &other) : CompareHolder<Compare>(other), root(share(other.root))
+        {
+        }
+
+        Snapshot(Snapshot &&other) noexcept : CompareHolder<Compare>(other), root(std::exchange(other.root, nullptr))
+        {
+        }
+
+        //? Copy and swap: the version's nodes are ordered by its set's comparator, so the comparator comes along
+        Snapshot &operator=(Snapshot other) noexcept
+        {
+            CompareHolder<Compare>::operator=(other);
+            std::swap(root, other.root);
+            return *this;
+        }
+
+        ~Snapshot()
+        {
+            release(root);
+        }
+
+        /**
+         * @brief Get the number of values in this version
+         *
+         * @return size_t The number of values
+         */
+        size_t size() const
+        {
+            return nodeSize(root);
+        }
+
+        /**
+         * @brief Check if this version is empty
+         *
+         * @return true If size() is 0
+         */
+        bool empty() const
+        {
+            return root == nullptr;
+        }
+
+        /**
+         * @brief Get the height of this version, -1 when empty and 0 for a single value
+         *
+         * @return int The number of edges on the longest root to leaf path
+         */
+        int height() const
+        {
+            return nodeHeight(root);
+        }
+
+        /**
+         * @brief Check if a value is in this version
+         *
+         * @param value The value to check for
+         * @return true If the value is in this version
+         * @return false Otherwise
+         */
+        bool contains(const T &value) const;
+
+        /**
+         * @brief Visit the values of this version in order, without locking
+         *
+         * @param callback Called with each value. If it returns bool, returning false stops the traversal
+         * @return true If every value was visited, false if the callback stopped early
+         */
+        template <typename Callback> bool traverseInorder(Callback &&callback) const
+        {
+            return traverse(root, callback);
+        }
+    };
+
+    //
+    //! SECTION Constructors
+    //
+
+    PersistentTreeSet() : PersistentTreeSet(Compare())
+    {
+    }
+
+    /**
+     * @brief Create an empty set ordered by the given comparator
+     *
+     * @param compare The comparator, copied into the set
+     */
+    explicit PersistentTreeSet(const Compare &compare) : CompareHolder<Compare>(compare), root(nullptr)
+    {
+    }
+
+    /**
+     * @brief Destroy the set. No other thread may still be using it, snapshots taken from it stay valid
+     */
+    ~PersistentTreeSet()
+    {
+        release(root.load(std::memory_order_relaxed));
+    }
+
+    PersistentTreeSet(const PersistentTreeSet &) = delete;
+    PersistentTreeSet &operator=(const PersistentTreeSet &) = delete;
+
+    /**
+     * @brief Get a copy of the comparator
+     *
+     * @return Compare The comparator ordering the set
+     */
+    Compare key_comp() const
+    {
+        return this->comparator();
+    }
+
+    //
+    //! SECTION Modification, serialised among writers, never blocking readers
+    //
+
+    /**
+     * @brief Insert a value, publishing a new version that shares all but O(log n) nodes with the current one
+     *
+     * @param value The value to insert
+     * @return true If the value was inserted
+     * @return false If the value was already in the set (no new version is published)
+     */
+    bool insert(const T &value);
+
+    /**
+     * @brief Erase a value, publishing a new version that shares all but O(log n) nodes with the current one
+     *
+     * @param value The value to erase
+     * @return true If the value was erased
+     * @return false If the value was not in the set (no new version is published)
+     */
+    bool erase(const T &value);
+
+    //
+    //! SECTION Lock-free reads
+    //
+
+    /**
+     * @brief Take a snapshot of the current version
+     *
+     * @return Snapshot A handle to the current version, unaffected by later modifications
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Check if a value is in the current version
+     *
+     * @param value The value to check for
+     * @return true If the value is in the set
+     * @return false Otherwise
+     */
+    bool contains(const T &value) const;
+
+    /**
+     * @brief Get the number of values in the current version
+     *
+     * @return size_t The number of values
+     */
+    size_t size() const;
+
+    /**
+     * @brief Check if the current version is empty
+     *
+     * @return true If size() is 0
+     */
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Visit the values of the current version in order
+     *
+     * @param callback Called with each value. If it returns bool, returning false stops the traversal
+     * @return true If every value was visited, false if the callback stopped early
+     *
+     * The traversal runs on a snapshot, so modifications made meanwhile neither show up in it nor wait for it.
+     */
+    template <typename Callback> bool traverseInorder(Callback &&callback) const
+    {
+        return snapshot().traverseInorder(callback);
+    }
+};
+
+//? Implementation
+//? Implementation
+//? Implementation
+
+template <typename T, typename Compare> void PersistentTreeSet<T, Compare>::release(const Node *node)
+{
+    //? Dropping the last reference to a node drops its references to its children, which are often shared with other
+    //? versions and survive. The recursion only goes as deep as the tree is high
+    if (node && node->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        release(node->left);
+        release(node->right);
+        delete node;
+    }
+}
+
+template <typename T, typename Compare> void PersistentTreeSet<T, Compare>::releaseRoot(void *node)
+{
+    release(static_cast<const Node *>(node));
+}
+
+template <typename T, typename Compare>
+const typename PersistentTreeSet<T, Compare>::Node *PersistentTreeSet<T, Compare>::balance(const T &value,
+                                                                                            const Node *left,
+                                                                                            const Node *right)
+{
+    //? Like AvlBalanced rotations, except the rotated nodes are rebuilt instead of relinked
+    if (nodeHeight(left) > nodeHeight(right) + 1)
+    {
+        const Node *result;
+        if (nodeHeight(left->left) >= nodeHeight(left->right))
+        {
+            result = makeNode(left->value, share(left->left), makeNode(value, share(left->right), right));
+        }
+        else
+        {
+            const Node *inner = left->right;
+            result = makeNode(inner->value, makeNode(left->value, share(left->left), share(inner->left)),
+                              makeNode(value, share(inner->right), right));
+        }
+        release(left);
+        return result;
+    }
+    if (nodeHeight(right) > nodeHeight(left) + 1)
+    {
+        const Node *result;
+        if (nodeHeight(right->right) >= nodeHeight(right->left))
+        {
+            result = makeNode(right->value, makeNode(value, left, share(right->left)), share(right->right));
+        }
+        else
+        {
+            const Node *inner = right->left;
+            result = makeNode(inner->value, makeNode(value, left, share(inner->left)),
+                              makeNode(right->value, share(inner->right), share(right->right)));
+        }
+        release(right);
+        return result;
+    }
+    return makeNode(value, left, right);
+}
+
+template <typename T, typename Compare>
+const typename PersistentTreeSet<T, Compare>::Node *PersistentTreeSet<T, Compare>::insertInto(const Node *node,
+                                                                                               const T &value) const
+{
+    //? Returns nullptr when the value is already there, so nothing is copied
+    if (!node)
+    {
+        return makeNode(value, nullptr, nullptr);
+    }
+    if (less(value, node->value))
+    {
+        const Node *left = insertInto(node->left, value);
+        return left ? balance(node->value, left, share(node->right)) : nullptr;
+    }
+    if (less(node->value, value))
+    {
+        const Node *right = insertInto(node->right, value);
+        return right ? balance(node->value, share(node->left), right) : nullptr;
+    }
+    return nullptr;
+}
+
+template <typename T, typename Compare>
+const typename PersistentTreeSet<T, Compare>::Node *PersistentTreeSet<T, Compare>::eraseMinimum(const Node *node)
+{
+    if (!node->left)
+    {
+        return share(node->right);
+    }
+    return balance(node->value, eraseMinimum(node->left), share(node->right));
+}
+
+template <typename T, typename Compare>
+const typename PersistentTreeSet<T, Compare>::Node *PersistentTreeSet<T, Compare>::eraseFrom(const Node *node,
+                                                                                              const T &value) const
+{
+    //? Returns node itself, without a new reference, when the value is not there, so nothing is copied
+    if (!node)
+    {
+        return nullptr;
+    }
+    if (less(value, node->value))
+    {
+        const Node *left = eraseFrom(node->left, value);
+        return left == node->left ? node : balance(node->value, left, share(node->right));
+    }
+    if (less(node->value, value))
+    {
+        const Node *right = eraseFrom(node->right, value);
+        return right == node->right ? node : balance(node->value, share(node->left), right);
+    }
+
+    if (!node->left || !node->right)
+    {
+        return share(node->left ? node->left : node->right);
+    }
+    //? Two children: the successor takes the erased value's place
+    const Node *successor = node->right;
+    while (successor->left)
+    {
+        successor = successor->left;
+    }
+    return balance(successor->value, share(node->left), eraseMinimum(node->right));
+}
+
+template <typename T, typename Compare> void PersistentTreeSet<T, Compare>::publish(const Node *newRoot)
+{
+    const Node *oldRoot = root.exchange(newRoot, std::memory_order_acq_rel);
+    if (oldRoot)
+    {
+        //? A reader may have loaded the old root and not counted its reference yet, so only drop ours once every
+        //? reader pinned now has moved on
+        EpochDomain::Guard guard = epochs.pin();
+        epochs.retire(const_cast<Node *>(oldRoot), &releaseRoot);
+    }
+}
+
+template <typename T, typename Compare> bool PersistentTreeSet<T, Compare>::insert(const T &value)
+{
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    const Node *newRoot = insertInto(root.load(std::memory_order_relaxed), value);
+    if (!newRoot)
+    {
+        return false;
+    }
+    publish(newRoot);
+    return true;
+}
+
+template <typename T, typename Compare> bool PersistentTreeSet<T, Compare>::erase(const T &value)
+{
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    const Node *current = root.load(std::memory_order_relaxed);
+    const Node *newRoot = eraseFrom(current, value);
+    if (newRoot == current)
+    {
+        return false;
+    }
+    publish(newRoot);
+    return true;
+}
+
+template <typename T, typename Compare>
+typename PersistentTreeSet<T, Compare>::Snapshot PersistentTreeSet<T, Compare>::snapshot() const
+{
+    EpochDomain::Guard guard = epochs.pin();
+    return Snapshot(share(root.load(std::memory_order_acquire)), this->comparator());
+}
+
+template <typename T, typename Compare> bool PersistentTreeSet<T, Compare>::contains(const T &value) const
+{
+    //? No reference needed: the pinned epoch keeps the version alive until the search is done
+    EpochDomain::Guard guard = epochs.pin();
+    const Node *node = root.load(std::memory_order_acquire);
+    const Node *candidate = nullptr;
+    while (node)
+    {
+        if (less(value, node->value))
+        {
+            node = node->left;
+        }
+        else
+        {
+            candidate = node;
+            node = node->right;
+        }
+    }
+    return candidate && !less(candidate->value, value);
+}
+
+template <typename T, typename Compare> size_t PersistentTreeSet<T, Compare>::size() const
+{
+    EpochDomain::Guard guard = epochs.pin();
+    return nodeSize(root.load(std::memory_order_acquire));
+}
+
+template <typename T, typename Compare> bool PersistentTreeSet<T, Compare>::Snapshot::contains(const T &value) const
+{
+    const Node *node = root;
+    const Node *candidate = nullptr;
+    while (node)
+    {
+        if (this->comparator()(value, node->value))
+        {
+            node = node->left;
+        }
+        else
+        {
+            candidate = node;
+            node = node->right;
+        }
+    }
+    return candidate && !this->comparator()(candidate->value, value);
+}
+
+template <typename T, typename Compare>
+template <typename Callback>
+bool PersistentTreeSet<T, Compare>::traverse(const Node *node, Callback &callback)
+{
+    if (!node)
+    {
+        return true;
+    }
+    if (!traverse(node->left, callback))
+    {
+        return false;
+    }
+    if constexpr (std::is_same_v<std::invoke_result_t<Callback &, const T &>, void>)
+    {
+        callback(node->value);
+    }
+    else if (!callback(node->value))
+    {
+        return false;
+    }
+    return traverse(node->right, callback);
+}
+
+} // namespace models
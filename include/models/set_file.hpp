@@ -0,0 +1,512 @@
+#pragma once
+
+#include "tree_policies.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace models
+{
+
+/**
+ * @brief The header at the start of a set file
+ *
+ * A set file holds the values of a set in sorted order, with no pointers, so it can be memory-mapped and searched in
+ * place. After the header come either
+ * - count fixed size keys of key_size bytes each, or
+ * - for strings (key_size 0): count + 1 uint64_t offsets into a string pool, then the pool_size bytes of the pool.
+ *   Value i is the pool bytes [offsets[i], offsets[i + 1])
+ *
+ * key_kind is a SetFileKeyKind, so keys of the same size but another kind (int and float, int64_t, uint64_t and
+ * double) are told apart. The header is 40 bytes, so the keys or offsets that follow it are 8-byte aligned in a
+ * mapping. Numbers are stored in the byte order of the writing machine, which byte_order records.
+ */
+struct SetFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t key_size;
+    uint32_t key_kind;
+    uint64_t count;
+    uint64_t pool_size;
+};
+static_assert(sizeof(SetFileHeader) == 40, "The set file header must have no padding");
+
+constexpr char set_file_magic[8] = {'T', 'R', 'E', 'E', 'S', 'E', 'T', '\0'};
+constexpr uint32_t set_file_version = 2;
+constexpr uint32_t set_file_byte_order = 0x01020304;
+
+/**
+ * @brief What kind of key a set file holds, checked along with the key size when it is opened
+ *
+ * Other trivially copyable types (structs, enums) are only known as Bytes, so for them only the size is checked.
+ */
+enum class SetFileKeyKind : uint32_t
+{
+    Bytes,
+    SignedInteger,
+    UnsignedInteger,
+    FloatingPoint,
+    String
+};
+
+/**
+ * @brief How values of type T are stored in a set file
+ *
+ * Trivially copyable types are stored as their bytes and read back as T. std::string is stored in a string pool and
+ * read back as std::string_view, pointing into the mapping.
+ */
+template <typename T, typename = void> struct SetFileKey;
+
+template <typename T> struct SetFileKey<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>
+{
+    static_assert(alignof(T) <= 8, "Keys in a set file are only 8-byte aligned");
+    using view_type = T;
+    static constexpr uint32_t key_size = sizeof(T);
+    static constexpr SetFileKeyKind key_kind = std::is_floating_point_v<T> ? SetFileKeyKind::FloatingPoint
+                                               : std::is_signed_v<T>       ? SetFileKeyKind::SignedInteger
+                                               : std::is_unsigned_v<T>     ? SetFileKeyKind::UnsignedInteger
+                                                                           : SetFileKeyKind::Bytes;
+};
+
+template <> struct SetFileKey<std::string>
+{
+    using view_type = std::string_view;
+    static constexpr uint32_t key_size = 0;
+    static constexpr SetFileKeyKind key_kind = SetFileKeyKind::String;
+};
+
+/**
+ * @brief A read-only memory mapping of a whole file
+ *
+ * The mapping is shared, so processes mapping the same file share its pages in the page cache. On platforms without
+ * mmap the file is read into memory instead.
+ */
+class MappedFile
+{
+  private:
+    const unsigned char *bytes;
+    size_t length;
+    std::vector<unsigned char> buffer; //? Holds the file where it cannot be mapped
+
+    void unmap();
+
+  public:
+    /**
+     * @brief Map a file
+     *
+     * @param path The file to map
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const unsigned char *data() const
+    {
+        return bytes;
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+};
+
+/**
+ * @brief Write sorted values to a set file
+ *
+ * @tparam T The type of the values, see SetFileKey
+ * @param path The file to create or overwrite
+ * @param count The number of values
+ * @param traverse Called with a callback, which it must call on each of the count values in order. Strings are
+ * traversed twice, once for their offsets and once for their bytes, so nothing is copied in memory
+ * @throws std::runtime_error if the file cannot be written
+ */
+template <typename T, typename Traverse> void writeSetFile(const std::string &path, size_t count, Traverse &&traverse)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        throw std::runtime_error("Cannot create set file " + path);
+    }
+
+    SetFileHeader header{};
+    std::memcpy(header.magic, set_file_magic, sizeof(header.magic));
+    header.version = set_file_version;
+    header.byte_order = set_file_byte_order;
+    header.key_size = SetFileKey<T>::key_size;
+    header.key_kind = static_cast<uint32_t>(SetFileKey<T>::key_kind);
+    header.count = count;
+
+    //? Values are collected in a buffer and written in large blocks, one stream write per value is several times
+    //? slower than walking the tree
+    std::vector<char> buffer;
+    buffer.reserve(1 << 16);
+    auto put = [&out, &buffer](const void *data, size_t size) {
+        if (buffer.size() + size > buffer.capacity())
+        {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+        if (size > buffer.capacity())
+        {
+            out.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+            return;
+        }
+        buffer.insert(buffer.end(), static_cast<const char *>(data), static_cast<const char *>(data) + size);
+    };
+
+    put(&header, sizeof(header));
+    if constexpr (SetFileKey<T>::key_size > 0)
+    {
+        traverse([&put](const T &value) { put(&value, sizeof(T)); });
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+    else
+    {
+        //? The pool size goes in the header, so it is patched once the offsets have been counted
+        uint64_t offset = 0;
+        put(&offset, sizeof(offset));
+        traverse([&put, &offset](const T &value) {
+            offset += value.size();
+            put(&offset, sizeof(offset));
+        });
+        traverse([&put](const T &value) { put(value.data(), value.size()); });
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+        header.pool_size = offset;
+        out.seekp(0);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+
+    out.flush();
+    if (!out)
+    {
+        throw std::runtime_error("Cannot write set file " + path);
+    }
+}
+
+/**
+ * @brief A sorted set queried in place from a memory-mapped set file, without deserializing it
+ *
+ * @tparam T The type of values the file was saved with, see SetFileKey
+ * @tparam Compare The ordering the file was saved in. Defaults to std::less<>
+ *
+ * Opening maps the file and checks its header, in constant time whatever the size of the set. Lookups binary search
+ * the mapped values, touching only the pages they need. Strings are returned as std::string_view into the mapping.
+ * The file must not be modified while it is mapped.
+ *
+ * Only the header, the file size it implies and, for strings, the first and last offsets are checked. The keys and
+ * the offsets between are trusted: a file corrupted there (unsorted keys, decreasing offsets) is not rejected, and
+ * reading it is undefined. Only map files written by save().
+ */
+template <typename T, typename Compare = std::less<>> class MappedSet : private CompareHolder<Compare>
+{
+  public:
+    using value_type = typename SetFileKey<T>::view_type;
+
+  private:
+    MappedFile file;
+    size_t count;
+    const unsigned char *keys;  //? The fixed size keys, or the string offsets
+    const char *pool;
+
+    template <typename A, typename B> bool less(const A &a, const B &b) const
+    {
+        return this->comparator()(a, b);
+    }
+
+  public:
+    /**
+     * @brief Random access iterator over the values, in order
+     */
+    class const_iterator
+    {
+      private:
+        const MappedSet *set;
+        size_t index;
+
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = typename MappedSet::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        const_iterator() : set(nullptr), index(0)
+        {
+        }
+        const_iterator(const MappedSet *set, size_t index) : set(set), index(index)
+        {
+        }
+
+        value_type operator*() const
+        {
+            return (*set)[index];
+        }
+        value_type operator[](difference_type offset) const
+        {
+            return (*set)[index + offset];
+        }
+        const_iterator &operator++()
+        {
+            ++index;
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator previous = *this;
+            ++index;
+            return previous;
+        }
+        const_iterator &operator--()
+        {
+            --index;
+            return *this;
+        }
+        const_iterator operator--(int)
+        {
+            const_iterator previous = *this;
+            --index;
+            return previous;
+        }
+        const_iterator &operator+=(difference_type offset)
+        {
+            index += offset;
+            return *this;
+        }
+        const_iterator &operator-=(difference_type offset)
+        {
+            index -= offset;
+            return *this;
+        }
+        friend const_iterator operator+(const_iterator it, difference_type offset)
+        {
+            return it += offset;
+        }
+        friend const_iterator operator+(difference_type offset, const_iterator it)
+        {
+            return it += offset;
+        }
+        friend const_iterator operator-(const_iterator it, difference_type offset)
+        {
+            return it -= offset;
+        }
+        friend difference_type operator-(const const_iterator &a, const const_iterator &b)
+        {
+            return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
+        }
+        friend bool operator==(const const_iterator &a, const const_iterator &b)
+        {
+            return a.index == b.index;
+        }
+        friend bool operator!=(const const_iterator &a, const const_iterator &b)
+        {
+            return a.index != b.index;
+        }
+        friend bool operator<(const const_iterator &a, const const_iterator &b)
+        {
+            return a.index < b.index;
+        }
+        friend bool operator>(const const_iterator &a, const const_iterator &b)
+        {
+            return a.index > b.index;
+        }
+        friend bool operator<=(const const_iterator &a, const const_iterator &b)
+        {
+            return a.index <= b.index;
+        }
+        friend bool operator>=(const const_iterator &a, const const_iterator &b)
+        {
+            return a.index >= b.index;
+        }
+    };
+
+    /**
+     * @brief Map a set file
+     *
+     * @param path A file written by writeSetFile or BinaryTreeSet::save with the same T and ordering
+     * @param compare The ordering the file was saved in
+     * @throws std::runtime_error if the file cannot be mapped, is not a set file, or holds another key type
+     */
+    explicit MappedSet(const std::string &path, const Compare &compare = Compare());
+
+    MappedSet(MappedSet &&) = default;
+    MappedSet &operator=(MappedSet &&) = default;
+
+    /**
+     * @brief Get the number of values
+     *
+     * @return size_t The number of values
+     */
+    size_t size() const
+    {
+        return count;
+    }
+
+    /**
+     * @brief Check if the set is empty
+     *
+     * @return true If size() is 0
+     */
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    /**
+     * @brief Get the value of rank i
+     *
+     * @param i The rank, below size()
+     * @return value_type The value, a view into the mapping for strings
+     */
+    value_type operator[](size_t i) const
+    {
+        if constexpr (SetFileKey<T>::key_size > 0)
+        {
+            return reinterpret_cast<const T *>(keys)[i];
+        }
+        else
+        {
+            const uint64_t *offsets = reinterpret_cast<const uint64_t *>(keys);
+            return std::string_view(pool + offsets[i], static_cast<size_t>(offsets[i + 1] - offsets[i]));
+        }
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, count);
+    }
+
+    /**
+     * @brief Find the first value not before the given one
+     *
+     * @param value The value to look for
+     * @return const_iterator The first value that is not before value, or end()
+     */
+    const_iterator lower_bound(const value_type &value) const
+    {
+        return std::lower_bound(begin(), end(), value,
+                                [this](const value_type &a, const value_type &b) { return less(a, b); });
+    }
+
+    /**
+     * @brief Check if a value is in the set
+     *
+     * @param value The value to check for
+     * @return true If the value is in the set
+     * @return false Otherwise
+     */
+    bool contains(const value_type &value) const
+    {
+        const const_iterator found = lower_bound(value);
+        return found != end() && !less(value, *found);
+    }
+
+    /**
+     * @brief Count the values before the given one
+     *
+     * @param value The value to rank
+     * @return size_t The number of values in the set that are before value
+     */
+    size_t rank(const value_type &value) const
+    {
+        return static_cast<size_t>(lower_bound(value) - begin());
+    }
+
+    /**
+     * @brief Visit the values in order
+     *
+     * @param callback Called with each value. If it returns bool, returning false stops the traversal
+     * @return true If every value was visited, false if the callback stopped early
+     */
+    template <typename Callback> bool traverseInorder(Callback &&callback) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if constexpr (std::is_same_v<std::invoke_result_t<Callback &, value_type>, void>)
+            {
+                callback((*this)[i]);
+            }
+            else if (!callback((*this)[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template <typename T, typename Compare>
+MappedSet<T, Compare>::MappedSet(const std::string &path, const Compare &compare)
+    : CompareHolder<Compare>(compare), file(path), count(0), keys(nullptr), pool(nullptr)
+{
+    SetFileHeader header;
+    if (file.size() < sizeof(header))
+    {
+        throw std::runtime_error("Not a set file: " + path);
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, set_file_magic, sizeof(header.magic)) != 0 || header.version != set_file_version)
+    {
+        throw std::runtime_error("Not a set file: " + path);
+    }
+    if (header.byte_order != set_file_byte_order)
+    {
+        throw std::runtime_error("Set file written with another byte order: " + path);
+    }
+    if (header.key_size != SetFileKey<T>::key_size ||
+        header.key_kind != static_cast<uint32_t>(SetFileKey<T>::key_kind))
+    {
+        throw std::runtime_error("Set file holds another key type: " + path);
+    }
+
+    const size_t payload = file.size() - sizeof(header);
+    keys = file.data() + sizeof(header);
+    if constexpr (SetFileKey<T>::key_size > 0)
+    {
+        if (header.count > payload / sizeof(T) || header.count * sizeof(T) != payload)
+        {
+            throw std::runtime_error("Set file is truncated or corrupt: " + path);
+        }
+    }
+    else
+    {
+        //? count + 1 offsets fit in the payload, so neither the product nor the subtraction can wrap
+        const uint64_t offsetsSize = (header.count + 1) * sizeof(uint64_t);
+        if (header.count >= payload / sizeof(uint64_t) || header.pool_size != payload - offsetsSize)
+        {
+            throw std::runtime_error("Set file is truncated or corrupt: " + path);
+        }
+        const uint64_t *offsets = reinterpret_cast<const uint64_t *>(keys);
+        if (offsets[0] != 0 || offsets[header.count] != header.pool_size)
+        {
+            throw std::runtime_error("Set file is truncated or corrupt: " + path);
+        }
+        pool = reinterpret_cast<const char *>(keys + offsetsSize);
+    }
+    count = static_cast<size_t>(header.count);
+}
+
+} // namespace models
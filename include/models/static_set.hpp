@@ -0,0 +1,472 @@
+#pragma once
+
+#include "tree_policies.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace models
+{
+
+/**
+ * @brief Hint the CPU to start loading the cache line holding address, without waiting for it
+ *
+ * @param address Any address, it is never dereferenced, so it may point past the end of an array
+ */
+inline void prefetchRead(const void *address)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#else
+    (void)address;
+#endif
+}
+
+/**
+ * @brief Allocates arrays aligned to a 64-byte cache line
+ */
+template <typename T> struct CacheLineAllocator
+{
+    using value_type = T;
+    static constexpr std::align_val_t alignment{64};
+
+    CacheLineAllocator() = default;
+    template <typename U> CacheLineAllocator(const CacheLineAllocator<U> &)
+    {
+    }
+
+    T *allocate(size_t count)
+    {
+        return static_cast<T *>(::operator new(count * sizeof(T), alignment));
+    }
+
+    void deallocate(T *pointer, size_t)
+    {
+        ::operator delete(pointer, alignment);
+    }
+
+    template <typename U> bool operator==(const CacheLineAllocator<U> &) const
+    {
+        return true;
+    }
+    template <typename U> bool operator!=(const CacheLineAllocator<U> &) const
+    {
+        return false;
+    }
+};
+
+/**
+ * @brief An immutable ordered set laid out for fast searches, built once and then queried
+ *
+ * @tparam T The type of values stored in the set, any default constructible type the comparator can order
+ * @tparam Compare A strict weak ordering on T, as for BinaryTreeSet. Defaults to std::less<>
+ *
+ * The values are stored in Eytzinger order: the implicit complete binary search tree is written level by level into
+ * one array, with the root at index 1 and the children of index k at 2k and 2k + 1. There are no pointers, and the
+ * top levels every search walks through share a few cache lines.
+ *
+ * A search step is k = 2k + (value at k is before the key), which compiles to a conditional add instead of a
+ * branch, so it never mispredicts. The 16 descendants four levels below k are consecutive and fill one cache line
+ * for 4-byte keys, and each step prefetches them, so the memory latency of the next four levels overlaps with the
+ * comparisons of this one. Larger values prefetch fewer levels ahead, as fewer descendants fit in a line. When the
+ * walk falls off the bottom, the empty slot it ends in encodes the answer: the last node where it turned left is the
+ * lower bound, and the slot's position among all empty slots is the rank.
+ *
+ * Built by BinaryTreeSet::freeze() or fromSorted().
+ */
+template <typename T, typename Compare = std::less<>> class StaticSet : private CompareHolder<Compare>
+{
+  private:
+    std::vector<T, CacheLineAllocator<T>> values; //? values[0] is unused, the tree is values[1..count]
+    size_t count;
+
+    template <typename A, typename B> bool less(const A &a, const B &b) const
+    {
+        return this->comparator()(a, b);
+    }
+
+    //
+    //! SECTION Eytzinger index arithmetic
+    //
+
+    static int floorLog2(size_t k)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(static_cast<unsigned long long>(k));
+#else
+        int log = 0;
+        while (k >>= 1)
+        {
+            ++log;
+        }
+        return log;
+#endif
+    }
+
+    static int trailingOnes(size_t k)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(~static_cast<unsigned long long>(k));
+#else
+        int ones = 0;
+        while (k & 1)
+        {
+            k >>= 1;
+            ++ones;
+        }
+        return ones;
+#endif
+    }
+
+    //? The index of the first value in order, or 0 when empty
+    size_t firstIndex() const
+    {
+        size_t k = count == 0 ? 0 : 1;
+        while (k != 0 && 2 * k <= count)
+        {
+            k = 2 * k;
+        }
+        return k;
+    }
+
+    size_t lastIndex() const
+    {
+        size_t k = count == 0 ? 0 : 1;
+        while (k != 0 && 2 * k + 1 <= count)
+        {
+            k = 2 * k + 1;
+        }
+        return k;
+    }
+
+    //? The index of the next value in order, or 0 after the last one
+    size_t nextIndex(size_t k) const
+    {
+        if (2 * k + 1 <= count)
+        {
+            k = 2 * k + 1;
+            while (2 * k <= count)
+            {
+                k = 2 * k;
+            }
+            return k;
+        }
+        //? Climb while k is a right child, then once more to the parent it is the left subtree of
+        return k >> (trailingOnes(k) + 1);
+    }
+
+    //? The index of the previous value in order, or 0 before the first one
+    size_t previousIndex(size_t k) const
+    {
+        if (k == 0)
+        {
+            return lastIndex();
+        }
+        if (2 * k <= count)
+        {
+            k = 2 * k;
+            while (2 * k + 1 <= count)
+            {
+                k = 2 * k + 1;
+            }
+            return k;
+        }
+        //? Climb while k is a left child, then once more to the parent it is the right subtree of
+        while (k != 0 && (k & 1) == 0)
+        {
+            k >>= 1;
+        }
+        return k >> 1;
+    }
+
+    //? Walks down to the empty child slot the key falls into, count < result <= 2 * count + 1
+    template <typename Key> size_t descend(const Key &key) const
+    {
+        //? Prefetch the descendants that share one cache line with the leftmost: 16 of them four levels down for
+        //? 4-byte values, 8 three levels down for 8-byte values, 2 one level down for a 32-byte std::string
+        constexpr size_t lookahead = sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+        const T *base = values.data();
+        size_t k = 1;
+        while (k <= count)
+        {
+            prefetchRead(base + lookahead * k);
+            k = 2 * k + static_cast<size_t>(less(base[k], key));
+        }
+        return k;
+    }
+
+    //? The last node where the walk turned left, found by stripping the trailing right turns, 0 if it never did
+    template <typename Key> size_t lowerBoundIndex(const Key &key) const
+    {
+        const size_t k = descend(key);
+        return k >> (trailingOnes(k) + 1);
+    }
+
+    //? Empty child slots are the gaps between consecutive values, so the slot the walk ends in gives the rank. The
+    //? children of the partial bottom level (depth + 1) come first in order, then the slots beside it (depth)
+    template <typename Key> size_t rankOf(const Key &key) const
+    {
+        if (count == 0)
+        {
+            return 0;
+        }
+        const size_t k = descend(key);
+        const int depth = floorLog2(count);
+        const size_t bottom = count - ((size_t(1) << depth) - 1); //? Values on the bottom level
+        if (k >= (size_t(2) << depth))
+        {
+            return k - (size_t(2) << depth);
+        }
+        return k - (size_t(1) << depth) + bottom;
+    }
+
+    template <typename Traverse> void fill(Traverse &&traverse);
+
+  public:
+    /**
+     * @brief Bidirectional iterator over the values, in order
+     */
+    class const_iterator
+    {
+      private:
+        const StaticSet *set;
+        size_t index; //? 0 is end()
+
+        const_iterator(const StaticSet *set, size_t index) : set(set), index(index)
+        {
+        }
+        friend class StaticSet;
+
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() : set(nullptr), index(0)
+        {
+        }
+
+        const T &operator*() const
+        {
+            return set->values[index];
+        }
+        const T *operator->() const
+        {
+            return &set->values[index];
+        }
+        const_iterator &operator++()
+        {
+            index = set->nextIndex(index);
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        const_iterator &operator--()
+        {
+            index = set->previousIndex(index);
+            return *this;
+        }
+        const_iterator operator--(int)
+        {
+            const_iterator previous = *this;
+            --*this;
+            return previous;
+        }
+        friend bool operator==(const const_iterator &a, const const_iterator &b)
+        {
+            return a.index == b.index;
+        }
+        friend bool operator!=(const const_iterator &a, const const_iterator &b)
+        {
+            return a.index != b.index;
+        }
+    };
+    using iterator = const_iterator;
+
+    //
+    //! SECTION Construction
+    //
+
+    /**
+     * @brief Create an empty set
+     */
+    explicit StaticSet(const Compare &compare = Compare()) : CompareHolder<Compare>(compare), count(0)
+    {
+    }
+
+    /**
+     * @brief Build a set from values visited in order
+     *
+     * @param size The number of values
+     * @param traverse Called with a callback, which it must call on each of the size values, in increasing order
+     * without duplicates
+     * @param compare The comparator of the new set
+     *
+     * Used by BinaryTreeSet::freeze(), which passes its inorder traversal, so no sorted copy is made in between.
+     */
+    template <typename Traverse>
+    StaticSet(size_t size, Traverse &&traverse, const Compare &compare = Compare())
+        : CompareHolder<Compare>(compare), values(size + 1), count(size)
+    {
+        fill(traverse);
+    }
+
+    /**
+     * @brief Build a set from a range of values
+     *
+     * @param first The beginning of the range
+     * @param last The end of the range
+     * @param compare The comparator of the new set
+     * @return StaticSet A set holding every distinct value of the range
+     *
+     * Unsorted ranges are sorted first, duplicates are dropped.
+     */
+    template <typename InputIt>
+    static StaticSet fromSorted(InputIt first, InputIt last, const Compare &compare = Compare())
+    {
+        std::vector<T> sorted(first, last);
+        if (!std::is_sorted(sorted.begin(), sorted.end(), compare))
+        {
+            std::sort(sorted.begin(), sorted.end(), compare);
+        }
+        sorted.erase(std::unique(sorted.begin(), sorted.end(),
+                                 [&compare](const T &left, const T &right) { return !compare(left, right); }),
+                     sorted.end());
+        return StaticSet(
+            sorted.size(),
+            [&sorted](auto &&callback) {
+                for (const T &value : sorted)
+                {
+                    callback(value);
+                }
+            },
+            compare);
+    }
+
+    //
+    //! SECTION Queries
+    //
+
+    /**
+     * @brief Get a copy of the comparator
+     *
+     * @return Compare The comparator ordering the set
+     */
+    Compare key_comp() const
+    {
+        return this->comparator();
+    }
+
+    /**
+     * @brief Get the number of values
+     *
+     * @return size_t The number of values
+     */
+    size_t size() const
+    {
+        return count;
+    }
+
+    /**
+     * @brief Check if the set is empty
+     *
+     * @return true If size() is 0
+     */
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, firstIndex());
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    /**
+     * @brief Find the first value that is not before the key
+     *
+     * @param key The value, or with a transparent comparator any key comparable with T
+     * @return const_iterator The first value not before key, or end()
+     */
+    template <typename Key> const_iterator lower_bound(const Key &key) const
+    {
+        return const_iterator(this, lowerBoundIndex(key));
+    }
+
+    /**
+     * @brief Check if a value is in the set
+     *
+     * @param key The value, or with a transparent comparator any key comparable with T
+     * @return true If the value is in the set
+     * @return false Otherwise
+     */
+    template <typename Key> bool contains(const Key &key) const
+    {
+        const size_t k = lowerBoundIndex(key);
+        return k != 0 && !less(key, values[k]);
+    }
+
+    /**
+     * @brief Count the values before the key
+     *
+     * @param key The value, or with a transparent comparator any key comparable with T
+     * @return size_t The number of values in the set that are before key, at the cost of a contains()
+     */
+    template <typename Key> size_t rank(const Key &key) const
+    {
+        return rankOf(key);
+    }
+
+    /**
+     * @brief Visit the values in order
+     *
+     * @param callback Called with each value. If it returns bool, returning false stops the traversal
+     * @return true If every value was visited, false if the callback stopped early
+     */
+    template <typename Callback> bool traverseInorder(Callback &&callback) const
+    {
+        for (size_t k = firstIndex(); k != 0; k = nextIndex(k))
+        {
+            if constexpr (std::is_same_v<std::invoke_result_t<Callback &, const T &>, void>)
+            {
+                callback(values[k]);
+            }
+            else if (!callback(values[k]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template <typename T, typename Compare>
+template <typename Traverse>
+void StaticSet<T, Compare>::fill(Traverse &&traverse)
+{
+    //? Walking the indices in order while the values arrive in order puts every value in its Eytzinger slot
+    size_t k = firstIndex();
+    traverse([this, &k](const T &value) {
+        values[k] = value;
+        k = nextIndex(k);
+    });
+}
+
+} // namespace models
@@ -0,0 +1,423 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace models
+{
+
+/**
+ * @brief Node counts and key bytes of a StringSet, see StringSet::stats()
+ */
+struct StringSetStats
+{
+    size_t leaves = 0;
+    size_t node4 = 0;
+    size_t node16 = 0;
+    size_t node48 = 0;
+    size_t node256 = 0;
+    size_t prefix_bytes = 0; //? Bytes of compressed paths stored in inner nodes
+    size_t suffix_bytes = 0; //? Bytes of key tails stored in leaves
+};
+
+/**
+ * @brief An ordered set of strings stored in an adaptive radix tree (ART)
+ *
+ * A string is looked up one byte at a time: every inner node branches on the next byte of the key, so a lookup costs
+ * O(key length) whatever the number of strings, and compares no string twice. Inner nodes come in four sizes and
+ * grow or shrink with their number of children:
+ * - Node4 and Node16: up to 4 or 16 sorted key bytes beside their children, Node16 is searched with one SSE2 compare
+ * - Node48: a 256-entry byte index into 48 children
+ * - Node256: a child pointer for every byte
+ *
+ * Paths are compressed: an inner node stores the bytes every key below it shares (its prefix) once, and a key that
+ * is alone in its subtree is a leaf holding only the rest of its bytes. Bytes above a node are never stored again
+ * below it. A key that ends where an inner node branches, like "ab" beside "abc" and "abd", is a flag on that node.
+ *
+ * Strings are ordered by unsigned bytes, the same order as std::less<std::string>, and may hold any bytes, including
+ * '\0'. Traversals rebuild each string in one buffer and pass it to the callback by const reference, so the
+ * reference is only valid during the call. Nothing recurses: traversals keep an explicit stack, and insert and erase
+ * walk down with a pointer to the link they may have to replace.
+ */
+class StringSet
+{
+  private:
+    enum class Kind : uint8_t
+    {
+        Leaf,
+        Node4,
+        Node16,
+        Node48,
+        Node256
+    };
+
+    struct Header
+    {
+        Kind kind;
+        explicit Header(Kind kind) : kind(kind)
+        {
+        }
+    };
+
+    struct Leaf : Header
+    {
+        std::string suffix; //? The bytes of the key after the byte that leads to this leaf
+        explicit Leaf(std::string_view suffix) : Header(Kind::Leaf), suffix(suffix)
+        {
+        }
+    };
+
+    struct Inner : Header
+    {
+        bool terminal;      //? A key ends right after prefix
+        uint16_t count;     //? Number of children
+        std::string prefix; //? Bytes shared by every key below, after the byte that leads to this node
+        Inner(Kind kind, std::string_view prefix) : Header(kind), terminal(false), count(0), prefix(prefix)
+        {
+        }
+    };
+
+    struct Node4 : Inner
+    {
+        uint8_t keys[4];
+        Header *children[4];
+        explicit Node4(std::string_view prefix) : Inner(Kind::Node4, prefix)
+        {
+        }
+    };
+
+    struct Node16 : Inner
+    {
+        uint8_t keys[16];
+        Header *children[16];
+        explicit Node16(std::string_view prefix) : Inner(Kind::Node16, prefix)
+        {
+        }
+    };
+
+    struct Node48 : Inner
+    {
+        uint8_t index[256]; //? 0 for no child, otherwise the child's slot + 1
+        Header *children[48];
+        explicit Node48(std::string_view prefix) : Inner(Kind::Node48, prefix), index()
+        {
+        }
+    };
+
+    struct Node256 : Inner
+    {
+        Header *children[256];
+        explicit Node256(std::string_view prefix) : Inner(Kind::Node256, prefix), children()
+        {
+        }
+    };
+
+    Header *root;
+    size_t set_size;
+
+    //
+    //! SECTION Node helpers
+    //
+
+    static Header *const *findChild(const Inner *node, uint8_t byte);
+    static Header **findChild(Inner *node, uint8_t byte);
+    static void addChild(Header **link, Inner *node, uint8_t byte, Header *child);
+    static void removeChild(Header **link, Inner *node, uint8_t byte);
+    static void collapse(Header **link, Inner *node);
+    static void destroy(Header *node);
+    static void destroyTree(Header *node);
+
+    //? The child following position in byte order, or nullptr after the last one. position starts at 0
+    static const Header *nextChild(const Inner *node, int &position, uint8_t &byte)
+    {
+        switch (node->kind)
+        {
+        case Kind::Node4:
+        case Kind::Node16: {
+            const bool small = node->kind == Kind::Node4;
+            const uint8_t *keys =
+                small ? static_cast<const Node4 *>(node)->keys : static_cast<const Node16 *>(node)->keys;
+            Header *const *children =
+                small ? static_cast<const Node4 *>(node)->children : static_cast<const Node16 *>(node)->children;
+            if (position < node->count)
+            {
+                byte = keys[position];
+                return children[position++];
+            }
+            return nullptr;
+        }
+        case Kind::Node48: {
+            const auto *wide = static_cast<const Node48 *>(node);
+            while (position < 256)
+            {
+                const int current = position++;
+                if (wide->index[current])
+                {
+                    byte = static_cast<uint8_t>(current);
+                    return wide->children[wide->index[current] - 1];
+                }
+            }
+            return nullptr;
+        }
+        default: {
+            const auto *full = static_cast<const Node256 *>(node);
+            while (position < 256)
+            {
+                const int current = position++;
+                if (full->children[current])
+                {
+                    byte = static_cast<uint8_t>(current);
+                    return full->children[current];
+                }
+            }
+            return nullptr;
+        }
+        }
+    }
+
+    template <typename Callback> static bool emit(Callback &callback, const std::string &key)
+    {
+        if constexpr (std::is_same_v<std::invoke_result_t<Callback &, const std::string &>, void>)
+        {
+            callback(key);
+            return true;
+        }
+        else
+        {
+            return callback(key);
+        }
+    }
+
+    //? Visits the keys below node in order. key holds the bytes above node, and is restored before returning
+    template <typename Callback> static bool visitSubtree(const Header *node, std::string &key, Callback &callback);
+
+  public:
+    //
+    //! SECTION Construction
+    //
+
+    /**
+     * @brief Create an empty set
+     */
+    StringSet() : root(nullptr), set_size(0)
+    {
+    }
+
+    ~StringSet();
+
+    StringSet(const StringSet &) = delete;
+    StringSet &operator=(const StringSet &) = delete;
+
+    /**
+     * @brief Move constructor, other is left empty
+     */
+    StringSet(StringSet &&other) noexcept;
+
+    /**
+     * @brief Move assignment, the current strings are destroyed and other is left empty
+     */
+    StringSet &operator=(StringSet &&other) noexcept;
+
+    //
+    //! SECTION Queries
+    //
+
+    /**
+     * @brief Get the number of strings
+     *
+     * @return size_t The number of strings
+     */
+    size_t size() const
+    {
+        return set_size;
+    }
+
+    /**
+     * @brief Check if the set is empty
+     *
+     * @return true If size() is 0
+     */
+    bool empty() const
+    {
+        return set_size == 0;
+    }
+
+    /**
+     * @brief Check if a string is in the set
+     *
+     * @param key The string to look for
+     * @return true If the string is in the set
+     */
+    bool contains(std::string_view key) const;
+
+    /**
+     * @brief Count the nodes of each kind and the key bytes they store, in one walk over the tree
+     *
+     * @return StringSetStats The counts
+     */
+    StringSetStats stats() const;
+
+    /**
+     * @brief Visit the strings in order
+     *
+     * @param callback Called with each string, valid during the call only. If it returns bool, returning false stops
+     * the traversal
+     * @return true If every string was visited, false if the callback stopped early
+     */
+    template <typename Callback> bool traverseInorder(Callback &&callback) const
+    {
+        std::string key;
+        return visitSubtree(root, key, callback);
+    }
+
+    /**
+     * @brief Visit the strings starting with a prefix, in order
+     *
+     * @param prefix The prefix, an empty prefix visits every string
+     * @param callback Called with each matching string, as for traverseInorder
+     * @return true If every match was visited, false if the callback stopped early
+     *
+     * Walks down to the subtree the prefix leads to in O(prefix length), then visits that subtree only.
+     */
+    template <typename Callback> bool prefixScan(std::string_view prefix, Callback &&callback) const;
+
+    //
+    //! SECTION Modification
+    //
+
+    /**
+     * @brief Insert a string, unless it is already in the set
+     *
+     * @param key The string to insert
+     * @return true If the string was inserted
+     */
+    bool insert(std::string_view key);
+
+    /**
+     * @brief Remove a string
+     *
+     * @param key The string to remove
+     * @return true If the string was in the set
+     *
+     * Nodes left with few children shrink to a smaller kind, and a node left with a single entry is merged into it,
+     * so the tree looks as if the string had never been inserted.
+     */
+    bool erase(std::string_view key);
+
+    /**
+     * @brief Remove every string
+     */
+    void clear();
+};
+
+//
+//? Implementation
+//
+
+template <typename Callback>
+bool StringSet::visitSubtree(const Header *node, std::string &key, Callback &callback)
+{
+    if (!node)
+    {
+        return true;
+    }
+    const size_t base = key.size();
+    if (node->kind == Kind::Leaf)
+    {
+        key += static_cast<const Leaf *>(node)->suffix;
+        const bool more = emit(callback, key);
+        key.resize(base);
+        return more;
+    }
+
+    struct Frame
+    {
+        const Inner *node;
+        int position;     //? -1 until the node's own key (terminal) has been visited
+        size_t keyLength; //? Length of key up to and including node's prefix
+    };
+    std::vector<Frame> stack;
+    key += static_cast<const Inner *>(node)->prefix;
+    stack.push_back({static_cast<const Inner *>(node), -1, key.size()});
+    bool more = true;
+    while (more && !stack.empty())
+    {
+        Frame &frame = stack.back();
+        key.resize(frame.keyLength);
+        if (frame.position < 0)
+        {
+            frame.position = 0;
+            if (frame.node->terminal)
+            {
+                more = emit(callback, key);
+            }
+            continue;
+        }
+
+        uint8_t byte = 0;
+        const Header *child = nextChild(frame.node, frame.position, byte);
+        if (!child)
+        {
+            stack.pop_back();
+            continue;
+        }
+        key.push_back(static_cast<char>(byte));
+        if (child->kind == Kind::Leaf)
+        {
+            key += static_cast<const Leaf *>(child)->suffix;
+            more = emit(callback, key);
+        }
+        else
+        {
+            key += static_cast<const Inner *>(child)->prefix;
+            stack.push_back({static_cast<const Inner *>(child), -1, key.size()});
+        }
+    }
+    key.resize(base);
+    return more;
+}
+
+template <typename Callback> bool StringSet::prefixScan(std::string_view prefix, Callback &&callback) const
+{
+    std::string key;
+    const Header *node = root;
+    size_t depth = 0; //? Bytes of prefix matched so far, key holds them
+    while (node)
+    {
+        const std::string_view rest = prefix.substr(depth);
+        const std::string &stored = node->kind == Kind::Leaf ? static_cast<const Leaf *>(node)->suffix
+                                                             : static_cast<const Inner *>(node)->prefix;
+        const size_t shared = std::min(stored.size(), rest.size());
+        if (std::string_view(stored).substr(0, shared) != rest.substr(0, shared))
+        {
+            return true;
+        }
+        //? The prefix ends inside this node's bytes: every key below matches. A leaf ends here either way
+        if (rest.size() <= stored.size() || node->kind == Kind::Leaf)
+        {
+            return rest.size() > stored.size() || visitSubtree(node, key, callback);
+        }
+
+        const auto *inner = static_cast<const Inner *>(node);
+        key += inner->prefix;
+        depth += inner->prefix.size();
+        const auto byte = static_cast<uint8_t>(prefix[depth]);
+        Header *const *child = findChild(inner, byte);
+        if (!child)
+        {
+            return true;
+        }
+        key.push_back(static_cast<char>(byte));
+        depth++;
+        node = *child;
+    }
+    return true;
+}
+
+} // namespace models
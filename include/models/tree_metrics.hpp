@@ -0,0 +1,360 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace models
+{
+
+/**
+ * @brief The operations a metrics policy records separately
+ */
+enum class TreeOperation : uint8_t
+{
+    Insert,
+    Erase,
+    Contains,
+    Find
+};
+
+constexpr size_t tree_operation_count = 4;
+
+/**
+ * @brief Lower case name of an operation, for labelling exported metrics
+ */
+const char *treeOperationName(TreeOperation operation);
+
+/**
+ * @brief A high dynamic range (HDR) histogram of latencies in nanoseconds
+ *
+ * Values below 128 ns have a bucket each. Above that every power of two is split into 64 equal buckets, so a bucket
+ * is never wider than 1/64 of the values it holds and percentiles are accurate to within 1.6% (two significant
+ * digits), at a fixed 1984 counters from 0 ns up to 2^36 ns (68 s). Larger values are counted in the last bucket.
+ */
+class LatencyHistogram
+{
+  private:
+    static constexpr int sub_bucket_bits = 6; //? 64 buckets per power of two
+    static constexpr int max_value_bits = 36;
+
+    std::vector<uint64_t> counts;
+    uint64_t total;
+    uint64_t sum;
+    uint64_t minimum;
+    uint64_t maximum;
+
+    //? index = shift * 64 + (value >> shift), where shift makes value >> shift fit in 7 bits
+    static size_t bucketIndex(uint64_t value)
+    {
+        const int bits = value == 0 ? 0 : 64 - __builtin_clzll(value);
+        const int shift = bits > sub_bucket_bits + 1 ? bits - sub_bucket_bits - 1 : 0;
+        return (static_cast<size_t>(shift) << sub_bucket_bits) + static_cast<size_t>(value >> shift);
+    }
+
+    static uint64_t bucketLowest(size_t index);
+    static uint64_t bucketHighest(size_t index);
+
+  public:
+    static constexpr uint64_t highest_trackable = (uint64_t(1) << max_value_bits) - 1;
+    static constexpr size_t bucket_count = static_cast<size_t>(max_value_bits - sub_bucket_bits + 1) << sub_bucket_bits;
+
+    LatencyHistogram();
+
+    /**
+     * @brief Count one value
+     *
+     * @param nanoseconds The value, clamped to highest_trackable
+     */
+    void record(uint64_t nanoseconds)
+    {
+        const uint64_t value = nanoseconds < highest_trackable ? nanoseconds : highest_trackable;
+        counts[bucketIndex(value)]++;
+        total++;
+        sum += value;
+        minimum = value < minimum ? value : minimum;
+        maximum = value > maximum ? value : maximum;
+    }
+
+    /**
+     * @brief Add the counts of another histogram to this one
+     */
+    void merge(const LatencyHistogram &other);
+
+    void reset();
+
+    uint64_t count() const
+    {
+        return total;
+    }
+
+    /**
+     * @brief The smallest value recorded, 0 if there are none
+     */
+    uint64_t min() const
+    {
+        return total == 0 ? 0 : minimum;
+    }
+
+    uint64_t max() const
+    {
+        return maximum;
+    }
+
+    double mean() const
+    {
+        return total == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(total);
+    }
+
+    /**
+     * @brief The value below or at which a given percentage of the recorded values fall
+     *
+     * @param percentile Between 0 and 100, e.g. 99.9
+     * @return uint64_t The highest value of the bucket holding that percentile, at most max(); 0 if empty
+     */
+    uint64_t valueAtPercentile(double percentile) const;
+
+    /**
+     * @brief Visit the non-empty buckets in increasing order, for exporting the whole distribution
+     *
+     * @param callback Called as callback(lowest, highest, count) with the range of values of a bucket and its count
+     */
+    template <typename Callback> void forEachBucket(Callback &&callback) const
+    {
+        for (size_t index = 0; index < counts.size(); ++index)
+        {
+            if (counts[index] != 0)
+            {
+                callback(bucketLowest(index), bucketHighest(index), counts[index]);
+            }
+        }
+    }
+};
+
+/**
+ * @brief What a metrics policy recorded for one kind of operation
+ *
+ * - count: Number of operations
+ * - comparisons: Calls to the comparator, divide by count for the average per operation
+ * - nodes_visited: Nodes the operations stepped through on their way down, including an erase's walk to the
+ *   successor
+ * - allocations, deallocations: Nodes created and destroyed
+ * - rotations: Single rotations, from rebalancing or splaying
+ * - depth: depth[d] operations visited d nodes, the last bucket counts every deeper one
+ * - latency: Wall clock time of each operation in nanoseconds
+ */
+struct OperationStats
+{
+    static constexpr size_t depth_buckets = 64;
+
+    uint64_t count = 0;
+    uint64_t comparisons = 0;
+    uint64_t nodes_visited = 0;
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t rotations = 0;
+    std::array<uint64_t, depth_buckets> depth{};
+    LatencyHistogram latency;
+};
+
+/**
+ * @brief A copy of the metrics of a set at one point in time, see TreeMetrics::snapshot()
+ */
+struct TreeMetricsSnapshot
+{
+    std::array<OperationStats, tree_operation_count> operations;
+
+    const OperationStats &operator[](TreeOperation operation) const
+    {
+        return operations[static_cast<size_t>(operation)];
+    }
+};
+
+/**
+ * @brief Metrics policy that records nothing (default of BinaryTreeSet)
+ *
+ * Every hook is compiled out, and the set does not store it, so a set without metrics has the same size and code as
+ * before metrics existed.
+ */
+struct NoMetrics
+{
+    static constexpr bool enabled = false;
+
+    void beginOperation()
+    {
+    }
+    void endOperation(TreeOperation)
+    {
+    }
+    void comparison()
+    {
+    }
+    void visit()
+    {
+    }
+    void allocation()
+    {
+    }
+    void deallocation()
+    {
+    }
+    void rotation()
+    {
+    }
+};
+
+/**
+ * @brief Metrics policy recording per-operation counters, a depth histogram and a latency histogram
+ *
+ * BinaryTreeSet calls the hooks below from insert, erase, contains and find: beginOperation() when one starts,
+ * the counting hooks while it runs, and endOperation() when it returns, which adds the counts to the totals of that
+ * kind of operation. Comparisons and rotations made by other members (set algebra, bulk loading) are not recorded.
+ *
+ * Lookups record into the set they read, so even const lookups of a set with metrics must not run concurrently.
+ */
+class TreeMetrics
+{
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    TreeMetricsSnapshot totals;
+    Clock::time_point started;
+    uint64_t comparisons = 0;
+    uint64_t visited = 0;
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t rotations = 0;
+
+  public:
+    static constexpr bool enabled = true;
+
+    //
+    //! SECTION Hooks
+    //
+
+    void beginOperation()
+    {
+        comparisons = visited = allocations = deallocations = rotations = 0;
+        started = Clock::now();
+    }
+
+    void endOperation(TreeOperation operation);
+
+    void comparison()
+    {
+        comparisons++;
+    }
+
+    void visit()
+    {
+        visited++;
+    }
+
+    void allocation()
+    {
+        allocations++;
+    }
+
+    void deallocation()
+    {
+        deallocations++;
+    }
+
+    void rotation()
+    {
+        rotations++;
+    }
+
+    //
+    //! SECTION Reading
+    //
+
+    /**
+     * @brief Copy the totals recorded so far
+     *
+     * @return TreeMetricsSnapshot The totals, unaffected by later operations
+     */
+    TreeMetricsSnapshot snapshot() const
+    {
+        return totals;
+    }
+
+    /**
+     * @brief Forget everything recorded so far, e.g. after exporting a snapshot
+     */
+    void reset();
+};
+
+/**
+ * @brief Holds the metrics policy of a set, taking no space for a disabled one
+ *
+ * The state is mutable, because const lookups record into it too.
+ */
+template <typename Metrics, bool = Metrics::enabled> class MetricsHolder
+{
+  private:
+    mutable Metrics state;
+
+  public:
+    MetricsHolder() = default;
+
+    //? A moved-from set starts recording from scratch
+    MetricsHolder(MetricsHolder &&other) noexcept : state(std::move(other.state))
+    {
+        other.state = Metrics();
+    }
+
+    MetricsHolder &operator=(MetricsHolder &&other) noexcept
+    {
+        state = std::move(other.state);
+        other.state = Metrics();
+        return *this;
+    }
+
+    Metrics &metricsState() const
+    {
+        return state;
+    }
+};
+
+//? Disabled policies have no state, so every set shares one instance and its empty hooks compile to nothing
+template <typename Metrics> class MetricsHolder<Metrics, false>
+{
+  private:
+    static inline Metrics state{};
+
+  public:
+    Metrics &metricsState() const
+    {
+        return state;
+    }
+};
+
+/**
+ * @brief Brackets one operation: calls beginOperation() on construction and endOperation() on destruction
+ */
+template <typename Metrics> class MetricsScope
+{
+  private:
+    Metrics &metrics;
+    TreeOperation operation;
+
+  public:
+    MetricsScope(Metrics &metrics, TreeOperation operation) : metrics(metrics), operation(operation)
+    {
+        metrics.beginOperation();
+    }
+
+    ~MetricsScope()
+    {
+        metrics.endOperation(operation);
+    }
+
+    MetricsScope(const MetricsScope &) = delete;
+    MetricsScope &operator=(const MetricsScope &) = delete;
+};
+
+} // namespace models
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace models
+{
+
+/**
+ * @brief Balancing policy for a plain (unbalanced) binary search tree
+ *
+ * Nodes are linked exactly where the insertion order puts them. This keeps the shape of the tree predictable,
+ * but monotonic input degrades the tree into a linked list with O(n) operations.
+ */
+struct Unbalanced
+{
+    static constexpr bool rebalances = false;
+    static constexpr bool splays = false;
+};
+
+/**
+ * @brief Balancing policy for an AVL tree
+ *
+ * After every insert and erase the heights of the two subtrees of any node differ by at most one, restored with
+ * single or double rotations on the way back up the modified path. This bounds the height of the tree to roughly
+ * 1.44 * log2(n), so insert, find and erase are O(log n) in the worst case.
+ */
+struct AvlBalanced
+{
+    static constexpr bool rebalances = true;
+    static constexpr bool splays = false;
+};
+
+/**
+ * @brief Self-adjusting policy: a splay tree
+ *
+ * Every insert, erase and lookup (contains, find) rotates the node it reached up to the root, in pairs of rotations
+ * that also roughly halve the depth of every node along the path. Values used often or recently stay near the root,
+ * so a skewed stream of lookups costs far fewer levels than a balanced tree. There is no worst case bound per
+ * operation, sorted inserts build a path of height n - 1, but any sequence of m operations costs O((m + n) log n):
+ * O(log n) amortized. A lookup that reaches its value stops there instead of descending to the bottom.
+ *
+ * Lookups rewrite the tree, so unlike the other policies, even const lookups must not run concurrently with any
+ * other operation on the same set.
+ */
+struct Splaying
+{
+    static constexpr bool rebalances = false;
+    static constexpr bool splays = true;
+
+    static bool splayLookup()
+    {
+        return true;
+    }
+};
+
+/**
+ * @brief Splaying policy for read-mostly sets: lookups only splay once in Period on average
+ *
+ * @tparam Period The average number of lookups per splay
+ *
+ * Insert and erase always splay, as they write to the tree anyway. Each lookup splays with probability 1 / Period,
+ * drawn from a per-thread xorshift generator, so most lookups of a hot value only read the tree, while a value looked
+ * up often is still splayed up to the root soon. Splaying at random keeps the O(log n) amortized bound in
+ * expectation (Albers and Karpinski, "Randomized splay trees"), with a larger constant.
+ */
+template <unsigned Period> struct SampledSplaying
+{
+    static_assert(Period > 0, "Period must be at least 1");
+    static constexpr bool rebalances = false;
+    static constexpr bool splays = true;
+
+    static bool splayLookup()
+    {
+        thread_local uint32_t state = 0x9E3779B9u;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state % Period == 0;
+    }
+};
+
+/**
+ * @brief Holds a comparator, taking no space at all when it is stateless
+ *
+ * @tparam Compare The comparator type
+ *
+ * An empty comparator (std::less, a lambda without captures) is inherited, so the empty base optimisation folds it
+ * away in the class deriving from this one. Stateful and final comparators are stored as a member.
+ *
+ * Holders are always copy assignable, even when Compare is not (a lambda with captures): a set that takes over the
+ * nodes of another must take over the comparator that ordered them too. An empty comparator has nothing to copy,
+ * and a stored one without copy assignment is destroyed and copy constructed in place.
+ */
+template <typename Compare, bool = std::is_empty_v<Compare> && !std::is_final_v<Compare>>
+class CompareHolder : private Compare
+{
+  public:
+    explicit CompareHolder(const Compare &compare) : Compare(compare)
+    {
+    }
+
+    CompareHolder(const CompareHolder &) = default;
+
+    CompareHolder &operator=(const CompareHolder &) noexcept
+    {
+        return *this;
+    }
+
+    const Compare &comparator() const
+    {
+        return *this;
+    }
+};
+
+template <typename Compare> class CompareHolder<Compare, false>
+{
+  private:
+    Compare compare;
+
+  public:
+    explicit CompareHolder(const Compare &compare) : compare(compare)
+    {
+    }
+
+    CompareHolder(const CompareHolder &) = default;
+
+    //? noexcept like the move assignments calling it: a comparator whose copy throws terminates
+    CompareHolder &operator=(const CompareHolder &other) noexcept
+    {
+        if (this != &other)
+        {
+            if constexpr (std::is_copy_assignable_v<Compare>)
+            {
+                compare = other.compare;
+            }
+            else
+            {
+                compare.~Compare();
+                ::new (static_cast<void *>(&compare)) Compare(other.compare);
+            }
+        }
+        return *this;
+    }
+
+    const Compare &comparator() const
+    {
+        //? A comparator rebuilt in place may hold references (captures by reference), laundering makes that defined
+        if constexpr (std::is_copy_assignable_v<Compare>)
+        {
+            return compare;
+        }
+        else
+        {
+            return *std::launder(&compare);
+        }
+    }
+};
+
+} // namespace models
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace models
+{
+
+/**
+ * @brief Default number of elements below which parallel tree algorithms stop splitting work and run sequentially
+ */
+constexpr size_t default_parallel_grain = 16384;
+
+/**
+ * @brief A fork-join thread pool where idle threads steal work from busy ones
+ *
+ * Every worker owns a deque of pending jobs: it pushes and pops jobs at the back (the most recently forked, whose data
+ * is still in its cache) while idle workers steal from the front (the oldest, and usually largest, piece of work).
+ * Threads that are not part of the pool share one extra deque.
+ *
+ * Work is forked with parallelInvoke. A thread waiting for a stolen job keeps running other jobs instead of
+ * blocking, so divide and conquer algorithms can nest parallelInvoke calls to any depth without deadlocking, and a
+ * pool with no workers at all simply runs everything on the calling thread.
+ */
+class WorkStealingPool
+{
+  private:
+    struct Job
+    {
+        std::function<void()> work;
+        std::atomic<bool> done{false};
+        std::exception_ptr error;
+    };
+
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<Job *> jobs;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues; //? One per worker, plus a shared one for outside threads
+    std::vector<std::thread> workers;
+    std::atomic<size_t> pending;
+    std::atomic<bool> stopping;
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+
+    size_t currentQueue() const;
+    void push(size_t queue, Job *job);
+    bool reclaim(size_t queue, Job *job);
+    Job *findJob(size_t queue);
+    static void run(Job *job);
+    void workerLoop(size_t index);
+
+  public:
+    /**
+     * @brief Start a pool with the given number of worker threads
+     *
+     * @param threads The number of worker threads, the thread calling parallelInvoke works as well. Defaults to one
+     * less than the hardware concurrency, so the caller and the workers together use every core.
+     */
+    explicit WorkStealingPool(size_t threads = defaultThreadCount());
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    /**
+     * @brief Get the number of worker threads (not counting threads that call into the pool)
+     *
+     * @return size_t The number of worker threads
+     */
+    size_t workerCount() const
+    {
+        return workers.size();
+    }
+
+    /**
+     * @brief Get the default number of worker threads
+     *
+     * @return size_t std::thread::hardware_concurrency() - 1, or 0 if it is unknown
+     */
+    static size_t defaultThreadCount();
+
+    /**
+     * @brief Run two functions, potentially in parallel, and return once both have finished
+     *
+     * @param left Run on the calling thread
+     * @param right Offered to other threads, and run by the calling thread if nobody has stolen it by then
+     * @throws Rethrows the exception of left, or else of right, after both have finished
+     */
+    void parallelInvoke(const std::function<void()> &left, const std::function<void()> &right);
+
+    /**
+     * @brief Call body on consecutive chunks of [first, last), potentially in parallel
+     *
+     * @param first The first index
+     * @param last One past the last index
+     * @param grain The largest chunk handed to a single call of body (at least 1)
+     * @param body Called with the [begin, end) bounds of each chunk
+     *
+     * The range is halved recursively with parallelInvoke, so idle threads steal the largest remaining halves.
+     */
+    void parallelFor(size_t first, size_t last, size_t grain, const std::function<void(size_t, size_t)> &body);
+};
+
+} // namespace models
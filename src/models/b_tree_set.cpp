@@ -0,0 +1,493 @@
+#include "models/b_tree_set.hpp"
+#include "models/key_search.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace models
+{
+//? Every internal node has at least two children, so no tree that fits in memory is deeper than this
+constexpr int max_btree_depth = 64;
+
+template <typename T, size_t MinDegree>
+typename BTreeSet<T, MinDegree>::InternalNode *BTreeSet<T, MinDegree>::asInternal(LeafNode *node)
+{
+    return static_cast<InternalNode *>(node);
+}
+
+template <typename T, size_t MinDegree>
+const typename BTreeSet<T, MinDegree>::InternalNode *BTreeSet<T, MinDegree>::asInternal(const LeafNode *node)
+{
+    return static_cast<const InternalNode *>(node);
+}
+
+template <typename T, size_t MinDegree>
+size_t BTreeSet<T, MinDegree>::lowerBound(const LeafNode *node, const T &value)
+{
+    //? Arithmetic keys are counted with vector compares (see key_search.hpp), strings keep the binary search
+    if constexpr (std::is_same_v<T, int> || std::is_same_v<T, double>)
+    {
+        return countLess(node->keys, node->count, value);
+    }
+    else
+    {
+        return static_cast<size_t>(std::lower_bound(node->keys, node->keys + node->count, value) - node->keys);
+    }
+}
+
+template <typename T, size_t MinDegree>
+bool BTreeSet<T, MinDegree>::matches(const LeafNode *node, size_t index, const T &value)
+{
+    return index < node->count && !(value < node->keys[index]);
+}
+
+template <typename T, size_t MinDegree> typename BTreeSet<T, MinDegree>::LeafNode *BTreeSet<T, MinDegree>::createLeaf()
+{
+    return leaf_allocator.create();
+}
+
+template <typename T, size_t MinDegree>
+typename BTreeSet<T, MinDegree>::InternalNode *BTreeSet<T, MinDegree>::createInternal()
+{
+    return internal_allocator.create();
+}
+
+template <typename T, size_t MinDegree> void BTreeSet<T, MinDegree>::destroyNode(LeafNode *node)
+{
+    if (node->leaf)
+    {
+        leaf_allocator.destroy(node);
+    }
+    else
+    {
+        internal_allocator.destroy(asInternal(node));
+    }
+}
+
+template <typename T, size_t MinDegree> AllocationStats BTreeSet<T, MinDegree>::allocationStats() const
+{
+    AllocationStats leaves = leaf_allocator.stats();
+    AllocationStats internals = internal_allocator.stats();
+
+    leaves.allocations += internals.allocations;
+    leaves.deallocations += internals.deallocations;
+    leaves.system_allocations += internals.system_allocations;
+    leaves.bytes_reserved += internals.bytes_reserved;
+    leaves.bytes_in_use += internals.bytes_in_use;
+    return leaves;
+}
+
+template <typename T, size_t MinDegree> void BTreeSet<T, MinDegree>::splitChild(InternalNode *parent, size_t index)
+{
+    //? The full child keeps its lower t - 1 keys, the new sibling takes the upper t - 1 and the median moves up
+    LeafNode *child = parent->children[index];
+    LeafNode *sibling = child->leaf ? createLeaf() : createInternal();
+
+    for (size_t j = 0; j < min_keys; ++j)
+    {
+        sibling->keys[j] = std::move(child->keys[j + MinDegree]);
+    }
+    if (!child->leaf)
+    {
+        for (size_t j = 0; j < MinDegree; ++j)
+        {
+            asInternal(sibling)->children[j] = asInternal(child)->children[j + MinDegree];
+        }
+    }
+    sibling->count = min_keys;
+
+    for (size_t j = parent->count; j > index; --j)
+    {
+        parent->keys[j] = std::move(parent->keys[j - 1]);
+        parent->children[j + 1] = parent->children[j];
+    }
+    parent->keys[index] = std::move(child->keys[min_keys]);
+    parent->children[index + 1] = sibling;
+    parent->count++;
+    child->count = min_keys;
+}
+
+template <typename T, size_t MinDegree> void BTreeSet<T, MinDegree>::mergeChildren(InternalNode *parent, size_t index)
+{
+    //? Both children hold t - 1 keys: append the separating key and the right child to the left child
+    LeafNode *left = parent->children[index];
+    LeafNode *right = parent->children[index + 1];
+
+    left->keys[left->count] = std::move(parent->keys[index]);
+    for (size_t j = 0; j < right->count; ++j)
+    {
+        left->keys[left->count + 1 + j] = std::move(right->keys[j]);
+    }
+    if (!left->leaf)
+    {
+        for (size_t j = 0; j <= right->count; ++j)
+        {
+            asInternal(left)->children[left->count + 1 + j] = asInternal(right)->children[j];
+        }
+    }
+    left->count += right->count + 1;
+
+    for (size_t j = index + 1; j < parent->count; ++j)
+    {
+        parent->keys[j - 1] = std::move(parent->keys[j]);
+        parent->children[j] = parent->children[j + 1];
+    }
+    parent->count--;
+    destroyNode(right);
+}
+
+template <typename T, size_t MinDegree> void BTreeSet<T, MinDegree>::borrowFromLeft(InternalNode *parent, size_t index)
+{
+    //? Rotate right: the separating key moves down into the child, the left sibling's last key moves up
+    LeafNode *child = parent->children[index];
+    LeafNode *left = parent->children[index - 1];
+
+    for (size_t j = child->count; j > 0; --j)
+    {
+        child->keys[j] = std::move(child->keys[j - 1]);
+    }
+    if (!child->leaf)
+    {
+        for (size_t j = child->count + 1; j > 0; --j)
+        {
+            asInternal(child)->children[j] = asInternal(child)->children[j - 1];
+        }
+        asInternal(child)->children[0] = asInternal(left)->children[left->count];
+    }
+    child->keys[0] = std::move(parent->keys[index - 1]);
+    parent->keys[index - 1] = std::move(left->keys[left->count - 1]);
+
+    left->count--;
+    child->count++;
+}
+
+template <typename T, size_t MinDegree> void BTreeSet<T, MinDegree>::borrowFromRight(InternalNode *parent, size_t index)
+{
+    //? Rotate left: the separating key moves down into the child, the right sibling's first key moves up
+    LeafNode *child = parent->children[index];
+    LeafNode *right = parent->children[index + 1];
+
+    child->keys[child->count] = std::move(parent->keys[index]);
+    parent->keys[index] = std::move(right->keys[0]);
+    if (!child->leaf)
+    {
+        asInternal(child)->children[child->count + 1] = asInternal(right)->children[0];
+    }
+
+    for (size_t j = 1; j < right->count; ++j)
+    {
+        right->keys[j - 1] = std::move(right->keys[j]);
+    }
+    if (!right->leaf)
+    {
+        for (size_t j = 1; j <= right->count; ++j)
+        {
+            asInternal(right)->children[j - 1] = asInternal(right)->children[j];
+        }
+    }
+
+    right->count--;
+    child->count++;
+}
+
+template <typename T, size_t MinDegree>
+void BTreeSet<T, MinDegree>::ensureChildCanLose(InternalNode *parent, size_t &index)
+{
+    if (parent->children[index]->count > min_keys)
+    {
+        return;
+    }
+
+    if (index > 0 && parent->children[index - 1]->count > min_keys)
+    {
+        borrowFromLeft(parent, index);
+    }
+    else if (index < parent->count && parent->children[index + 1]->count > min_keys)
+    {
+        borrowFromRight(parent, index);
+    }
+    else if (index < parent->count)
+    {
+        mergeChildren(parent, index);
+    }
+    else
+    {
+        mergeChildren(parent, index - 1);
+        index--;
+    }
+}
+
+template <typename T, size_t MinDegree> void BTreeSet<T, MinDegree>::insert(const T &value)
+{
+    if constexpr (std::is_same_v<T, std::string>)
+    {
+        if (value.empty())
+        {
+            throw std::invalid_argument("String value cannot be empty");
+        }
+    }
+
+    if (!root)
+    {
+        root = createLeaf();
+        tree_height = 0;
+    }
+    else if (root->count == max_keys)
+    {
+        //? A full root is split into a new root, the only way the tree grows taller
+        InternalNode *grown = createInternal();
+        grown->children[0] = root;
+        root = grown;
+        splitChild(grown, 0);
+        tree_height++;
+    }
+
+    LeafNode *node = root;
+    while (true)
+    {
+        size_t index = lowerBound(node, value);
+        if (matches(node, index, value))
+        {
+            //? If value is already present, do not insert (no duplicates)
+            return;
+        }
+
+        if (node->leaf)
+        {
+            for (size_t j = node->count; j > index; --j)
+            {
+                node->keys[j] = std::move(node->keys[j - 1]);
+            }
+            node->keys[index] = value;
+            node->count++;
+            tree_size++;
+            return;
+        }
+
+        InternalNode *internal = asInternal(node);
+        if (internal->children[index]->count == max_keys)
+        {
+            splitChild(internal, index);
+            if (internal->keys[index] < value)
+            {
+                index++;
+            }
+            else if (!(value < internal->keys[index]))
+            {
+                return;
+            }
+        }
+        node = internal->children[index];
+    }
+}
+
+template <typename T, size_t MinDegree> void BTreeSet<T, MinDegree>::insertRange(const std::vector<T> &range)
+{
+    for (const auto &value : range)
+    {
+        insert(value);
+    }
+}
+
+template <typename T, size_t MinDegree> void BTreeSet<T, MinDegree>::merge(const BTreeSet &set)
+{
+    set.traverseInorder([this](const T &value) { this->insert(value); });
+}
+
+template <typename T, size_t MinDegree> bool BTreeSet<T, MinDegree>::contains(const T &value) const
+{
+    const LeafNode *node = root;
+    while (node)
+    {
+        const size_t index = lowerBound(node, value);
+        if (matches(node, index, value))
+        {
+            return true;
+        }
+        node = node->leaf ? nullptr : asInternal(node)->children[index];
+    }
+    return false;
+}
+
+template <typename T, size_t MinDegree> bool BTreeSet<T, MinDegree>::erase(const T &value)
+{
+    if (!root)
+    {
+        return false;
+    }
+
+    //? The key being removed changes when an internal key is swapped for its predecessor/successor
+    T target = value;
+    bool removed = false;
+    LeafNode *node = root;
+    while (true)
+    {
+        size_t index = lowerBound(node, target);
+        const bool found = matches(node, index, target);
+
+        if (node->leaf)
+        {
+            if (found)
+            {
+                for (size_t j = index + 1; j < node->count; ++j)
+                {
+                    node->keys[j - 1] = std::move(node->keys[j]);
+                }
+                node->count--;
+                removed = true;
+            }
+            break;
+        }
+
+        InternalNode *internal = asInternal(node);
+        if (found)
+        {
+            LeafNode *left = internal->children[index];
+            LeafNode *right = internal->children[index + 1];
+            if (left->count > min_keys)
+            {
+                //? Replace with the predecessor (largest key of the left subtree), then remove that instead
+                const LeafNode *predecessor = left;
+                while (!predecessor->leaf)
+                {
+                    predecessor = asInternal(predecessor)->children[predecessor->count];
+                }
+                internal->keys[index] = predecessor->keys[predecessor->count - 1];
+                target = internal->keys[index];
+                node = left;
+            }
+            else if (right->count > min_keys)
+            {
+                //? Replace with the successor (smallest key of the right subtree), then remove that instead
+                const LeafNode *successor = right;
+                while (!successor->leaf)
+                {
+                    successor = asInternal(successor)->children[0];
+                }
+                internal->keys[index] = successor->keys[0];
+                target = internal->keys[index];
+                node = right;
+            }
+            else
+            {
+                //? Both neighbours are minimal: merge them around the key and remove it from the merged child
+                mergeChildren(internal, index);
+                node = left;
+            }
+            continue;
+        }
+
+        ensureChildCanLose(internal, index);
+        node = internal->children[index];
+    }
+
+    //? A root left without keys is either the last leaf or an internal node with a single child
+    if (root->count == 0)
+    {
+        LeafNode *emptied = root;
+        root = emptied->leaf ? nullptr : asInternal(emptied)->children[0];
+        destroyNode(emptied);
+        tree_height--;
+    }
+
+    if (removed)
+    {
+        tree_size--;
+    }
+    return removed;
+}
+
+template <typename T, size_t MinDegree> void BTreeSet<T, MinDegree>::clear()
+{
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        //? Post-order walk with a fixed-size stack, destroying each node after its children
+        struct Frame
+        {
+            LeafNode *node;
+            size_t next;
+        };
+        Frame stack[max_btree_depth];
+        int depth = -1;
+        if (root)
+        {
+            stack[++depth] = {root, 0};
+        }
+        while (depth >= 0)
+        {
+            Frame &frame = stack[depth];
+            if (!frame.node->leaf && frame.next <= frame.node->count)
+            {
+                LeafNode *child = asInternal(frame.node)->children[frame.next++];
+                stack[++depth] = {child, 0};
+            }
+            else
+            {
+                destroyNode(frame.node);
+                --depth;
+            }
+        }
+    }
+    leaf_allocator.release();
+    internal_allocator.release();
+
+    root = nullptr;
+    tree_size = 0;
+    tree_height = -1;
+}
+
+template <typename T, size_t MinDegree>
+void BTreeSet<T, MinDegree>::traverseInorder(std::function<void(const T &)> callback) const
+{
+    //? Each frame remembers which child to descend into next, key i is visited between children i and i + 1
+    struct Frame
+    {
+        const LeafNode *node;
+        size_t next;
+    };
+    Frame stack[max_btree_depth];
+    int depth = -1;
+    if (root)
+    {
+        stack[++depth] = {root, 0};
+    }
+    while (depth >= 0)
+    {
+        Frame &frame = stack[depth];
+        if (frame.node->leaf)
+        {
+            for (size_t j = 0; j < frame.node->count; ++j)
+            {
+                callback(frame.node->keys[j]);
+            }
+            --depth;
+        }
+        else if (frame.next <= frame.node->count)
+        {
+            if (frame.next > 0)
+            {
+                callback(frame.node->keys[frame.next - 1]);
+            }
+            const LeafNode *child = asInternal(frame.node)->children[frame.next++];
+            stack[++depth] = {child, 0};
+        }
+        else
+        {
+            --depth;
+        }
+    }
+}
+} // namespace models
+
+// Explicit template instantiations for common types
+template class models::BTreeSet<int>;
+template class models::BTreeSet<double>;
+template class models::BTreeSet<std::string>;
+
+// Minimum degree 2 (a 2-3-4 tree) splits and merges on almost every operation, used to exercise the rebalancing
+template class models::BTreeSet<int, 2>;
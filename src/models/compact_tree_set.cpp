@@ -0,0 +1,7 @@
+#include "models/compact_tree_set.hpp"
+
+#include <string>
+
+template class models::CompactTreeSet<int>;
+template class models::CompactTreeSet<double>;
+template class models::CompactTreeSet<std::string>;
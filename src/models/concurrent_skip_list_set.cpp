@@ -0,0 +1,7 @@
+#include "models/concurrent_skip_list_set.hpp"
+
+#include <string>
+
+template class models::ConcurrentSkipListSet<int>;
+template class models::ConcurrentSkipListSet<double>;
+template class models::ConcurrentSkipListSet<std::string>;
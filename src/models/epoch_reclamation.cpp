@@ -0,0 +1,130 @@
+#include "models/epoch_reclamation.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace models
+{
+
+EpochDomain::EpochDomain(size_t slots)
+    : slots(std::make_unique<Slot[]>(std::max<size_t>(slots, 1))), slot_count(std::max<size_t>(slots, 1)),
+      global_epoch(0), retired_since_collect(0)
+{
+}
+
+EpochDomain::~EpochDomain()
+{
+    for (const Retired &item : retired)
+    {
+        item.deleter(item.object);
+    }
+}
+
+size_t EpochDomain::defaultSlotCount()
+{
+    return std::max<size_t>(64, 4 * static_cast<size_t>(std::thread::hardware_concurrency()));
+}
+
+EpochDomain::Slot *EpochDomain::acquireSlot()
+{
+    //? Start probing at a per-thread position so concurrent threads usually claim different slots at once
+    const size_t start = std::hash<std::thread::id>()(std::this_thread::get_id()) % slot_count;
+    while (true)
+    {
+        for (size_t offset = 0; offset < slot_count; ++offset)
+        {
+            Slot &slot = slots[(start + offset) % slot_count];
+            bool expected = false;
+            if (!slot.in_use.load(std::memory_order_relaxed) && slot.in_use.compare_exchange_strong(expected, true))
+            {
+                return &slot;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+EpochDomain::Guard EpochDomain::pin()
+{
+    Slot *slot = acquireSlot();
+
+    //? Publish an epoch that is still current after publishing it: the epoch cannot advance past it until this slot
+    //? is released, and nothing retired before that epoch is reachable from here on
+    uint64_t epoch = global_epoch.load();
+    while (true)
+    {
+        slot->epoch.store(epoch);
+        const uint64_t current = global_epoch.load();
+        if (current == epoch)
+        {
+            break;
+        }
+        epoch = current;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return Guard(slot);
+}
+
+bool EpochDomain::tryAdvance()
+{
+    uint64_t epoch = global_epoch.load();
+    for (size_t i = 0; i < slot_count; ++i)
+    {
+        if (slots[i].in_use.load() && slots[i].epoch.load() != epoch)
+        {
+            return false;
+        }
+    }
+    return global_epoch.compare_exchange_strong(epoch, epoch + 1);
+}
+
+void EpochDomain::retire(void *object, void (*deleter)(void *))
+{
+    //? Orders the unlinking of object before reading the epoch it is retired in
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const uint64_t epoch = global_epoch.load();
+
+    bool collectNow;
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex);
+        retired.push_back({object, deleter, epoch});
+        collectNow = ++retired_since_collect >= collect_interval;
+        if (collectNow)
+        {
+            retired_since_collect = 0;
+        }
+    }
+    if (collectNow)
+    {
+        collect();
+    }
+}
+
+void EpochDomain::collect()
+{
+    tryAdvance();
+    const uint64_t epoch = global_epoch.load();
+
+    //? Objects are retired in epoch order, so the safe ones form a prefix. They are freed outside the lock
+    std::vector<Retired> safe;
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex);
+        auto firstUnsafe = std::find_if(retired.begin(), retired.end(),
+                                        [epoch](const Retired &item) { return item.epoch + 2 > epoch; });
+        safe.assign(retired.begin(), firstUnsafe);
+        retired.erase(retired.begin(), firstUnsafe);
+    }
+    for (const Retired &item : safe)
+    {
+        item.deleter(item.object);
+    }
+}
+
+size_t EpochDomain::pendingCount()
+{
+    std::lock_guard<std::mutex> lock(retired_mutex);
+    return retired.size();
+}
+
+} // namespace models
@@ -0,0 +1,188 @@
+#include "models/key_search.hpp"
+
+#include <cstddef>
+
+//? The vector kernels use GCC/Clang target attributes, so one binary carries them all and picks at runtime
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MODELS_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define MODELS_X86_KERNELS 0
+#endif
+
+namespace models
+{
+namespace
+{
+
+//? Sorted keys make the tail short and the comparisons cheap, there is nothing to gain from breaking out early
+template <typename T> size_t countLessScalar(const T *keys, size_t count, T value)
+{
+    size_t less = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        less += static_cast<size_t>(keys[i] < value);
+    }
+    return less;
+}
+
+#if MODELS_X86_KERNELS
+
+//? SSE2 has no popcnt and __builtin_popcount without it is a library call, so the 2 and 4-bit masks use a table
+constexpr unsigned char mask_bits[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+__attribute__((target("sse2"))) size_t countLessSse2(const int *keys, size_t count, int value)
+{
+    const __m128i needle = _mm_set1_epi32(value);
+    size_t less = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+        const int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(block, needle)));
+        less += mask_bits[mask];
+    }
+    return less + countLessScalar(keys + i, count - i, value);
+}
+
+__attribute__((target("sse2"))) size_t countLessSse2(const double *keys, size_t count, double value)
+{
+    const __m128d needle = _mm_set1_pd(value);
+    size_t less = 0;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        const int mask = _mm_movemask_pd(_mm_cmplt_pd(_mm_loadu_pd(keys + i), needle));
+        less += mask_bits[mask];
+    }
+    return less + countLessScalar(keys + i, count - i, value);
+}
+
+__attribute__((target("avx2,popcnt"))) size_t countLessAvx2(const int *keys, size_t count, int value)
+{
+    const __m256i needle = _mm256_set1_epi32(value);
+    size_t less = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+        const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(needle, block)));
+        less += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(mask)));
+    }
+    return less + countLessScalar(keys + i, count - i, value);
+}
+
+__attribute__((target("avx2,popcnt"))) size_t countLessAvx2(const double *keys, size_t count, double value)
+{
+    const __m256d needle = _mm256_set1_pd(value);
+    size_t less = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        //? Ordered, non-signalling compare: the same result as keys[i] < value, NaN included
+        const int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(keys + i), needle, _CMP_LT_OQ));
+        less += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(mask)));
+    }
+    return less + countLessScalar(keys + i, count - i, value);
+}
+
+#endif
+
+template <typename T> size_t countLessWith(SearchKernel kernel, const T *keys, size_t count, T value)
+{
+    switch (kernel)
+    {
+#if MODELS_X86_KERNELS
+    case SearchKernel::Avx2:
+        return countLessAvx2(keys, count, value);
+    case SearchKernel::Sse2:
+        return countLessSse2(keys, count, value);
+#endif
+    default:
+        return countLessScalar(keys, count, value);
+    }
+}
+
+template <typename T> using CountLessFunction = size_t (*)(const T *, size_t, T);
+
+//? Resolved once, so a search pays one indirect call per node instead of re-checking the CPU
+template <typename T> CountLessFunction<T> resolveCountLess()
+{
+    switch (activeSearchKernel())
+    {
+#if MODELS_X86_KERNELS
+    case SearchKernel::Avx2:
+        return &countLessAvx2;
+    case SearchKernel::Sse2:
+        return &countLessSse2;
+#endif
+    default:
+        return &countLessScalar<T>;
+    }
+}
+
+} // namespace
+
+const char *searchKernelName(SearchKernel kernel)
+{
+    switch (kernel)
+    {
+    case SearchKernel::Sse2:
+        return "sse2";
+    case SearchKernel::Avx2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+bool searchKernelSupported(SearchKernel kernel)
+{
+    switch (kernel)
+    {
+#if MODELS_X86_KERNELS
+    case SearchKernel::Sse2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+    case SearchKernel::Avx2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+    case SearchKernel::Scalar:
+        return true;
+    default:
+        return false;
+    }
+}
+
+SearchKernel activeSearchKernel()
+{
+    static const SearchKernel active = searchKernelSupported(SearchKernel::Avx2)   ? SearchKernel::Avx2
+                                       : searchKernelSupported(SearchKernel::Sse2) ? SearchKernel::Sse2
+                                                                                   : SearchKernel::Scalar;
+    return active;
+}
+
+size_t countLess(const int *keys, size_t count, int value)
+{
+    static const CountLessFunction<int> function = resolveCountLess<int>();
+    return function(keys, count, value);
+}
+
+size_t countLess(const double *keys, size_t count, double value)
+{
+    static const CountLessFunction<double> function = resolveCountLess<double>();
+    return function(keys, count, value);
+}
+
+size_t countLess(SearchKernel kernel, const int *keys, size_t count, int value)
+{
+    return countLessWith(kernel, keys, count, value);
+}
+
+size_t countLess(SearchKernel kernel, const double *keys, size_t count, double value)
+{
+    return countLessWith(kernel, keys, count, value);
+}
+
+} // namespace models
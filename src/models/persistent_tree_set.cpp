@@ -0,0 +1,7 @@
+#include "models/persistent_tree_set.hpp"
+
+#include <string>
+
+template class models::PersistentTreeSet<int>;
+template class models::PersistentTreeSet<double>;
+template class models::PersistentTreeSet<std::string>;
@@ -0,0 +1,99 @@
+#include "models/set_file.hpp"
+
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MODELS_HAVE_MMAP 1
+#endif
+
+namespace models
+{
+
+MappedFile::MappedFile(const std::string &path) : bytes(nullptr), length(0)
+{
+#ifdef MODELS_HAVE_MMAP
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0)
+    {
+        ::close(descriptor);
+        throw std::runtime_error("Cannot read the size of " + path);
+    }
+    length = static_cast<size_t>(status.st_size);
+
+    //? mmap rejects empty mappings, an empty file simply has no bytes
+    if (length > 0)
+    {
+        void *mapping = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, descriptor, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(descriptor);
+            throw std::runtime_error("Cannot map " + path);
+        }
+        bytes = static_cast<const unsigned char *>(mapping);
+    }
+    //? The mapping stays valid after the descriptor is closed
+    ::close(descriptor);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+    {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    buffer.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    if (!in)
+    {
+        throw std::runtime_error("Cannot read " + path);
+    }
+    bytes = buffer.data();
+    length = buffer.size();
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : bytes(std::exchange(other.bytes, nullptr)), length(std::exchange(other.length, 0)),
+      buffer(std::move(other.buffer))
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        bytes = std::exchange(other.bytes, nullptr);
+        length = std::exchange(other.length, 0);
+        buffer = std::move(other.buffer);
+    }
+    return *this;
+}
+
+void MappedFile::unmap()
+{
+#ifdef MODELS_HAVE_MMAP
+    if (bytes)
+    {
+        ::munmap(const_cast<unsigned char *>(bytes), length);
+    }
+#endif
+    bytes = nullptr;
+    length = 0;
+    buffer.clear();
+}
+
+} // namespace models
@@ -0,0 +1,7 @@
+#include "models/static_set.hpp"
+
+#include <string>
+
+template class models::StaticSet<int>;
+template class models::StaticSet<double>;
+template class models::StaticSet<std::string>;
@@ -0,0 +1,597 @@
+#include "models/string_set.hpp"
+
+#include <algorithm>
+#include <memory>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace models
+{
+namespace
+{
+
+//? Number of leading bytes two strings share
+size_t commonLength(std::string_view a, std::string_view b)
+{
+    const size_t limit = std::min(a.size(), b.size());
+    size_t length = 0;
+    while (length < limit && a[length] == b[length])
+    {
+        ++length;
+    }
+    return length;
+}
+
+//? Node4 and Node16 keep their key bytes sorted, with the children in the same order
+template <typename Child> void insertSorted(uint8_t *keys, Child *children, size_t count, uint8_t byte, Child child)
+{
+    size_t position = 0;
+    while (position < count && keys[position] < byte)
+    {
+        ++position;
+    }
+    std::copy_backward(keys + position, keys + count, keys + count + 1);
+    std::copy_backward(children + position, children + count, children + count + 1);
+    keys[position] = byte;
+    children[position] = child;
+}
+
+template <typename Child> void eraseSorted(uint8_t *keys, Child *children, size_t count, uint8_t byte)
+{
+    const size_t position = static_cast<size_t>(std::find(keys, keys + count, byte) - keys);
+    std::copy(keys + position + 1, keys + count, keys + position);
+    std::copy(children + position + 1, children + count, children + position);
+}
+
+} // namespace
+
+StringSet::~StringSet()
+{
+    destroyTree(root);
+}
+
+StringSet::StringSet(StringSet &&other) noexcept
+    : root(std::exchange(other.root, nullptr)), set_size(std::exchange(other.set_size, 0))
+{
+}
+
+StringSet &StringSet::operator=(StringSet &&other) noexcept
+{
+    if (this != &other)
+    {
+        destroyTree(root);
+        root = std::exchange(other.root, nullptr);
+        set_size = std::exchange(other.set_size, 0);
+    }
+    return *this;
+}
+
+//
+//! SECTION Node helpers
+//
+
+StringSet::Header **StringSet::findChild(Inner *node, uint8_t byte)
+{
+    switch (node->kind)
+    {
+    case Kind::Node4: {
+        auto *small = static_cast<Node4 *>(node);
+        for (uint16_t i = 0; i < small->count; ++i)
+        {
+            if (small->keys[i] == byte)
+            {
+                return &small->children[i];
+            }
+        }
+        return nullptr;
+    }
+    case Kind::Node16: {
+        auto *medium = static_cast<Node16 *>(node);
+#if defined(__SSE2__)
+        //? One compare of all 16 key bytes, masked to the ones in use
+        const __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                               _mm_loadu_si128(reinterpret_cast<const __m128i *>(medium->keys)));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(matches)) & ((1u << medium->count) - 1);
+        return mask ? &medium->children[__builtin_ctz(mask)] : nullptr;
+#else
+        for (uint16_t i = 0; i < medium->count; ++i)
+        {
+            if (medium->keys[i] == byte)
+            {
+                return &medium->children[i];
+            }
+        }
+        return nullptr;
+#endif
+    }
+    case Kind::Node48: {
+        auto *wide = static_cast<Node48 *>(node);
+        return wide->index[byte] ? &wide->children[wide->index[byte] - 1] : nullptr;
+    }
+    default: {
+        auto *full = static_cast<Node256 *>(node);
+        return full->children[byte] ? &full->children[byte] : nullptr;
+    }
+    }
+}
+
+StringSet::Header *const *StringSet::findChild(const Inner *node, uint8_t byte)
+{
+    return findChild(const_cast<Inner *>(node), byte);
+}
+
+void StringSet::addChild(Header **link, Inner *node, uint8_t byte, Header *child)
+{
+    //? A full node is replaced by the next larger kind, which takes over its prefix, flag and children
+    switch (node->kind)
+    {
+    case Kind::Node4: {
+        auto *small = static_cast<Node4 *>(node);
+        if (small->count < 4)
+        {
+            insertSorted(small->keys, small->children, small->count++, byte, child);
+            return;
+        }
+        auto *grown = new Node16(std::string_view());
+        grown->prefix.swap(small->prefix);
+        grown->terminal = small->terminal;
+        grown->count = small->count;
+        std::copy(small->keys, small->keys + 4, grown->keys);
+        std::copy(small->children, small->children + 4, grown->children);
+        insertSorted(grown->keys, grown->children, grown->count++, byte, child);
+        *link = grown;
+        delete small;
+        return;
+    }
+    case Kind::Node16: {
+        auto *medium = static_cast<Node16 *>(node);
+        if (medium->count < 16)
+        {
+            insertSorted(medium->keys, medium->children, medium->count++, byte, child);
+            return;
+        }
+        auto *grown = new Node48(std::string_view());
+        grown->prefix.swap(medium->prefix);
+        grown->terminal = medium->terminal;
+        for (uint16_t i = 0; i < 16; ++i)
+        {
+            grown->index[medium->keys[i]] = static_cast<uint8_t>(i + 1);
+            grown->children[i] = medium->children[i];
+        }
+        grown->count = 16;
+        *link = grown;
+        delete medium;
+        node = grown;
+        break;
+    }
+    case Kind::Node48:
+        if (node->count == 48)
+        {
+            auto *wide = static_cast<Node48 *>(node);
+            auto *grown = new Node256(std::string_view());
+            grown->prefix.swap(wide->prefix);
+            grown->terminal = wide->terminal;
+            for (int b = 0; b < 256; ++b)
+            {
+                if (wide->index[b])
+                {
+                    grown->children[b] = wide->children[wide->index[b] - 1];
+                }
+            }
+            grown->count = 48;
+            *link = grown;
+            delete wide;
+            node = grown;
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (node->kind == Kind::Node48)
+    {
+        //? The used slots are always 0 .. count - 1, removeChild moves the last slot into a freed one
+        auto *wide = static_cast<Node48 *>(node);
+        wide->children[wide->count] = child;
+        wide->index[byte] = static_cast<uint8_t>(++wide->count);
+    }
+    else
+    {
+        auto *full = static_cast<Node256 *>(node);
+        full->children[byte] = child;
+        full->count++;
+    }
+}
+
+void StringSet::removeChild(Header **link, Inner *node, uint8_t byte)
+{
+    //? Nodes shrink a few children below the size they grow at, so a key inserted and erased at the border does not
+    //? convert the node back and forth
+    switch (node->kind)
+    {
+    case Kind::Node4: {
+        auto *small = static_cast<Node4 *>(node);
+        eraseSorted(small->keys, small->children, small->count--, byte);
+        return;
+    }
+    case Kind::Node16: {
+        auto *medium = static_cast<Node16 *>(node);
+        eraseSorted(medium->keys, medium->children, medium->count--, byte);
+        if (medium->count > 3)
+        {
+            return;
+        }
+        auto *shrunk = new Node4(std::string_view());
+        shrunk->prefix.swap(medium->prefix);
+        shrunk->terminal = medium->terminal;
+        shrunk->count = medium->count;
+        std::copy(medium->keys, medium->keys + medium->count, shrunk->keys);
+        std::copy(medium->children, medium->children + medium->count, shrunk->children);
+        *link = shrunk;
+        delete medium;
+        return;
+    }
+    case Kind::Node48: {
+        auto *wide = static_cast<Node48 *>(node);
+        const uint8_t slot = static_cast<uint8_t>(wide->index[byte] - 1);
+        const uint8_t last = static_cast<uint8_t>(wide->count - 1);
+        wide->index[byte] = 0;
+        if (slot != last)
+        {
+            wide->children[slot] = wide->children[last];
+            *std::find(wide->index, wide->index + 256, static_cast<uint8_t>(last + 1)) = static_cast<uint8_t>(slot + 1);
+        }
+        wide->count--;
+        if (wide->count > 12)
+        {
+            return;
+        }
+        auto *shrunk = new Node16(std::string_view());
+        shrunk->prefix.swap(wide->prefix);
+        shrunk->terminal = wide->terminal;
+        for (int b = 0; b < 256; ++b)
+        {
+            if (wide->index[b])
+            {
+                shrunk->keys[shrunk->count] = static_cast<uint8_t>(b);
+                shrunk->children[shrunk->count++] = wide->children[wide->index[b] - 1];
+            }
+        }
+        *link = shrunk;
+        delete wide;
+        return;
+    }
+    default: {
+        auto *full = static_cast<Node256 *>(node);
+        full->children[byte] = nullptr;
+        full->count--;
+        if (full->count > 37)
+        {
+            return;
+        }
+        auto *shrunk = new Node48(std::string_view());
+        shrunk->prefix.swap(full->prefix);
+        shrunk->terminal = full->terminal;
+        for (int b = 0; b < 256; ++b)
+        {
+            if (full->children[b])
+            {
+                shrunk->children[shrunk->count] = full->children[b];
+                shrunk->index[b] = static_cast<uint8_t>(++shrunk->count);
+            }
+        }
+        *link = shrunk;
+        delete full;
+        return;
+    }
+    }
+}
+
+void StringSet::collapse(Header **link, Inner *node)
+{
+    //? A node with a single entry left is folded into it: its prefix (and the byte to the child) move down
+    if (node->count == 0)
+    {
+        *link = new Leaf(node->prefix);
+        destroy(node);
+        return;
+    }
+    int position = 0;
+    uint8_t byte = 0;
+    Header *child = const_cast<Header *>(nextChild(node, position, byte));
+    std::string &tail =
+        child->kind == Kind::Leaf ? static_cast<Leaf *>(child)->suffix : static_cast<Inner *>(child)->prefix;
+    std::string joined = std::move(node->prefix);
+    joined.push_back(static_cast<char>(byte));
+    joined += tail;
+    tail.swap(joined);
+    *link = child;
+    destroy(node);
+}
+
+void StringSet::destroy(Header *node)
+{
+    switch (node->kind)
+    {
+    case Kind::Leaf:
+        delete static_cast<Leaf *>(node);
+        break;
+    case Kind::Node4:
+        delete static_cast<Node4 *>(node);
+        break;
+    case Kind::Node16:
+        delete static_cast<Node16 *>(node);
+        break;
+    case Kind::Node48:
+        delete static_cast<Node48 *>(node);
+        break;
+    case Kind::Node256:
+        delete static_cast<Node256 *>(node);
+        break;
+    }
+}
+
+void StringSet::destroyTree(Header *node)
+{
+    std::vector<Header *> pending;
+    if (node)
+    {
+        pending.push_back(node);
+    }
+    while (!pending.empty())
+    {
+        Header *current = pending.back();
+        pending.pop_back();
+        if (current->kind != Kind::Leaf)
+        {
+            int position = 0;
+            uint8_t byte = 0;
+            while (const Header *child = nextChild(static_cast<Inner *>(current), position, byte))
+            {
+                pending.push_back(const_cast<Header *>(child));
+            }
+        }
+        destroy(current);
+    }
+}
+
+//
+//! SECTION Queries
+//
+
+bool StringSet::contains(std::string_view key) const
+{
+    const Header *node = root;
+    size_t depth = 0;
+    while (node)
+    {
+        if (node->kind == Kind::Leaf)
+        {
+            return key.substr(depth) == static_cast<const Leaf *>(node)->suffix;
+        }
+        const auto *inner = static_cast<const Inner *>(node);
+        if (key.substr(depth, inner->prefix.size()) != inner->prefix)
+        {
+            return false;
+        }
+        depth += inner->prefix.size();
+        if (depth == key.size())
+        {
+            return inner->terminal;
+        }
+        Header *const *child = findChild(inner, static_cast<uint8_t>(key[depth]));
+        if (!child)
+        {
+            return false;
+        }
+        node = *child;
+        depth++;
+    }
+    return false;
+}
+
+StringSetStats StringSet::stats() const
+{
+    StringSetStats stats;
+    std::vector<const Header *> pending;
+    if (root)
+    {
+        pending.push_back(root);
+    }
+    while (!pending.empty())
+    {
+        const Header *node = pending.back();
+        pending.pop_back();
+        if (node->kind == Kind::Leaf)
+        {
+            stats.leaves++;
+            stats.suffix_bytes += static_cast<const Leaf *>(node)->suffix.size();
+            continue;
+        }
+        const auto *inner = static_cast<const Inner *>(node);
+        stats.prefix_bytes += inner->prefix.size();
+        switch (node->kind)
+        {
+        case Kind::Node4:
+            stats.node4++;
+            break;
+        case Kind::Node16:
+            stats.node16++;
+            break;
+        case Kind::Node48:
+            stats.node48++;
+            break;
+        default:
+            stats.node256++;
+            break;
+        }
+        int position = 0;
+        uint8_t byte = 0;
+        while (const Header *child = nextChild(inner, position, byte))
+        {
+            pending.push_back(child);
+        }
+    }
+    return stats;
+}
+
+//
+//! SECTION Modification
+//
+
+bool StringSet::insert(std::string_view key)
+{
+    Header **link = &root;
+    size_t depth = 0;
+    while (true)
+    {
+        Header *node = *link;
+        const std::string_view rest = key.substr(depth);
+        if (!node)
+        {
+            *link = new Leaf(rest);
+            set_size++;
+            return true;
+        }
+
+        //? Where the new key leaves the bytes stored in node, a Node4 takes node's place and holds both sides
+        const bool leaf = node->kind == Kind::Leaf;
+        std::string &stored = leaf ? static_cast<Leaf *>(node)->suffix : static_cast<Inner *>(node)->prefix;
+        const size_t shared = commonLength(stored, rest);
+        if (leaf && shared == stored.size() && shared == rest.size())
+        {
+            return false;
+        }
+        if (leaf || shared < stored.size())
+        {
+            auto split = std::make_unique<Node4>(rest.substr(0, shared));
+            std::unique_ptr<Leaf> fresh(rest.size() == shared ? nullptr : new Leaf(rest.substr(shared + 1)));
+            if (shared == stored.size())
+            {
+                //? Only a leaf gets here: its key ends where the new one goes on
+                split->terminal = true;
+                destroy(node);
+            }
+            else
+            {
+                const auto byte = static_cast<uint8_t>(stored[shared]);
+                stored.erase(0, shared + 1);
+                addChild(link, split.get(), byte, node);
+            }
+            if (fresh)
+            {
+                addChild(link, split.get(), static_cast<uint8_t>(rest[shared]), fresh.release());
+            }
+            else
+            {
+                split->terminal = true;
+            }
+            *link = split.release();
+            set_size++;
+            return true;
+        }
+
+        auto *inner = static_cast<Inner *>(node);
+        depth += inner->prefix.size();
+        if (depth == key.size())
+        {
+            if (inner->terminal)
+            {
+                return false;
+            }
+            inner->terminal = true;
+            set_size++;
+            return true;
+        }
+        const auto byte = static_cast<uint8_t>(key[depth]);
+        if (Header **child = findChild(inner, byte))
+        {
+            link = child;
+            depth++;
+            continue;
+        }
+        std::unique_ptr<Leaf> fresh(new Leaf(key.substr(depth + 1)));
+        addChild(link, inner, byte, fresh.get());
+        fresh.release();
+        set_size++;
+        return true;
+    }
+}
+
+bool StringSet::erase(std::string_view key)
+{
+    Header **link = &root;
+    Header **parentLink = nullptr;
+    uint8_t parentByte = 0;
+    size_t depth = 0;
+    while (Header *node = *link)
+    {
+        if (node->kind == Kind::Leaf)
+        {
+            if (key.substr(depth) != static_cast<Leaf *>(node)->suffix)
+            {
+                return false;
+            }
+            if (!parentLink)
+            {
+                root = nullptr;
+            }
+            else
+            {
+                removeChild(parentLink, static_cast<Inner *>(*parentLink), parentByte);
+                auto *parent = static_cast<Inner *>(*parentLink);
+                if (parent->count + (parent->terminal ? 1 : 0) < 2)
+                {
+                    collapse(parentLink, parent);
+                }
+            }
+            destroy(node);
+            set_size--;
+            return true;
+        }
+
+        auto *inner = static_cast<Inner *>(node);
+        if (key.substr(depth, inner->prefix.size()) != inner->prefix)
+        {
+            return false;
+        }
+        depth += inner->prefix.size();
+        if (depth == key.size())
+        {
+            if (!inner->terminal)
+            {
+                return false;
+            }
+            //? Every inner node holds at least two keys, so this one still has a child
+            inner->terminal = false;
+            if (inner->count < 2)
+            {
+                collapse(link, inner);
+            }
+            set_size--;
+            return true;
+        }
+        const auto byte = static_cast<uint8_t>(key[depth]);
+        Header **child = findChild(inner, byte);
+        if (!child)
+        {
+            return false;
+        }
+        parentLink = link;
+        parentByte = byte;
+        link = child;
+        depth++;
+    }
+    return false;
+}
+
+void StringSet::clear()
+{
+    destroyTree(root);
+    root = nullptr;
+    set_size = 0;
+}
+
+} // namespace models
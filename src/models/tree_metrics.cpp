@@ -0,0 +1,116 @@
+#include "models/tree_metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace models
+{
+
+const char *treeOperationName(TreeOperation operation)
+{
+    switch (operation)
+    {
+    case TreeOperation::Insert:
+        return "insert";
+    case TreeOperation::Erase:
+        return "erase";
+    case TreeOperation::Contains:
+        return "contains";
+    default:
+        return "find";
+    }
+}
+
+//
+//! SECTION LatencyHistogram
+//
+
+LatencyHistogram::LatencyHistogram()
+    : counts(bucket_count, 0), total(0), sum(0), minimum(std::numeric_limits<uint64_t>::max()), maximum(0)
+{
+}
+
+//? Buckets below 128 hold one value each, then bucket index covers the values with value >> shift == index - shift*64
+uint64_t LatencyHistogram::bucketLowest(size_t index)
+{
+    const size_t shift = index < (size_t(2) << sub_bucket_bits) ? 0 : (index >> sub_bucket_bits) - 1;
+    return static_cast<uint64_t>(index - (shift << sub_bucket_bits)) << shift;
+}
+
+uint64_t LatencyHistogram::bucketHighest(size_t index)
+{
+    const size_t shift = index < (size_t(2) << sub_bucket_bits) ? 0 : (index >> sub_bucket_bits) - 1;
+    return bucketLowest(index) + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (size_t index = 0; index < counts.size(); ++index)
+    {
+        counts[index] += other.counts[index];
+    }
+    total += other.total;
+    sum += other.sum;
+    minimum = other.minimum < minimum ? other.minimum : minimum;
+    maximum = other.maximum > maximum ? other.maximum : maximum;
+}
+
+void LatencyHistogram::reset()
+{
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    sum = 0;
+    minimum = std::numeric_limits<uint64_t>::max();
+    maximum = 0;
+}
+
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+    const double clamped = percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile);
+    //? The rank of the value asked for, counting from 1, so the 0th percentile is the smallest value
+    const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * total)));
+    uint64_t seen = 0;
+    for (size_t index = 0; index < counts.size(); ++index)
+    {
+        seen += counts[index];
+        if (seen >= rank)
+        {
+            const uint64_t highest = bucketHighest(index);
+            return highest < maximum ? highest : maximum;
+        }
+    }
+    return maximum;
+}
+
+//
+//! SECTION TreeMetrics
+//
+
+void TreeMetrics::endOperation(TreeOperation operation)
+{
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - started).count();
+    OperationStats &stats = totals.operations[static_cast<size_t>(operation)];
+    stats.count++;
+    stats.comparisons += comparisons;
+    stats.nodes_visited += visited;
+    stats.allocations += allocations;
+    stats.deallocations += deallocations;
+    stats.rotations += rotations;
+    stats.depth[visited < OperationStats::depth_buckets ? visited : OperationStats::depth_buckets - 1]++;
+    stats.latency.record(elapsed < 0 ? 0 : static_cast<uint64_t>(elapsed));
+}
+
+void TreeMetrics::reset()
+{
+    for (OperationStats &stats : totals.operations)
+    {
+        stats = OperationStats();
+    }
+}
+
+} // namespace models
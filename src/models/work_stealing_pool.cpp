@@ -0,0 +1,206 @@
+#include "models/work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <exception>
+
+namespace models
+{
+namespace
+{
+//? Lets a worker find its own queue when it forks work from inside a job
+thread_local const WorkStealingPool *current_pool = nullptr;
+thread_local size_t current_index = 0;
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t threads) : pending(0), stopping(false)
+{
+    for (size_t i = 0; i <= threads; ++i)
+    {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < threads; ++i)
+    {
+        workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+size_t WorkStealingPool::defaultThreadCount()
+{
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 0;
+}
+
+size_t WorkStealingPool::currentQueue() const
+{
+    return current_pool == this ? current_index : queues.size() - 1;
+}
+
+void WorkStealingPool::push(size_t queue, Job *job)
+{
+    {
+        std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+        queues[queue]->jobs.push_back(job);
+        pending++;
+    }
+
+    //? Taking the sleep mutex orders this push against a worker that has just seen pending == 0 and is about to wait
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    wake.notify_one();
+}
+
+bool WorkStealingPool::reclaim(size_t queue, Job *job)
+{
+    std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+    std::deque<Job *> &jobs = queues[queue]->jobs;
+    if (!jobs.empty() && jobs.back() == job)
+    {
+        jobs.pop_back();
+        pending--;
+        return true;
+    }
+    return false;
+}
+
+WorkStealingPool::Job *WorkStealingPool::findJob(size_t queue)
+{
+    //? Newest job of our own queue first, then the oldest job of every other queue
+    for (size_t offset = 0; offset < queues.size(); ++offset)
+    {
+        WorkQueue &candidate = *queues[(queue + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(candidate.mutex);
+        if (!candidate.jobs.empty())
+        {
+            Job *job;
+            if (offset == 0)
+            {
+                job = candidate.jobs.back();
+                candidate.jobs.pop_back();
+            }
+            else
+            {
+                job = candidate.jobs.front();
+                candidate.jobs.pop_front();
+            }
+            pending--;
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void WorkStealingPool::run(Job *job)
+{
+    try
+    {
+        job->work();
+    }
+    catch (...)
+    {
+        job->error = std::current_exception();
+    }
+    job->done.store(true, std::memory_order_release);
+}
+
+void WorkStealingPool::workerLoop(size_t index)
+{
+    current_pool = this;
+    current_index = index;
+
+    while (true)
+    {
+        if (Job *job = findJob(index))
+        {
+            run(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this]() { return stopping.load() || pending.load() > 0; });
+        if (stopping)
+        {
+            return;
+        }
+    }
+}
+
+void WorkStealingPool::parallelInvoke(const std::function<void()> &left, const std::function<void()> &right)
+{
+    Job job;
+    job.work = right;
+    const size_t queue = currentQueue();
+    push(queue, &job);
+
+    std::exception_ptr leftError;
+    try
+    {
+        left();
+    }
+    catch (...)
+    {
+        leftError = std::current_exception();
+    }
+
+    if (reclaim(queue, &job))
+    {
+        run(&job);
+    }
+    else
+    {
+        //? The job was stolen: keep busy with other jobs instead of blocking until the thief is done
+        while (!job.done.load(std::memory_order_acquire))
+        {
+            if (Job *other = findJob(queue))
+            {
+                run(other);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    if (leftError)
+    {
+        std::rethrow_exception(leftError);
+    }
+    if (job.error)
+    {
+        std::rethrow_exception(job.error);
+    }
+}
+
+void WorkStealingPool::parallelFor(size_t first, size_t last, size_t grain,
+                                   const std::function<void(size_t, size_t)> &body)
+{
+    if (first >= last)
+    {
+        return;
+    }
+    if (last - first <= std::max<size_t>(grain, 1))
+    {
+        body(first, last);
+        return;
+    }
+
+    const size_t middle = first + (last - first) / 2;
+    parallelInvoke([&]() { parallelFor(first, middle, grain, body); },
+                   [&]() { parallelFor(middle, last, grain, body); });
+}
+
+} // namespace models
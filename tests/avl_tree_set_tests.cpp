@@ -0,0 +1,296 @@
+#include "models/binary_tree_set.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace models;
+
+class AvlTreeSetTests : public ::testing::Test
+{
+  protected:
+    AvlTreeSet<int> tree;
+
+    void TearDown() override
+    {
+        tree.clear();
+    }
+
+    //? Returns the real height of the subtree, or -2 if the AVL or BST invariants (or a cached subtree size) are
+    //? broken anywhere below
+    static int checkAvlInvariants(const BinaryNode<int> *node, const int *low, const int *high)
+    {
+        if (!node)
+        {
+            return -1;
+        }
+        if ((low && node->value() <= *low) || (high && node->value() >= *high))
+        {
+            return -2;
+        }
+
+        int value = node->value();
+        int leftHeight = checkAvlInvariants(node->left(), low, &value);
+        int rightHeight = checkAvlInvariants(node->right(), &value, high);
+        if (leftHeight == -2 || rightHeight == -2 || std::abs(leftHeight - rightHeight) > 1)
+        {
+            return -2;
+        }
+
+        const size_t size = 1 + (node->left() ? node->left()->size() : 0) + (node->right() ? node->right()->size() : 0);
+        int height = 1 + std::max(leftHeight, rightHeight);
+        return height == node->height() && size == node->size() ? height : -2;
+    }
+
+    bool isValidAvlTree() const
+    {
+        return checkAvlInvariants(tree.getRoot(), nullptr, nullptr) != -2;
+    }
+};
+
+TEST_F(AvlTreeSetTests, DefaultConstructor)
+{
+    EXPECT_EQ(tree.size(), 0) << "Default constructor should create empty tree";
+    EXPECT_TRUE(tree.empty()) << "Default constructor should create empty tree";
+    EXPECT_EQ(tree.getRoot(), nullptr) << "Default constructor should have null root";
+    EXPECT_EQ(tree.height(), -1) << "Empty tree should have height -1";
+}
+
+TEST_F(AvlTreeSetTests, SortedInsertsStayBalanced)
+{
+    for (int i = 0; i < 1023; ++i)
+    {
+        tree.insert(i);
+    }
+
+    EXPECT_EQ(tree.size(), 1023) << "Tree should have 1023 elements";
+    EXPECT_EQ(tree.height(), 9) << "Sorted inserts of 2^10 - 1 values should build a perfect tree";
+    EXPECT_TRUE(isValidAvlTree()) << "AVL invariants should hold after sorted inserts";
+}
+
+TEST_F(AvlTreeSetTests, ReverseSortedInsertsStayBalanced)
+{
+    for (int i = 1000; i > 0; --i)
+    {
+        tree.insert(i);
+    }
+
+    EXPECT_EQ(tree.size(), 1000) << "Tree should have 1000 elements";
+    EXPECT_LE(tree.height(), 14) << "AVL height should stay within 1.44 * log2(n)";
+    EXPECT_TRUE(isValidAvlTree()) << "AVL invariants should hold after reverse sorted inserts";
+}
+
+TEST_F(AvlTreeSetTests, HeightLeftHeavyInsertOrder)
+{
+    tree.insert(50);
+    tree.insert(40);
+    tree.insert(30);
+    tree.insert(20);
+    tree.insert(10);
+
+    EXPECT_EQ(tree.height(), 2) << "Left-heavy insert order should be rotated down to height 2";
+    EXPECT_EQ(tree.getRoot()->value(), 40) << "Root should be rotated to 40";
+}
+
+TEST_F(AvlTreeSetTests, DoubleRotations)
+{
+    tree.insert(30);
+    tree.insert(10);
+    tree.insert(20);
+    EXPECT_EQ(tree.getRoot()->value(), 20) << "Left-right case should rotate 20 to the root";
+    EXPECT_EQ(tree.height(), 1) << "Left-right case should have height 1";
+
+    tree.clear();
+    tree.insert(10);
+    tree.insert(30);
+    tree.insert(20);
+    EXPECT_EQ(tree.getRoot()->value(), 20) << "Right-left case should rotate 20 to the root";
+    EXPECT_EQ(tree.height(), 1) << "Right-left case should have height 1";
+}
+
+TEST_F(AvlTreeSetTests, DuplicateInsertPrevention)
+{
+    tree.insert(42);
+    tree.insert(42);
+
+    EXPECT_EQ(tree.size(), 1) << "Size should remain 1 after duplicate inserts";
+    EXPECT_TRUE(tree.contains(42)) << "Tree should still contain the value";
+}
+
+TEST_F(AvlTreeSetTests, FindAndContains)
+{
+    tree.insertRange({50, 30, 70, 20, 40, 60, 80});
+
+    EXPECT_TRUE(tree.contains(40)) << "Tree should contain inserted value";
+    EXPECT_FALSE(tree.contains(45)) << "Tree should not contain value that was never inserted";
+    ASSERT_NE(tree.find(60), nullptr) << "Find should return non-null for existing value";
+    EXPECT_EQ(tree.find(60)->value(), 60) << "Found node should have correct value";
+    EXPECT_EQ(tree.find(65), nullptr) << "Find should return null for non-existent value";
+}
+
+TEST_F(AvlTreeSetTests, EraseKeepsBalance)
+{
+    for (int i = 0; i < 512; ++i)
+    {
+        tree.insert(i);
+    }
+
+    for (int i = 0; i < 512; i += 2)
+    {
+        EXPECT_TRUE(tree.erase(i)) << "Should successfully erase element: " << i;
+    }
+    EXPECT_FALSE(tree.erase(0)) << "Erasing a removed value should return false";
+
+    EXPECT_EQ(tree.size(), 256) << "Tree should have 256 elements after removal";
+    EXPECT_TRUE(isValidAvlTree()) << "AVL invariants should hold after erasing";
+    for (int i = 0; i < 512; ++i)
+    {
+        EXPECT_EQ(tree.contains(i), i % 2 == 1) << "Unexpected membership for element: " << i;
+    }
+}
+
+TEST_F(AvlTreeSetTests, EraseUntilEmpty)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        tree.insert((i * 37) % 100);
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(tree.erase(i)) << "Should successfully erase element: " << i;
+        EXPECT_TRUE(isValidAvlTree()) << "AVL invariants should hold after erasing: " << i;
+    }
+
+    EXPECT_TRUE(tree.empty()) << "Tree should be empty after erasing every value";
+    EXPECT_EQ(tree.height(), -1) << "Empty tree should have height -1";
+}
+
+TEST_F(AvlTreeSetTests, MergeTwoTrees)
+{
+    tree.insertRange({50, 30, 70});
+
+    AvlTreeSet<int> otherTree;
+    otherTree.insertRange({20, 30, 60, 80});
+
+    tree.merge(otherTree);
+
+    EXPECT_EQ(tree.size(), 6) << "Merged tree should have 6 unique elements";
+    EXPECT_EQ(otherTree.size(), 4) << "Original tree should remain unchanged";
+    EXPECT_TRUE(isValidAvlTree()) << "AVL invariants should hold after merge";
+}
+
+TEST_F(AvlTreeSetTests, FromSortedIsAvlBalanced)
+{
+    for (int count : {1, 2, 3, 10, 100, 1000})
+    {
+        std::vector<int> values;
+        for (int i = 0; i < count; ++i)
+        {
+            values.push_back(i * 2);
+        }
+        tree = AvlTreeSet<int>::fromSorted(values.begin(), values.end());
+
+        EXPECT_EQ(tree.size(), static_cast<size_t>(count)) << "Bulk load should hold every value";
+        EXPECT_TRUE(isValidAvlTree()) << "AVL invariants should hold after a bulk load of " << count;
+    }
+
+    tree.insert(1);
+    EXPECT_TRUE(tree.erase(0)) << "Should erase from a bulk loaded tree";
+    EXPECT_TRUE(isValidAvlTree()) << "AVL invariants should hold after modifying a bulk loaded tree";
+}
+
+TEST_F(AvlTreeSetTests, SetAlgebraIsAvlBalanced)
+{
+    for (int i = 0; i < 500; ++i)
+    {
+        tree.insert(i);
+    }
+    AvlTreeSet<int> other;
+    for (int i = 250; i < 1000; i += 3)
+    {
+        other.insert(i);
+    }
+
+    tree.unionWith(other);
+    EXPECT_TRUE(isValidAvlTree()) << "AVL invariants should hold after a union";
+    tree.symmetricDifference(other);
+    EXPECT_TRUE(isValidAvlTree()) << "AVL invariants should hold after a symmetric difference";
+    EXPECT_EQ(tree.size(), 500 - 84) << "Values shared with other should be gone";
+
+    tree.insert(251);
+    EXPECT_TRUE(tree.erase(0)) << "Should erase from a rebuilt tree";
+    EXPECT_TRUE(isValidAvlTree()) << "AVL invariants should hold after modifying a rebuilt tree";
+}
+
+TEST_F(AvlTreeSetTests, ParallelSetAlgebraIsAvlBalanced)
+{
+    WorkStealingPool pool(2);
+    for (int i = 0; i < 5000; ++i)
+    {
+        tree.insert(i);
+    }
+    AvlTreeSet<int> other;
+    for (int i = 2500; i < 10000; i += 3)
+    {
+        other.insert(i);
+    }
+
+    tree.unionWith(other, pool, 50);
+    EXPECT_TRUE(isValidAvlTree()) << "AVL invariants should hold after a parallel union";
+    tree.differenceWith(other, pool, 50);
+    EXPECT_TRUE(isValidAvlTree()) << "AVL invariants should hold after a parallel difference";
+    EXPECT_EQ(tree.size(), 5000 - 834) << "Values of other should be gone";
+}
+
+TEST_F(AvlTreeSetTests, IteratorsFollowRotations)
+{
+    std::vector<int> expected;
+    for (int i = 0; i < 500; ++i)
+    {
+        tree.insert(i);
+        expected.push_back(i);
+    }
+    for (int i = 0; i < 500; i += 3)
+    {
+        tree.erase(i);
+    }
+    expected.erase(std::remove_if(expected.begin(), expected.end(), [](int value) { return value % 3 == 0; }),
+                   expected.end());
+
+    EXPECT_EQ(std::vector<int>(tree.begin(), tree.end()), expected)
+        << "Parent pointers should stay consistent through rotations";
+    EXPECT_EQ(std::vector<int>(tree.rbegin(), tree.rend()), std::vector<int>(expected.rbegin(), expected.rend()))
+        << "Reverse iteration should match after rotations";
+}
+
+TEST_F(AvlTreeSetTests, InorderTraversal)
+{
+    for (int i = 10; i > 0; --i)
+    {
+        tree.insert(i);
+    }
+
+    std::vector<int> visited;
+    tree.traverseInorder([&visited](const int &value) { visited.push_back(value); });
+
+    std::vector<int> expected = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    EXPECT_EQ(visited, expected) << "Inorder traversal should visit nodes in ascending order";
+}
+
+TEST_F(AvlTreeSetTests, StringTree)
+{
+    AvlTreeSet<std::string> stringTree;
+    stringTree.insertRange({"apple", "banana", "cherry", "date", "elderberry"});
+
+    EXPECT_EQ(stringTree.size(), 5) << "String tree should have 5 elements";
+    EXPECT_EQ(stringTree.height(), 2) << "Sorted string inserts should stay balanced";
+    EXPECT_TRUE(stringTree.erase("banana")) << "Should erase existing string";
+    EXPECT_FALSE(stringTree.contains("banana")) << "String tree should not contain erased value";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
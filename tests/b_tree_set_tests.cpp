@@ -0,0 +1,192 @@
+#include "models/b_tree_set.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace models;
+
+class BTreeSetTests : public ::testing::Test
+{
+  protected:
+    BTreeSet<int> tree;
+
+    void TearDown() override
+    {
+        tree.clear();
+    }
+
+    template <typename Set> static std::vector<int> inorder(const Set &set)
+    {
+        std::vector<int> visited;
+        set.traverseInorder([&visited](const int &value) { visited.push_back(value); });
+        return visited;
+    }
+};
+
+TEST_F(BTreeSetTests, DefaultConstructor)
+{
+    EXPECT_EQ(tree.size(), 0) << "Default constructor should create empty set";
+    EXPECT_TRUE(tree.empty()) << "Default constructor should create empty set";
+    EXPECT_EQ(tree.height(), -1) << "Empty tree should have height -1";
+    EXPECT_FALSE(tree.contains(0)) << "Empty set should not contain any value";
+}
+
+TEST_F(BTreeSetTests, NodeCapacityFillsCacheLines)
+{
+    EXPECT_EQ(BTreeSet<int>::nodeCapacity(), 63) << "An int node should hold 63 keys (about 256 bytes)";
+    EXPECT_EQ(BTreeSet<double>::nodeCapacity(), 31) << "A double node should hold 31 keys (about 256 bytes)";
+    EXPECT_EQ((BTreeSet<int, 2>::nodeCapacity()), 3) << "Minimum degree 2 should hold 3 keys per node";
+}
+
+TEST_F(BTreeSetTests, InsertAndContains)
+{
+    tree.insertRange({50, 30, 70, 20, 40, 60, 80});
+
+    EXPECT_EQ(tree.size(), 7) << "Set should have 7 elements";
+    EXPECT_EQ(tree.height(), 0) << "Seven keys should fit in the root leaf";
+    for (int value : {20, 30, 40, 50, 60, 70, 80})
+    {
+        EXPECT_TRUE(tree.contains(value)) << "Set should contain value: " << value;
+    }
+    EXPECT_FALSE(tree.contains(45)) << "Set should not contain value that was never inserted";
+}
+
+TEST_F(BTreeSetTests, DuplicateInsertPrevention)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        tree.insert(42);
+    }
+    EXPECT_EQ(tree.size(), 1) << "Size should remain 1 after duplicate inserts";
+}
+
+TEST_F(BTreeSetTests, SortedInsertsStayShallow)
+{
+    for (int i = 0; i < 100000; ++i)
+    {
+        tree.insert(i);
+    }
+
+    EXPECT_EQ(tree.size(), 100000) << "Set should have 100000 elements";
+    EXPECT_LE(tree.height(), 3) << "A wide B-tree should need very few levels";
+    EXPECT_TRUE(tree.contains(0)) << "Set should contain smallest value";
+    EXPECT_TRUE(tree.contains(99999)) << "Set should contain largest value";
+}
+
+TEST_F(BTreeSetTests, InorderTraversal)
+{
+    for (int i = 500; i > 0; --i)
+    {
+        tree.insert(i);
+    }
+
+    std::vector<int> visited = inorder(tree);
+    ASSERT_EQ(visited.size(), 500) << "Traversal should visit every value";
+    for (int i = 0; i < 500; ++i)
+    {
+        EXPECT_EQ(visited[i], i + 1) << "Traversal should be ascending";
+    }
+}
+
+TEST_F(BTreeSetTests, EraseUntilEmpty)
+{
+    for (int i = 0; i < 1000; ++i)
+    {
+        tree.insert(i);
+    }
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(tree.erase(i)) << "Should successfully erase element: " << i;
+    }
+
+    EXPECT_FALSE(tree.erase(0)) << "Erasing from an empty set should return false";
+    EXPECT_TRUE(tree.empty()) << "Set should be empty after erasing every value";
+    EXPECT_EQ(tree.height(), -1) << "Empty tree should have height -1";
+    EXPECT_EQ(tree.allocationStats().bytes_in_use, 0) << "Every node should have been released";
+}
+
+TEST_F(BTreeSetTests, EraseNonExistentValue)
+{
+    tree.insertRange({10, 20, 30});
+
+    EXPECT_FALSE(tree.erase(25)) << "Erase should return false for non-existent value";
+    EXPECT_EQ(tree.size(), 3) << "Size should remain unchanged";
+}
+
+TEST_F(BTreeSetTests, RandomOperationsMatchStdSet)
+{
+    //? Minimum degree 2 forces splits, borrows and merges on most operations
+    BTreeSet<int, 2> small;
+    std::set<int> reference;
+    std::mt19937 engine(1234);
+    std::uniform_int_distribution<int> values(0, 2000);
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        const int value = values(engine);
+        if (engine() % 3 == 0)
+        {
+            EXPECT_EQ(small.erase(value), reference.erase(value) == 1) << "Erase result mismatch for: " << value;
+        }
+        else
+        {
+            small.insert(value);
+            reference.insert(value);
+        }
+        ASSERT_EQ(small.size(), reference.size()) << "Size mismatch at step " << step;
+    }
+
+    EXPECT_EQ(inorder(small), std::vector<int>(reference.begin(), reference.end())) << "Contents should match";
+    for (int value = 0; value <= 2000; ++value)
+    {
+        EXPECT_EQ(small.contains(value), reference.count(value) == 1) << "Membership mismatch for: " << value;
+    }
+}
+
+TEST_F(BTreeSetTests, MergeTwoSets)
+{
+    tree.insertRange({50, 30, 70});
+
+    BTreeSet<int> other;
+    other.insertRange({20, 30, 60, 80});
+
+    tree.merge(other);
+    EXPECT_EQ(tree.size(), 6) << "Merged set should have 6 unique elements";
+    EXPECT_EQ(other.size(), 4) << "Original set should remain unchanged";
+    EXPECT_EQ(inorder(tree), (std::vector<int>{20, 30, 50, 60, 70, 80})) << "Merged contents should be ascending";
+}
+
+TEST_F(BTreeSetTests, StringSet)
+{
+    BTreeSet<std::string> strings;
+    for (int i = 0; i < 1000; ++i)
+    {
+        strings.insert("a string long enough to be heap allocated #" + std::to_string(i));
+    }
+    for (int i = 0; i < 1000; i += 2)
+    {
+        EXPECT_TRUE(strings.erase("a string long enough to be heap allocated #" + std::to_string(i)));
+    }
+
+    EXPECT_EQ(strings.size(), 500) << "String set should have 500 elements left";
+    EXPECT_TRUE(strings.contains("a string long enough to be heap allocated #1")) << "Odd strings should remain";
+    EXPECT_FALSE(strings.contains("a string long enough to be heap allocated #0")) << "Even strings should be gone";
+    EXPECT_THROW(strings.insert(""), std::invalid_argument) << "Empty strings should be rejected like BinaryNode";
+}
+
+TEST_F(BTreeSetTests, DoubleSet)
+{
+    BTreeSet<double> doubles;
+    doubles.insertRange({3.14, 2.71, 1.41, 2.23});
+
+    EXPECT_TRUE(doubles.contains(2.71)) << "Double set should contain 2.71";
+    EXPECT_FALSE(doubles.contains(1.0)) << "Double set should not contain 1.0";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -60,6 +60,9 @@ TEST(BinaryNodeTest, ReadOnlyAccess)
     const BinaryNode<int> &constNode = node;
     EXPECT_EQ(constNode.left(), nullptr) << "left() should return nullptr for new node";
     EXPECT_EQ(constNode.right(), nullptr) << "right() should return nullptr for new node";
+    EXPECT_EQ(constNode.parent(), nullptr) << "parent() should return nullptr for new node";
+    EXPECT_EQ(constNode.height(), 0) << "height() should return 0 for new node";
+    EXPECT_EQ(constNode.size(), 1) << "size() should return 1 for new node";
 
     EXPECT_EQ(constNode.value(), 42) << "const value() should work";
     EXPECT_EQ(constNode.left(), nullptr) << "const left() should work";
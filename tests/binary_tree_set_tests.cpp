@@ -1,11 +1,69 @@
 #include "models/binary_tree_set.hpp"
 #include <algorithm>
+#include <cctype>
+#include <functional>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 using namespace models;
 
+namespace
+{
+//? Orders strings ignoring ASCII case
+struct CaseInsensitiveLess
+{
+    bool operator()(const std::string &left, const std::string &right) const
+    {
+        return std::lexicographical_compare(left.begin(), left.end(), right.begin(), right.end(), [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) < std::tolower(static_cast<unsigned char>(b));
+        });
+    }
+};
+
+struct Player
+{
+    std::string name;
+    int score;
+};
+
+//? Keys players by score, and lets them be looked up by a bare score
+struct ByScore
+{
+    using is_transparent = void;
+    bool operator()(const Player &left, const Player &right) const
+    {
+        return left.score < right.score;
+    }
+    bool operator()(const Player &left, int score) const
+    {
+        return left.score < score;
+    }
+    bool operator()(int score, const Player &right) const
+    {
+        return score < right.score;
+    }
+};
+
+//? A stateful comparator: orders values by their remainder modulo a runtime divisor
+struct ModuloLess
+{
+    int divisor;
+    bool operator()(int left, int right) const
+    {
+        return left % divisor < right % divisor;
+    }
+    bool operator==(const ModuloLess &other) const
+    {
+        return divisor == other.divisor;
+    }
+};
+} // namespace
+
 class BinaryTreeSetTests : public ::testing::Test
 {
   protected:
@@ -556,6 +614,788 @@ TEST_F(BinaryTreeSetTests, ComplexTreeStructure)
     EXPECT_TRUE(tree.contains(75)) << "Tree should still contain right subtree elements";
 }
 
+TEST_F(BinaryTreeSetTests, DeepSkewedTree)
+{
+    //? A degenerate tree deeper than a recursive implementation could walk without exhausting the stack
+    const int count = 20000;
+    for (int i = 0; i < count; ++i)
+    {
+        tree.insert(i);
+    }
+
+    EXPECT_EQ(tree.size(), count) << "Skewed tree should hold every value";
+    EXPECT_EQ(tree.height(), count - 1) << "Sorted inserts should build a right spine";
+    EXPECT_TRUE(tree.contains(count - 1)) << "Deepest value should be found";
+
+    long long inorderSum = 0, preorderSum = 0, postorderSum = 0;
+    int previous = -1;
+    bool ascending = true;
+    tree.traverseInorder([&](const int &value) {
+        ascending = ascending && value > previous;
+        previous = value;
+        inorderSum += value;
+    });
+    tree.traversePreorder([&preorderSum](const int &value) { preorderSum += value; });
+    tree.traversePostorder([&postorderSum](const int &value) { postorderSum += value; });
+
+    const long long expectedSum = static_cast<long long>(count) * (count - 1) / 2;
+    EXPECT_TRUE(ascending) << "Inorder traversal of skewed tree should be ascending";
+    EXPECT_EQ(inorderSum, expectedSum) << "Inorder traversal should visit every node";
+    EXPECT_EQ(preorderSum, expectedSum) << "Preorder traversal should visit every node";
+    EXPECT_EQ(postorderSum, expectedSum) << "Postorder traversal should visit every node";
+
+    EXPECT_TRUE(tree.erase(0)) << "Should erase the root of the spine";
+    EXPECT_EQ(tree.height(), count - 2) << "Height should shrink after erasing the root of the spine";
+
+    tree.clear();
+    EXPECT_TRUE(tree.empty()) << "Clearing a skewed tree should not overflow the stack";
+}
+
+TEST_F(BinaryTreeSetTests, TraversalOrdersOnIrregularTree)
+{
+    tree.insertRange({50, 30, 70, 35, 32, 80, 75, 90, 10});
+
+    std::vector<int> preorder, postorder;
+    tree.traversePreorder([&preorder](const int &value) { preorder.push_back(value); });
+    tree.traversePostorder([&postorder](const int &value) { postorder.push_back(value); });
+
+    std::vector<int> expectedPreorder = {50, 30, 10, 35, 32, 70, 80, 75, 90};
+    std::vector<int> expectedPostorder = {10, 32, 35, 30, 75, 90, 80, 70, 50};
+    EXPECT_EQ(preorder, expectedPreorder) << "Preorder traversal should handle one-child nodes";
+    EXPECT_EQ(postorder, expectedPostorder) << "Postorder traversal should handle one-child nodes";
+}
+
+TEST_F(BinaryTreeSetTests, FromSortedBuildsMinimalHeight)
+{
+    std::vector<int> values;
+    for (int i = 0; i < 1023; ++i)
+    {
+        values.push_back(i);
+    }
+    BinaryTreeSet<int> bulk = BinaryTreeSet<int>::fromSorted(values.begin(), values.end());
+
+    EXPECT_EQ(bulk.size(), 1023) << "Bulk load should hold every value";
+    EXPECT_EQ(bulk.height(), 9) << "2^10 - 1 sorted values should build a perfect tree";
+    EXPECT_EQ(bulk.getRoot()->value(), 511) << "The middle value should be the root";
+    EXPECT_EQ(bulk.allocationStats().system_allocations, 1) << "Every node should come from a single block";
+
+    std::vector<int> visited;
+    bulk.traverseInorder([&visited](const int &value) { visited.push_back(value); });
+    EXPECT_EQ(visited, values) << "Inorder traversal should return the input";
+
+    bulk.insert(2000);
+    EXPECT_TRUE(bulk.erase(0)) << "A bulk loaded tree should support further modification";
+    EXPECT_EQ(bulk.size(), 1023) << "Size should be tracked after further modification";
+}
+
+TEST_F(BinaryTreeSetTests, FromSortedSortsAndDeduplicates)
+{
+    const std::vector<int> values = {5, 3, 9, 3, 1, 9, 7, 5};
+    BinaryTreeSet<int> bulk = BinaryTreeSet<int>::fromSorted(values.begin(), values.end());
+
+    std::vector<int> visited;
+    bulk.traverseInorder([&visited](const int &value) { visited.push_back(value); });
+    EXPECT_EQ(visited, (std::vector<int>{1, 3, 5, 7, 9})) << "Unsorted input should be sorted and deduplicated";
+    EXPECT_EQ(bulk.height(), 2) << "Five values should build a tree of height 2";
+    for (const BinaryNode<int> *node = bulk.getRoot(); node; node = node->left())
+    {
+        EXPECT_TRUE(node->left() == nullptr || node->left()->parent() == node) << "Parent pointers should be linked";
+    }
+}
+
+TEST_F(BinaryTreeSetTests, FromSortedEmptyRange)
+{
+    const std::vector<int> values;
+    BinaryTreeSet<int> bulk = BinaryTreeSet<int>::fromSorted(values.begin(), values.end());
+
+    EXPECT_TRUE(bulk.empty()) << "An empty range should build an empty set";
+    EXPECT_EQ(bulk.height(), -1) << "Empty tree should have height -1";
+}
+
+TEST_F(BinaryTreeSetTests, FromSortedMovesStrings)
+{
+    std::vector<std::string> values;
+    for (int i = 0; i < 100; ++i)
+    {
+        values.push_back("a string long enough to be heap allocated #" + std::to_string(1000 + i));
+    }
+    auto bulk = BinaryTreeSet<std::string>::fromSorted(std::make_move_iterator(values.begin()),
+                                                        std::make_move_iterator(values.end()));
+
+    EXPECT_EQ(bulk.size(), 100) << "Bulk load should hold every moved string";
+    EXPECT_EQ(bulk.find("a string long enough to be heap allocated #1000")->value().size(), 47)
+        << "Moved strings should be intact";
+
+    std::vector<std::string> invalid = {"a", "", "b"};
+    EXPECT_THROW(BinaryTreeSet<std::string>::fromSorted(invalid.begin(), invalid.end()), std::invalid_argument)
+        << "Empty strings should be rejected like insert";
+}
+
+TEST_F(BinaryTreeSetTests, MoveConstructorTakesNodes)
+{
+    tree.insertRange({50, 30, 70});
+    const BinaryNode<int> *root = tree.getRoot();
+
+    BinaryTreeSet<int> moved(std::move(tree));
+    EXPECT_EQ(moved.getRoot(), root) << "Moving a set should keep its nodes in place";
+    EXPECT_EQ(moved.size(), 3) << "Moved set should hold every value";
+    EXPECT_TRUE(tree.empty()) << "Moved-from set should be empty";
+
+    tree = std::move(moved);
+    EXPECT_TRUE(tree.contains(30)) << "Move assignment should take the nodes back";
+    EXPECT_TRUE(moved.empty()) << "Move assigned-from set should be empty";
+}
+
+TEST_F(BinaryTreeSetTests, UnionWith)
+{
+    tree.insertRange({50, 30, 70, 10});
+    const BinaryNode<int> *kept = tree.find(30);
+
+    BinaryTreeSet<int> other;
+    other.insertRange({20, 30, 60, 80, 90});
+
+    tree.unionWith(other);
+    std::vector<int> visited;
+    tree.traverseInorder([&visited](const int &value) { visited.push_back(value); });
+    EXPECT_EQ(visited, (std::vector<int>{10, 20, 30, 50, 60, 70, 80, 90})) << "Union should hold values of both sets";
+    EXPECT_EQ(tree.size(), 8) << "Union should count shared values once";
+    EXPECT_EQ(tree.height(), 3) << "Union should rebuild a height-minimal tree";
+    EXPECT_EQ(tree.find(30), kept) << "Nodes of this set should be relinked, not reallocated";
+    EXPECT_EQ(other.size(), 5) << "The other set should remain unchanged";
+}
+
+TEST_F(BinaryTreeSetTests, UnionWithRvalueTakesNodes)
+{
+    tree.insertRange({50, 30, 70});
+
+    BinaryTreeSet<int> other;
+    other.insertRange({20, 30, 60});
+    const BinaryNode<int> *moved = other.find(60);
+    const size_t allocations = tree.allocationStats().allocations + other.allocationStats().allocations;
+
+    tree.unionWith(std::move(other));
+    EXPECT_EQ(tree.size(), 5) << "Union should hold values of both sets";
+    EXPECT_EQ(tree.find(60), moved) << "Nodes of an rvalue set should join this tree at their addresses";
+    EXPECT_EQ(tree.allocationStats().allocations, allocations) << "No node should be allocated";
+    EXPECT_EQ(tree.allocationStats().bytes_in_use, 5 * sizeof(BinaryNode<int>)) << "The duplicate should be freed";
+    EXPECT_TRUE(other.empty()) << "The rvalue set should be left empty";
+
+    tree.insert(40);
+    EXPECT_TRUE(tree.erase(60)) << "Adopted nodes should be erasable";
+}
+
+TEST_F(BinaryTreeSetTests, IntersectWith)
+{
+    tree.insertRange({50, 30, 70, 10, 90});
+
+    BinaryTreeSet<int> other;
+    other.insertRange({30, 60, 90, 100});
+
+    tree.intersectWith(other);
+    std::vector<int> visited;
+    tree.traverseInorder([&visited](const int &value) { visited.push_back(value); });
+    EXPECT_EQ(visited, (std::vector<int>{30, 90})) << "Intersection should hold only shared values";
+    EXPECT_EQ(tree.allocationStats().bytes_in_use, 2 * sizeof(BinaryNode<int>)) << "Dropped nodes should be freed";
+
+    tree.intersectWith(BinaryTreeSet<int>());
+    EXPECT_TRUE(tree.empty()) << "Intersection with an empty set should be empty";
+}
+
+TEST_F(BinaryTreeSetTests, DifferenceWith)
+{
+    tree.insertRange({50, 30, 70, 10, 90});
+
+    BinaryTreeSet<int> other;
+    other.insertRange({30, 60, 90, 100});
+
+    tree.differenceWith(other);
+    std::vector<int> visited;
+    tree.traverseInorder([&visited](const int &value) { visited.push_back(value); });
+    EXPECT_EQ(visited, (std::vector<int>{10, 50, 70})) << "Difference should drop values of the other set";
+
+    tree.differenceWith(tree);
+    EXPECT_TRUE(tree.empty()) << "The difference of a set with itself should be empty";
+}
+
+TEST_F(BinaryTreeSetTests, SymmetricDifference)
+{
+    tree.insertRange({50, 30, 70, 10, 90});
+
+    BinaryTreeSet<int> other;
+    other.insertRange({30, 60, 90, 100});
+
+    BinaryTreeSet<int> copy;
+    copy.insertRange({30, 60, 90, 100});
+    BinaryTreeSet<int> moved;
+    moved.insertRange({50, 30, 70, 10, 90});
+
+    tree.symmetricDifference(other);
+    moved.symmetricDifference(std::move(copy));
+
+    std::vector<int> visited, visitedMoved;
+    tree.traverseInorder([&visited](const int &value) { visited.push_back(value); });
+    moved.traverseInorder([&visitedMoved](const int &value) { visitedMoved.push_back(value); });
+    EXPECT_EQ(visited, (std::vector<int>{10, 50, 60, 70, 100})) << "Values in exactly one set should remain";
+    EXPECT_EQ(visitedMoved, visited) << "The rvalue variant should give the same result";
+    EXPECT_TRUE(copy.empty()) << "The rvalue set should be left empty";
+}
+
+TEST_F(BinaryTreeSetTests, SetAlgebraOnLargeSets)
+{
+    std::vector<int> evens, multiplesOfThree;
+    for (int i = 0; i < 30000; i += 2)
+    {
+        evens.push_back(i);
+    }
+    for (int i = 0; i < 30000; i += 3)
+    {
+        multiplesOfThree.push_back(i);
+    }
+    auto left = BinaryTreeSet<int>::fromSorted(evens.begin(), evens.end());
+    auto right = BinaryTreeSet<int>::fromSorted(multiplesOfThree.begin(), multiplesOfThree.end());
+
+    left.unionWith(right);
+    EXPECT_EQ(left.size(), 20000) << "Union should count multiples of 2 or 3";
+    left.differenceWith(right);
+    EXPECT_EQ(left.size(), 10000) << "Difference should keep even non-multiples of 3";
+    left.intersectWith(right);
+    EXPECT_TRUE(left.empty()) << "Nothing should remain after intersecting disjoint sets";
+}
+
+TEST_F(BinaryTreeSetTests, ParallelSetAlgebraMatchesSequential)
+{
+    //? A small grain splits the work into many pieces spread over the workers
+    WorkStealingPool pool(3);
+    std::vector<int> left, right;
+    for (int i = 0; i < 20000; ++i)
+    {
+        left.push_back(i * 2);
+        right.push_back(i * 3 + 1000);
+    }
+
+    for (int operation = 0; operation < 4; ++operation)
+    {
+        auto sequential = BinaryTreeSet<int>::fromSorted(left.begin(), left.end());
+        auto parallel = BinaryTreeSet<int>::fromSorted(left.begin(), left.end());
+        auto other = BinaryTreeSet<int>::fromSorted(right.begin(), right.end());
+
+        switch (operation)
+        {
+        case 0:
+            sequential.unionWith(other);
+            parallel.unionWith(other, pool, 100);
+            break;
+        case 1:
+            sequential.intersectWith(other);
+            parallel.intersectWith(other, pool, 100);
+            break;
+        case 2:
+            sequential.differenceWith(other);
+            parallel.differenceWith(other, pool, 100);
+            break;
+        default:
+            sequential.symmetricDifference(other);
+            parallel.symmetricDifference(other, pool, 100);
+            break;
+        }
+
+        std::vector<int> expected, actual;
+        sequential.traverseInorder([&expected](const int &value) { expected.push_back(value); });
+        parallel.traverseInorder([&actual](const int &value) { actual.push_back(value); });
+        EXPECT_EQ(actual, expected) << "Parallel result should match the sequential one for operation " << operation;
+        EXPECT_EQ(parallel.size(), sequential.size()) << "Parallel size mismatch for operation " << operation;
+        EXPECT_EQ(parallel.height(), sequential.height()) << "Both results should be height-minimal";
+        EXPECT_EQ(parallel.allocationStats().bytes_in_use, parallel.size() * sizeof(BinaryNode<int>))
+            << "Piece allocators should be adopted with exact counters for operation " << operation;
+    }
+}
+
+TEST_F(BinaryTreeSetTests, ParallelMergeStrings)
+{
+    WorkStealingPool pool(2);
+    BinaryTreeSet<std::string> strings, other;
+    for (int i = 0; i < 3000; ++i)
+    {
+        strings.insert("left #" + std::to_string(i));
+        other.insert("right #" + std::to_string(i));
+    }
+    other.insert("left #7");
+
+    strings.merge(other, pool, 64);
+    EXPECT_EQ(strings.size(), 6000) << "Parallel merge should count shared strings once";
+    EXPECT_TRUE(strings.contains("right #2999")) << "Merged strings should be found";
+    EXPECT_EQ(other.size(), 3001) << "The other set should remain unchanged";
+
+    strings.intersectWith(other, pool, 64);
+    EXPECT_EQ(strings.size(), 3001) << "Parallel intersection should keep the strings of other";
+    strings.differenceWith(strings, pool);
+    EXPECT_TRUE(strings.empty()) << "The parallel difference of a set with itself should be empty";
+}
+
+TEST_F(BinaryTreeSetTests, ParallelBuildMatchesSequential)
+{
+    WorkStealingPool pool(3);
+    //? Random values with many duplicates, then the same values sorted, which takes the path without a scatter
+    std::vector<int> values;
+    for (int i = 0; i < 50000; ++i)
+    {
+        values.push_back(static_cast<int>((i * 7919u) % 20011u));
+    }
+    std::vector<int> sortedValues = values;
+    std::sort(sortedValues.begin(), sortedValues.end());
+
+    const auto sequential = BinaryTreeSet<int>::fromSorted(values.begin(), values.end());
+    for (const std::vector<int> *input : {&values, &sortedValues})
+    {
+        for (size_t grain : {size_t(100), size_t(4096), default_parallel_grain})
+        {
+            const auto parallel = BinaryTreeSet<int>::fromSorted(input->begin(), input->end(), pool, grain);
+            EXPECT_EQ(std::vector<int>(parallel.begin(), parallel.end()),
+                      std::vector<int>(sequential.begin(), sequential.end()))
+                << "A parallel build with grain " << grain << " should hold the same values";
+            EXPECT_EQ(parallel.height(), sequential.height()) << "A parallel build should be height-minimal";
+            EXPECT_EQ(parallel.getRoot()->size(), parallel.size()) << "Subtree sizes should be set";
+            EXPECT_EQ(parallel.allocationStats().bytes_in_use, parallel.size() * sizeof(BinaryNode<int>))
+                << "Bucket allocators should be adopted with exact counters";
+        }
+    }
+
+    const std::vector<int> allEqual(1000, 5);
+    EXPECT_EQ(BinaryTreeSet<int>::fromSorted(allEqual.begin(), allEqual.end(), pool, 10).size(), 1)
+        << "Equal values should collapse into one even across buckets";
+
+    BinaryTreeSet<int> target;
+    target.insertRange(values, pool, 1000);
+    EXPECT_EQ(target.size(), sequential.size()) << "A parallel insertRange into an empty set should build it";
+    target.insertRange({-1, 0, 30000}, pool, 1000);
+    EXPECT_EQ(target.size(), sequential.size() + 2) << "A parallel insertRange should merge into a filled set";
+    EXPECT_TRUE(target.contains(-1) && target.contains(30000)) << "Merged values should be found";
+    EXPECT_EQ(target.allocationStats().allocations, sequential.size() + 3)
+        << "The values built for a parallel insertRange should be relinked, not copied again";
+    EXPECT_EQ(target.allocationStats().bytes_in_use, target.size() * sizeof(BinaryNode<int>))
+        << "The duplicate built node should be destroyed";
+
+    std::vector<std::string> strings;
+    for (int i = 0; i < 5000; ++i)
+    {
+        strings.push_back("key #" + std::to_string((i * 31) % 4000));
+    }
+    auto parallelStrings = BinaryTreeSet<std::string>::fromSorted(strings.begin(), strings.end(), pool, 64);
+    EXPECT_EQ(parallelStrings.size(), 4000) << "Parallel string builds should drop duplicates";
+    EXPECT_TRUE(std::is_sorted(parallelStrings.begin(), parallelStrings.end())) << "Strings should come out in order";
+    strings[4321].clear();
+    EXPECT_THROW(BinaryTreeSet<std::string>::fromSorted(strings.begin(), strings.end(), pool, 64),
+                 std::invalid_argument)
+        << "An empty string should still be rejected, with the nodes created so far destroyed";
+}
+
+TEST_F(BinaryTreeSetTests, IteratorsVisitValuesInOrder)
+{
+    tree.insertRange({50, 30, 70, 20, 40, 60, 80, 35, 45});
+
+    std::vector<int> forward(tree.begin(), tree.end());
+    EXPECT_EQ(forward, std::vector<int>({20, 30, 35, 40, 45, 50, 60, 70, 80})) << "Iteration should be ascending";
+
+    std::vector<int> backward(tree.rbegin(), tree.rend());
+    EXPECT_EQ(backward, std::vector<int>({80, 70, 60, 50, 45, 40, 35, 30, 20})) << "Reverse iteration should descend";
+
+    EXPECT_EQ(std::distance(tree.cbegin(), tree.cend()), 9) << "The distance should match the size";
+    EXPECT_EQ(*std::prev(tree.end()), 80) << "Decrementing end() should yield the largest value";
+    EXPECT_EQ(*std::max_element(tree.begin(), tree.end()), 80) << "Iterators should work with <algorithm>";
+    EXPECT_EQ(std::count_if(tree.begin(), tree.end(), [](int value) { return value % 10 == 5; }), 2)
+        << "count_if should see every value once";
+
+    BinaryTreeSet<int>::const_iterator it = tree.lower_bound(40);
+    EXPECT_EQ(*it++, 40) << "Post-increment should return the old position";
+    EXPECT_EQ(*it--, 45) << "Post-decrement should return the old position";
+    EXPECT_EQ(*--it, 35) << "Pre-decrement should step to the predecessor";
+
+    int sum = 0;
+    for (int value : tree)
+    {
+        sum += value;
+    }
+    EXPECT_EQ(sum, 430) << "Range-for should visit every value";
+}
+
+TEST_F(BinaryTreeSetTests, IteratorsOnEmptyTree)
+{
+    EXPECT_TRUE(tree.begin() == tree.end()) << "begin() should equal end() on an empty tree";
+    EXPECT_TRUE(tree.rbegin() == tree.rend()) << "rbegin() should equal rend() on an empty tree";
+    EXPECT_TRUE(tree.lower_bound(1) == tree.end()) << "lower_bound should return end() on an empty tree";
+}
+
+TEST_F(BinaryTreeSetTests, BoundLookups)
+{
+    tree.insertRange({10, 20, 30, 40, 50});
+
+    EXPECT_EQ(*tree.lower_bound(30), 30) << "lower_bound should find an equal value";
+    EXPECT_EQ(*tree.lower_bound(31), 40) << "lower_bound should find the next larger value";
+    EXPECT_EQ(*tree.lower_bound(-5), 10) << "lower_bound below the minimum should return the first value";
+    EXPECT_TRUE(tree.lower_bound(51) == tree.end()) << "lower_bound past the maximum should return end()";
+
+    EXPECT_EQ(*tree.upper_bound(30), 40) << "upper_bound should skip an equal value";
+    EXPECT_EQ(*tree.upper_bound(29), 30) << "upper_bound should find the next larger value";
+    EXPECT_TRUE(tree.upper_bound(50) == tree.end()) << "upper_bound of the maximum should return end()";
+
+    auto hit = tree.equal_range(20);
+    EXPECT_EQ(std::distance(hit.first, hit.second), 1) << "equal_range of a stored value should hold one value";
+    EXPECT_EQ(*hit.first, 20) << "equal_range should start at the value";
+    auto miss = tree.equal_range(25);
+    EXPECT_TRUE(miss.first == miss.second) << "equal_range of a missing value should be empty";
+    EXPECT_EQ(*miss.first, 30) << "An empty equal_range should sit at the insertion point";
+
+    std::vector<int> window(tree.lower_bound(15), tree.upper_bound(40));
+    EXPECT_EQ(window, std::vector<int>({20, 30, 40})) << "Bounds should delimit a value range";
+}
+
+TEST_F(BinaryTreeSetTests, IteratorSurvivesOtherErasures)
+{
+    tree.insertRange({5, 3, 8, 1, 4, 7, 9});
+    BinaryTreeSet<int>::const_iterator it = tree.lower_bound(7);
+    tree.erase(5);
+    tree.erase(9);
+    tree.erase(3);
+
+    std::vector<int> rest(it, tree.end());
+    EXPECT_EQ(rest, std::vector<int>({7, 8})) << "Erasing the value before it should not invalidate an iterator";
+}
+
+TEST_F(BinaryTreeSetTests, TraversalStopsWhenCallbackReturnsFalse)
+{
+    tree.insertRange({50, 30, 70, 20, 40, 60, 80});
+
+    std::vector<int> visited;
+    bool completed = tree.traverseInorder([&visited](int value) {
+        visited.push_back(value);
+        return value < 40;
+    });
+    EXPECT_FALSE(completed) << "An inorder traversal stopped by the callback should report it";
+    EXPECT_EQ(visited, std::vector<int>({20, 30, 40})) << "Inorder traversal should stop right after false";
+
+    visited.clear();
+    completed = tree.traversePreorder([&visited](int value) {
+        visited.push_back(value);
+        return visited.size() < 2;
+    });
+    EXPECT_FALSE(completed) << "A preorder traversal stopped by the callback should report it";
+    EXPECT_EQ(visited, std::vector<int>({50, 30})) << "Preorder traversal should stop right after false";
+
+    visited.clear();
+    completed = tree.traversePostorder([&visited](int value) {
+        visited.push_back(value);
+        return true;
+    });
+    EXPECT_TRUE(completed) << "A traversal the callback never stops should report completion";
+    EXPECT_EQ(visited, std::vector<int>({20, 40, 30, 60, 80, 70, 50})) << "Postorder should visit every value";
+}
+
+TEST_F(BinaryTreeSetTests, TraversalAcceptsAnyCallable)
+{
+    tree.insertRange({3, 1, 2});
+
+    struct Summer
+    {
+        int sum = 0;
+        void operator()(const int &value)
+        {
+            sum += value;
+        }
+    } summer;
+    EXPECT_TRUE(tree.traverseInorder(summer)) << "A void callable should visit every value";
+    EXPECT_EQ(summer.sum, 6) << "The callable should be taken by reference, not copied";
+
+    std::function<void(const int &)> function = [&summer](const int &value) { summer.sum += value; };
+    tree.traversePreorder(function);
+    EXPECT_EQ(summer.sum, 12) << "The std::function overload should still work";
+
+    BinaryTreeSet<std::string> strings;
+    strings.insertRange({"pear", "apple", "fig"});
+    const std::string *first = nullptr;
+    strings.traverseInorder([&first](const std::string &value) {
+        first = &value;
+        return false;
+    });
+    ASSERT_NE(first, nullptr) << "The callback should have been called once";
+    EXPECT_EQ(*first, "apple") << "Callbacks should receive a reference to the stored value";
+}
+
+TEST_F(BinaryTreeSetTests, RankAndSelect)
+{
+    tree.insertRange({50, 30, 70, 20, 40, 60, 80});
+
+    EXPECT_EQ(tree.rank(20), 0) << "The smallest value should have rank 0";
+    EXPECT_EQ(tree.rank(50), 3) << "rank should count the smaller values";
+    EXPECT_EQ(tree.rank(55), 4) << "rank of a missing value should count the smaller values";
+    EXPECT_EQ(tree.rank(100), 7) << "rank past the maximum should be the size";
+    EXPECT_EQ(tree.rank(-1), 0) << "rank below the minimum should be 0";
+
+    EXPECT_EQ(*tree.select(0), 20) << "select(0) should return the smallest value";
+    EXPECT_EQ(*tree.select(4), 60) << "select should return the k-th smallest value";
+    EXPECT_EQ(*tree.select(6), 80) << "select(size - 1) should return the largest value";
+    EXPECT_TRUE(tree.select(7) == tree.end()) << "select past the end should return end()";
+
+    BinaryTreeSet<int> empty;
+    EXPECT_EQ(empty.rank(5), 0) << "rank on an empty tree should be 0";
+    EXPECT_TRUE(empty.select(0) == empty.end()) << "select on an empty tree should return end()";
+}
+
+TEST_F(BinaryTreeSetTests, CountRangeAndForEachInRange)
+{
+    for (int i = 0; i < 100; i += 2)
+    {
+        tree.insert(i);
+    }
+
+    EXPECT_EQ(tree.countRange(10, 20), 5) << "[10, 20) should hold 10, 12, 14, 16, 18";
+    EXPECT_EQ(tree.countRange(11, 21), 5) << "Bounds between values should work";
+    EXPECT_EQ(tree.countRange(-100, 1000), 50) << "A range around everything should count every value";
+    EXPECT_EQ(tree.countRange(20, 10), 0) << "An inverted range should be empty";
+    EXPECT_EQ(tree.countRange(10, 10), 0) << "An empty range should be empty";
+
+    std::vector<int> visited;
+    EXPECT_TRUE(tree.forEachInRange(10, 20, [&visited](int value) { visited.push_back(value); }))
+        << "A void callback should visit the whole range";
+    EXPECT_EQ(visited, std::vector<int>({10, 12, 14, 16, 18})) << "forEachInRange should visit [first, last)";
+
+    visited.clear();
+    EXPECT_FALSE(tree.forEachInRange(0, 100, [&visited](int value) {
+        visited.push_back(value);
+        return value < 4;
+    })) << "A callback returning false should stop the walk";
+    EXPECT_EQ(visited, std::vector<int>({0, 2, 4})) << "forEachInRange should stop right after false";
+
+    visited.clear();
+    tree.forEachInRange(97, 1000, [&visited](int value) { visited.push_back(value); });
+    EXPECT_EQ(visited, std::vector<int>({98})) << "A range past the last value should stop at the end";
+}
+
+TEST_F(BinaryTreeSetTests, OrderStatisticsFollowUpdates)
+{
+    //? Erasures of nodes with two children and the relinking set operations must keep every subtree size right
+    for (int i = 0; i < 300; ++i)
+    {
+        tree.insert((i * 7919) % 1000);
+    }
+    for (int i = 0; i < 1000; i += 5)
+    {
+        tree.erase(i);
+    }
+    BinaryTreeSet<int> other;
+    for (int i = 0; i < 1000; i += 3)
+    {
+        other.insert(i);
+    }
+    tree.symmetricDifference(other);
+    other.insertRange({5, 6, 7});
+    tree.merge(other);
+
+    std::vector<int> values(tree.begin(), tree.end());
+    bool consistent = true;
+    for (size_t k = 0; k < values.size(); ++k)
+    {
+        consistent = consistent && tree.rank(values[k]) == k && *tree.select(k) == values[k];
+    }
+    EXPECT_TRUE(consistent) << "rank and select should match the inorder positions";
+    const auto inWindow = std::count_if(values.begin(), values.end(), [](int v) { return v >= 100 && v < 600; });
+    EXPECT_EQ(tree.countRange(100, 600), static_cast<size_t>(inWindow)) << "countRange should match a linear count";
+    EXPECT_EQ(tree.getRoot()->size(), tree.size()) << "The root's subtree size should be the set size";
+}
+
+TEST_F(BinaryTreeSetTests, InsertMovesAndEmplaces)
+{
+    BinaryTreeSet<std::string> strings;
+    std::string value(64, 'x');
+    strings.insert(std::move(value));
+    EXPECT_TRUE(strings.contains(std::string(64, 'x'))) << "An rvalue should be inserted";
+    EXPECT_TRUE(value.empty()) << "An inserted rvalue should have been moved from";
+
+    std::string duplicate(64, 'x');
+    strings.insert(std::move(duplicate));
+    EXPECT_EQ(duplicate.size(), 64) << "A duplicate rvalue should not be moved from";
+
+    strings.emplace(3, 'a');
+    strings.emplace("emplaced");
+    EXPECT_TRUE(strings.contains("aaa")) << "emplace should construct the value from its arguments";
+    EXPECT_TRUE(strings.contains("emplaced")) << "emplace should accept a single argument";
+    EXPECT_EQ(strings.size(), 3) << "Duplicates should not be inserted by any overload";
+    EXPECT_THROW(strings.emplace(""), std::invalid_argument) << "Emplaced strings should still be validated";
+}
+
+TEST_F(BinaryTreeSetTests, HeterogeneousLookup)
+{
+    BinaryTreeSet<std::string> strings;
+    strings.insertRange({"apple", "banana", "cherry"});
+
+    const std::string_view view = "banana split";
+    EXPECT_TRUE(strings.contains(view.substr(0, 6))) << "A string_view key should be found without conversion";
+    EXPECT_FALSE(strings.contains(view)) << "A longer string_view should not match";
+    EXPECT_TRUE(strings.contains("cherry")) << "A string literal key should be found";
+    ASSERT_NE(strings.find(std::string_view("apple")), nullptr) << "find should accept a string_view";
+    EXPECT_EQ(strings.find(std::string_view("apple"))->value(), "apple") << "find should return the matching node";
+    EXPECT_EQ(strings.find(std::string_view("fig")), nullptr) << "find should miss a missing key";
+}
+
+TEST_F(BinaryTreeSetTests, BatchLookupsMatchSingleLookups)
+{
+    std::vector<int> keys(100);
+    EXPECT_NO_THROW(tree.containsBatch(keys.data(), 0, nullptr)) << "An empty batch should do nothing";
+    bool empty[3] = {true, true, true};
+    tree.containsBatch(keys.data(), 3, empty);
+    EXPECT_EQ(std::count(empty, empty + 3, true), 0) << "Nothing should be found in an empty tree";
+
+    //? An unbalanced shape, so lookups in the same batch end at very different depths
+    for (int value = 0; value < 60; value += 2)
+    {
+        tree.insert(value % 7 == 0 ? 200 - value : value);
+    }
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        keys[i] = static_cast<int>((i * 37) % 211);
+    }
+    std::unique_ptr<bool[]> found(new bool[keys.size()]);
+    std::vector<BinaryNode<int> *> nodes(keys.size());
+    tree.containsBatch(keys.data(), keys.size(), found.get());
+    tree.findBatch(keys.data(), keys.size(), nodes.data());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        EXPECT_EQ(found[i], tree.contains(keys[i])) << "containsBatch should agree with contains on " << keys[i];
+        EXPECT_EQ(nodes[i], tree.find(keys[i])) << "findBatch should agree with find on " << keys[i];
+    }
+
+    BinaryTreeSet<std::string, AvlBalanced, NodeArena<BinaryNode<std::string>>, CaseInsensitiveLess> words;
+    words.insertRange({"Apple", "banana", "Cherry"});
+    const std::string probes[] = {"APPLE", "fig", "cherry"};
+    bool wordFound[3];
+    words.containsBatch(probes, 3, wordFound);
+    EXPECT_TRUE(wordFound[0] && !wordFound[1] && wordFound[2]) << "Batches should use the set's comparator";
+}
+
+TEST_F(BinaryTreeSetTests, EraseRelinksSuccessorAcrossLevels)
+{
+    //? Erase every inner node in turn, both with the successor as the direct right child and deeper down
+    tree.insertRange({50, 30, 70, 20, 40, 60, 80, 35, 45, 65, 75, 85, 62});
+    std::vector<int> expected(tree.begin(), tree.end());
+    for (int value : {50, 30, 70, 60, 62})
+    {
+        const BinaryNode<int> *successor = tree.find(*tree.upper_bound(value));
+        ASSERT_TRUE(tree.erase(value)) << "Erase should find " << value;
+        expected.erase(std::find(expected.begin(), expected.end(), value));
+        EXPECT_EQ(std::vector<int>(tree.begin(), tree.end()), expected) << "Order should survive erasing " << value;
+        EXPECT_EQ(tree.find(successor->value()), successor) << "The successor of " << value << " should keep its node";
+        EXPECT_EQ(tree.getRoot()->size(), tree.size()) << "Subtree sizes should survive erasing " << value;
+    }
+}
+
+TEST_F(BinaryTreeSetTests, CustomComparatorOrdersValues)
+{
+    BinaryTreeSet<int, AvlBalanced, NodeArena<BinaryNode<int>>, std::greater<>> descending;
+    descending.insertRange({5, 1, 9, 3, 7});
+    descending.erase(9);
+    EXPECT_EQ(std::vector<int>(descending.begin(), descending.end()), std::vector<int>({7, 5, 3, 1}))
+        << "std::greater should iterate in descending order";
+    EXPECT_EQ(*descending.lower_bound(4), 3) << "lower_bound should follow the comparator";
+    EXPECT_EQ(descending.rank(5), 1) << "rank should count the values ordered before";
+    EXPECT_TRUE(descending.contains(3)) << "contains should follow the comparator";
+
+    const std::vector<int> values = {2, 8, 4, 8, 6};
+    auto built = decltype(descending)::fromSorted(values.begin(), values.end());
+    EXPECT_EQ(std::vector<int>(built.begin(), built.end()), std::vector<int>({8, 6, 4, 2}))
+        << "fromSorted should sort and deduplicate with the comparator";
+    descending.unionWith(built);
+    EXPECT_EQ(std::vector<int>(descending.begin(), descending.end()), std::vector<int>({8, 7, 6, 5, 4, 3, 2, 1}))
+        << "Set algebra should merge in comparator order";
+
+    BinaryTreeSet<std::string, Unbalanced, NodeArena<BinaryNode<std::string>>, CaseInsensitiveLess> words;
+    words.insertRange({"Banana", "apple", "APPLE", "cherry"});
+    EXPECT_EQ(words.size(), 3) << "Values equal under the comparator should be duplicates";
+    EXPECT_TRUE(words.contains("BANANA")) << "Lookups should use the comparator";
+    EXPECT_EQ(*words.begin(), "apple") << "The first inserted of equal values should be kept";
+}
+
+TEST_F(BinaryTreeSetTests, ComparatorKeysStructsByField)
+{
+    BinaryTreeSet<Player, AvlBalanced, NodeArena<BinaryNode<Player>>, ByScore> leaderboard;
+    leaderboard.insert({"ada", 120});
+    leaderboard.insert({"bob", 80});
+    leaderboard.emplace(Player{"cyd", 150});
+
+    EXPECT_TRUE(leaderboard.contains(80)) << "A transparent comparator should allow lookup by score";
+    ASSERT_NE(leaderboard.find(150), nullptr) << "find should accept the score";
+    EXPECT_EQ(leaderboard.find(150)->value().name, "cyd") << "find should return the player with that score";
+    EXPECT_EQ(leaderboard.select(1)->name, "ada") << "select should follow the score order";
+}
+
+TEST_F(BinaryTreeSetTests, ComparatorStorage)
+{
+    static_assert(sizeof(BinaryTreeSet<int, Unbalanced, NodeArena<BinaryNode<int>>, std::greater<>>) ==
+                      sizeof(BinaryTreeSet<int>),
+                  "A stateless comparator should take no space");
+    EXPECT_GT((sizeof(BinaryTreeSet<int, Unbalanced, NodeArena<BinaryNode<int>>, ModuloLess>)),
+              sizeof(BinaryTreeSet<int>))
+        << "A stateful comparator should be stored";
+
+    BinaryTreeSet<int, Unbalanced, NodeArena<BinaryNode<int>>, ModuloLess> byRemainder(ModuloLess{10});
+    byRemainder.insertRange({13, 21, 32, 23, 40});
+    EXPECT_EQ(std::vector<int>(byRemainder.begin(), byRemainder.end()), std::vector<int>({40, 21, 32, 13}))
+        << "The comparator state should decide the order and the duplicates";
+
+    auto moved = std::move(byRemainder);
+    EXPECT_EQ(moved.key_comp().divisor, 10) << "Moving a set should carry its comparator along";
+    moved.insert(55);
+    EXPECT_EQ(*moved.rbegin(), 55) << "The moved-to set should keep ordering by the comparator";
+}
+
+TEST_F(BinaryTreeSetTests, MoveAssignmentCarriesStatefulComparators)
+{
+    //? A lambda with captures has no copy assignment, yet the assigned set must order by the captured direction
+    auto ordered = [](bool descending) {
+        return [descending](int left, int right) { return descending ? right < left : left < right; };
+    };
+    using Set = BinaryTreeSet<int, AvlBalanced, NodeArena<BinaryNode<int>>, decltype(ordered(false))>;
+    static_assert(!std::is_copy_assignable_v<decltype(ordered(false))>, "The lambda should not be assignable");
+
+    Set ascending(ordered(false));
+    Set descending(ordered(true));
+    ascending.insertRange({1, 2, 3});
+    descending.insertRange({5, 7, 9});
+    ascending = std::move(descending);
+    EXPECT_TRUE(ascending.contains(7)) << "The assigned set should search with the comparator that ordered its nodes";
+    ascending.insert(100);
+    EXPECT_EQ(std::vector<int>(ascending.begin(), ascending.end()), std::vector<int>({100, 9, 7, 5}))
+        << "New values should be ordered by the assigned comparator";
+
+    BinaryTreeSet<int, Unbalanced, NodeArena<BinaryNode<int>>, ModuloLess> byTen(ModuloLess{10});
+    BinaryTreeSet<int, Unbalanced, NodeArena<BinaryNode<int>>, ModuloLess> bySeven(ModuloLess{7});
+    bySeven.insertRange({8, 20});
+    byTen = std::move(bySeven);
+    EXPECT_EQ(byTen.key_comp().divisor, 7) << "An assignable comparator should be assigned along with the nodes";
+    EXPECT_TRUE(byTen.contains(15)) << "15 is equivalent to 8 modulo 7";
+}
+
+TEST_F(BinaryTreeSetTests, SetAlgebraNeedsEqualComparators)
+{
+    using Set = BinaryTreeSet<int, AvlBalanced, NodeArena<BinaryNode<int>>, ModuloLess>;
+    Set left(ModuloLess{10});
+    Set right(ModuloLess{10});
+    left.insertRange({1, 2, 3});
+    right.insertRange({13, 14});
+    left.unionWith(right);
+    EXPECT_EQ(std::vector<int>(left.begin(), left.end()), std::vector<int>({1, 2, 3, 14}))
+        << "Sets with equal comparators should merge, 13 being equivalent to 3";
+
+    Set other(ModuloLess{7});
+    other.insertRange({5, 7});
+    Set merged(ModuloLess{10});
+    merged.insertRange({15, 26});
+    merged.merge(other);
+    EXPECT_EQ(merged.size(), 3) << "merge inserts one by one, so other's comparator may differ (5 matches 15)";
+
+#ifndef NDEBUG
+    EXPECT_DEATH(left.unionWith(other), "ordered alike") << "Debug builds should reject differently ordered sets";
+#endif
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
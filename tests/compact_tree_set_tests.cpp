@@ -0,0 +1,122 @@
+#include "models/compact_tree_set.hpp"
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace models;
+
+namespace
+{
+template <typename T, typename Compare> std::vector<T> valuesOf(const CompactTreeSet<T, Compare> &set)
+{
+    std::vector<T> values;
+    set.traverseInorder([&values](const T &value) { values.push_back(value); });
+    return values;
+}
+
+//? The height of an AVL tree with n nodes is below 1.4405 log2(n + 2) - 0.3277
+bool withinAvlBound(int height, size_t count)
+{
+    return height <= static_cast<int>(1.4405 * std::log2(static_cast<double>(count) + 2.0) - 0.3277);
+}
+} // namespace
+
+TEST(CompactTreeSetTests, NodesArePacked)
+{
+    EXPECT_EQ(CompactTreeSet<int>::nodeSize(), 12) << "An int node should be the value and two 32-bit links";
+    EXPECT_EQ(CompactTreeSet<double>::nodeSize(), 16) << "A double node should only pad to the double's alignment";
+
+    std::vector<int> values(1000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        values[i] = i;
+    }
+    auto set = CompactTreeSet<int>::fromSorted(values.begin(), values.end());
+    EXPECT_EQ(set.memoryUsage(), 12 * 1000) << "A built set should hold exactly one node per value";
+    EXPECT_EQ(set.height(), 9) << "A built set should be height-minimal";
+}
+
+TEST(CompactTreeSetTests, RandomOperationsMatchStdSet)
+{
+    CompactTreeSet<int> set;
+    std::set<int> expected;
+    uint32_t state = 12345;
+    bool heightsBounded = true;
+    for (int step = 0; step < 20000; ++step)
+    {
+        state = state * 1664525u + 1013904223u;
+        const int value = static_cast<int>((state >> 8) % 2000);
+        if ((state >> 4) % 3 != 0)
+        {
+            EXPECT_EQ(set.insert(value), expected.insert(value).second) << "insert should report new values";
+        }
+        else
+        {
+            EXPECT_EQ(set.erase(value), expected.erase(value) == 1) << "erase should report removed values";
+        }
+        heightsBounded = heightsBounded && withinAvlBound(set.height(), set.size());
+    }
+    EXPECT_TRUE(heightsBounded) << "The height should stay within the AVL bound after every operation";
+    EXPECT_EQ(valuesOf(set), std::vector<int>(expected.begin(), expected.end())) << "The values should match";
+    EXPECT_EQ(set.size(), expected.size()) << "The sizes should match";
+    for (int value = -1; value <= 2000; ++value)
+    {
+        EXPECT_EQ(set.contains(value), expected.count(value) == 1) << "contains should agree on " << value;
+    }
+
+    for (int value : std::vector<int>(expected.begin(), expected.end()))
+    {
+        set.erase(value);
+    }
+    EXPECT_TRUE(set.empty()) << "Erasing every value should empty the set";
+    EXPECT_EQ(set.height(), -1) << "An empty set should have a height of -1";
+}
+
+TEST(CompactTreeSetTests, SortedInsertsStayBalanced)
+{
+    CompactTreeSet<int> ascending, descending;
+    for (int i = 0; i < 4095; ++i)
+    {
+        ascending.insert(i);
+        descending.insert(-i);
+    }
+    EXPECT_TRUE(withinAvlBound(ascending.height(), 4095)) << "Ascending inserts should be rebalanced";
+    EXPECT_TRUE(withinAvlBound(descending.height(), 4095)) << "Descending inserts should be rebalanced";
+    EXPECT_EQ(ascending.traverseInorder([](int value) { return value < 10; }), false)
+        << "A callback returning false should stop the traversal";
+}
+
+TEST(CompactTreeSetTests, StringsAndComparators)
+{
+    CompactTreeSet<std::string> words;
+    for (const char *word : {"pear", "apple", "fig", "kiwi", "banana", "cherry"})
+    {
+        words.insert(word);
+    }
+    EXPECT_TRUE(words.contains(std::string_view("kiwi"))) << "A transparent comparator should allow string_view keys";
+    EXPECT_TRUE(words.erase("apple")) << "A string should be erased";
+    EXPECT_TRUE(words.erase("fig")) << "A node with two children should take its successor's value";
+    EXPECT_EQ(valuesOf(words), std::vector<std::string>({"banana", "cherry", "kiwi", "pear"}))
+        << "Moved nodes should keep their values";
+
+    const std::vector<int> values = {5, 1, 4, 1, 3};
+    auto descending = CompactTreeSet<int, std::greater<>>::fromSorted(values.begin(), values.end());
+    EXPECT_EQ(valuesOf(descending), std::vector<int>({5, 4, 3, 1})) << "fromSorted should follow the comparator";
+    descending.insert(2);
+    EXPECT_EQ(valuesOf(descending), std::vector<int>({5, 4, 3, 2, 1})) << "insert should follow the comparator";
+
+    auto copy = descending;
+    copy.clear();
+    EXPECT_EQ(descending.size(), 5) << "A copy should not share nodes with the original";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,205 @@
+#include "models/concurrent_skip_list_set.hpp"
+#include <atomic>
+#include <functional>
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace models;
+
+namespace
+{
+template <typename T, typename Compare> std::vector<T> contents(const ConcurrentSkipListSet<T, Compare> &set)
+{
+    std::vector<T> values;
+    set.traverseInorder([&values](const T &value) { values.push_back(value); });
+    return values;
+}
+} // namespace
+
+TEST(ConcurrentSkipListSetTests, SequentialMatchesStdSet)
+{
+    ConcurrentSkipListSet<int> set;
+    std::set<int> expected;
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> values(0, 499);
+    bool agrees = true;
+    for (int i = 0; i < 5000; ++i)
+    {
+        const int value = values(random);
+        switch (random() % 3)
+        {
+        case 0:
+            agrees = agrees && set.insert(value) == expected.insert(value).second;
+            break;
+        case 1:
+            agrees = agrees && set.erase(value) == (expected.erase(value) == 1);
+            break;
+        default:
+            agrees = agrees && set.contains(value) == (expected.count(value) == 1);
+        }
+    }
+
+    EXPECT_TRUE(agrees) << "Every insert, erase and contains should agree with std::set";
+    EXPECT_EQ(set.size(), expected.size()) << "Size should match std::set";
+    EXPECT_EQ(contents(set), std::vector<int>(expected.begin(), expected.end()))
+        << "Traversal should visit the values in order";
+}
+
+TEST(ConcurrentSkipListSetTests, EmptySetAndEarlyExit)
+{
+    ConcurrentSkipListSet<std::string> set;
+    EXPECT_TRUE(set.empty()) << "A new set should be empty";
+    EXPECT_FALSE(set.contains("a")) << "An empty set should contain nothing";
+    EXPECT_FALSE(set.erase("a")) << "Erasing from an empty set should fail";
+
+    for (const char *word : {"pear", "apple", "fig", "kiwi"})
+    {
+        set.insert(word);
+    }
+    EXPECT_FALSE(set.insert("fig")) << "Inserting a duplicate should fail";
+
+    std::vector<std::string> visited;
+    bool completed = set.traverseInorder([&visited](const std::string &value) {
+        visited.push_back(value);
+        return visited.size() < 2;
+    });
+    EXPECT_FALSE(completed) << "Returning false should stop the traversal";
+    EXPECT_EQ(visited, (std::vector<std::string>{"apple", "fig"})) << "Traversal should stop after the second value";
+}
+
+TEST(ConcurrentSkipListSetTests, CustomComparator)
+{
+    ConcurrentSkipListSet<int, std::greater<>> set;
+    for (int value : {3, 1, 4, 1, 5, 9, 2, 6})
+    {
+        set.insert(value);
+    }
+    EXPECT_EQ(contents(set), (std::vector<int>{9, 6, 5, 4, 3, 2, 1})) << "std::greater should order values descending";
+}
+
+TEST(ConcurrentSkipListSetTests, ConcurrentDisjointInserts)
+{
+    constexpr int threads = 4;
+    constexpr int perThread = 5000;
+    ConcurrentSkipListSet<int> set;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&set, t]() {
+            //? Interleave the values of all threads, so they keep relinking the same neighbourhoods
+            for (int i = 0; i < perThread; ++i)
+            {
+                set.insert(i * threads + t);
+            }
+        });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    std::vector<int> expected(threads * perThread);
+    for (int i = 0; i < threads * perThread; ++i)
+    {
+        expected[i] = i;
+    }
+    EXPECT_EQ(set.size(), expected.size()) << "Every insert should have been counted";
+    EXPECT_EQ(contents(set), expected) << "Every value inserted by any thread should be in the set, in order";
+}
+
+TEST(ConcurrentSkipListSetTests, ConcurrentInsertsAndErasesOfSameValues)
+{
+    constexpr int threads = 4;
+    constexpr int range = 256;
+    ConcurrentSkipListSet<int> set;
+    std::atomic<long> balance{0}; //? Successful inserts minus successful erases
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&set, &balance, t]() {
+            std::mt19937 random(t);
+            for (int i = 0; i < 20000; ++i)
+            {
+                const int value = static_cast<int>(random() % range);
+                switch (random() % 3)
+                {
+                case 0:
+                    balance += set.insert(value) ? 1 : 0;
+                    break;
+                case 1:
+                    balance -= set.erase(value) ? 1 : 0;
+                    break;
+                default:
+                    set.contains(value);
+                }
+            }
+        });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    const std::vector<int> values = contents(set);
+    bool ordered = true;
+    for (size_t i = 1; i < values.size(); ++i)
+    {
+        ordered = ordered && values[i - 1] < values[i];
+    }
+    EXPECT_TRUE(ordered) << "The set should stay sorted without duplicates";
+    EXPECT_EQ(static_cast<long>(values.size()), balance.load())
+        << "Each value should be in the set exactly when more inserts than erases of it succeeded";
+    EXPECT_EQ(set.size(), values.size()) << "Size should match the values left in the set";
+}
+
+TEST(ConcurrentSkipListSetTests, ReadersSeeStableValuesDuringWrites)
+{
+    //? Even values never change, odd values are inserted and erased continuously around them
+    constexpr int range = 2000;
+    ConcurrentSkipListSet<int> set;
+    for (int value = 0; value < range; value += 2)
+    {
+        set.insert(value);
+    }
+
+    std::atomic<bool> stop{false};
+    std::thread writer([&]() {
+        std::mt19937 random(7);
+        while (!stop)
+        {
+            const int value = static_cast<int>(random() % (range / 2)) * 2 + 1;
+            if (!set.insert(value))
+            {
+                set.erase(value);
+            }
+        }
+    });
+
+    bool stableFound = true;
+    bool traversalComplete = true;
+    for (int round = 0; round < 20; ++round)
+    {
+        for (int value = 0; value < range; value += 2)
+        {
+            stableFound = stableFound && set.contains(value);
+        }
+        int evens = 0;
+        set.traverseInorder([&evens](int value) { evens += value % 2 == 0; });
+        traversalComplete = traversalComplete && evens == range / 2;
+    }
+    stop = true;
+    writer.join();
+
+    EXPECT_TRUE(stableFound) << "Values that are never erased should always be found";
+    EXPECT_TRUE(traversalComplete) << "A traversal should see every value that stays in the set";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
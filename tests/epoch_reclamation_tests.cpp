@@ -0,0 +1,102 @@
+#include "models/epoch_reclamation.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace models;
+
+namespace
+{
+std::atomic<int> freed{0};
+
+void countFree(void *object)
+{
+    delete static_cast<int *>(object);
+    freed++;
+}
+} // namespace
+
+TEST(EpochReclamationTests, RetiredObjectsAreFreedOnceUnpinned)
+{
+    freed = 0;
+    EpochDomain domain;
+    {
+        EpochDomain::Guard guard = domain.pin();
+        domain.retire(new int(1), &countFree);
+    }
+    EXPECT_EQ(domain.pendingCount(), 1) << "A retired object should wait for its epoch to pass";
+
+    domain.collect();
+    domain.collect();
+    EXPECT_EQ(domain.pendingCount(), 0) << "Two epochs without readers should free the object";
+    EXPECT_EQ(freed.load(), 1) << "The deleter should have run exactly once";
+}
+
+TEST(EpochReclamationTests, PinnedReaderDelaysReclamation)
+{
+    freed = 0;
+    EpochDomain domain;
+    EpochDomain::Guard reader = domain.pin();
+    domain.retire(new int(1), &countFree);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        domain.collect();
+    }
+    EXPECT_EQ(freed.load(), 0) << "An object retired while a reader is pinned must not be freed under it";
+    EXPECT_LE(domain.epoch(), 1) << "The epoch should advance at most once past a pinned reader";
+
+    {
+        EpochDomain::Guard released = std::move(reader);
+    }
+    domain.collect();
+    domain.collect();
+    EXPECT_EQ(freed.load(), 1) << "The object should be freed once the reader unpins";
+}
+
+TEST(EpochReclamationTests, DestructorFreesPendingObjects)
+{
+    freed = 0;
+    {
+        EpochDomain domain;
+        EpochDomain::Guard guard = domain.pin();
+        domain.retire(new int(1), &countFree);
+        domain.retire(new int(2), &countFree);
+    }
+    EXPECT_EQ(freed.load(), 2) << "Destroying the domain should free every pending object";
+}
+
+TEST(EpochReclamationTests, ConcurrentPinAndRetire)
+{
+    freed = 0;
+    constexpr int threads = 4;
+    constexpr int perThread = 1000;
+    {
+        EpochDomain domain(2); //? Fewer slots than threads, so some pins wait for a free slot
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&domain]() {
+                for (int i = 0; i < perThread; ++i)
+                {
+                    EpochDomain::Guard guard = domain.pin();
+                    domain.retire(new int(i), &countFree);
+                }
+            });
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        EXPECT_GT(domain.epoch(), 0) << "Retiring should advance the epoch";
+        EXPECT_LT(domain.pendingCount(), threads * perThread) << "Some objects should be freed while running";
+    }
+    EXPECT_EQ(freed.load(), threads * perThread) << "Every retired object should be freed exactly once";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,129 @@
+#include "models/key_search.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace models;
+
+class KeySearchTests : public ::testing::Test
+{
+  protected:
+    std::vector<SearchKernel> kernels;
+
+    void SetUp() override
+    {
+        for (SearchKernel kernel : {SearchKernel::Scalar, SearchKernel::Sse2, SearchKernel::Avx2})
+        {
+            if (searchKernelSupported(kernel))
+            {
+                kernels.push_back(kernel);
+            }
+        }
+    }
+
+    template <typename T> static size_t expectedLowerBound(const std::vector<T> &keys, T value)
+    {
+        return static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), value) - keys.begin());
+    }
+};
+
+TEST_F(KeySearchTests, ActiveKernelIsSupported)
+{
+    EXPECT_TRUE(searchKernelSupported(SearchKernel::Scalar)) << "The scalar kernel should always be available";
+    EXPECT_TRUE(searchKernelSupported(activeSearchKernel()))
+        << "Dispatch should only pick a supported kernel: " << searchKernelName(activeSearchKernel());
+}
+
+TEST_F(KeySearchTests, EmptyNode)
+{
+    for (SearchKernel kernel : kernels)
+    {
+        EXPECT_EQ(countLess(kernel, static_cast<const int *>(nullptr), 0, 5), 0)
+            << "An empty node has no smaller keys: " << searchKernelName(kernel);
+    }
+}
+
+TEST_F(KeySearchTests, IntKernelsMatchLowerBound)
+{
+    //? Every count from 0 to 63 covers full vector blocks and every tail length
+    std::vector<int> keys;
+    for (int i = 0; i < 63; ++i)
+    {
+        keys.push_back(i * 3 - 90);
+    }
+
+    for (size_t count = 0; count <= keys.size(); ++count)
+    {
+        const std::vector<int> node(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(count));
+        for (int value = -95; value <= 100; ++value)
+        {
+            for (SearchKernel kernel : kernels)
+            {
+                ASSERT_EQ(countLess(kernel, node.data(), count, value), expectedLowerBound(node, value))
+                    << searchKernelName(kernel) << " mismatch for value " << value << " in " << count << " keys";
+            }
+        }
+    }
+}
+
+TEST_F(KeySearchTests, IntKernelsHandleExtremes)
+{
+    const std::vector<int> keys = {std::numeric_limits<int>::min(), -1, 0, 1, std::numeric_limits<int>::max()};
+    for (int value : keys)
+    {
+        for (SearchKernel kernel : kernels)
+        {
+            EXPECT_EQ(countLess(kernel, keys.data(), keys.size(), value), expectedLowerBound(keys, value))
+                << searchKernelName(kernel) << " should compare signed values: " << value;
+        }
+    }
+}
+
+TEST_F(KeySearchTests, DoubleKernelsMatchLowerBound)
+{
+    std::mt19937 engine(99);
+    std::uniform_real_distribution<double> values(-1000.0, 1000.0);
+
+    for (size_t count = 0; count <= 31; ++count)
+    {
+        std::vector<double> node(count);
+        std::generate(node.begin(), node.end(), [&]() { return values(engine); });
+        std::sort(node.begin(), node.end());
+
+        for (int probe = 0; probe < 200; ++probe)
+        {
+            //? Half of the probes hit a stored key exactly
+            const double value = (probe % 2 == 0 && count > 0) ? node[engine() % count] : values(engine);
+            for (SearchKernel kernel : kernels)
+            {
+                ASSERT_EQ(countLess(kernel, node.data(), count, value), expectedLowerBound(node, value))
+                    << searchKernelName(kernel) << " mismatch for value " << value << " in " << count << " keys";
+            }
+        }
+    }
+}
+
+TEST_F(KeySearchTests, DispatchedSearchMatchesScalar)
+{
+    const std::vector<int> ints = {1, 2, 3, 5, 8, 13, 21, 34, 55, 89};
+    const std::vector<double> doubles = {-2.5, -0.0, 0.5, 1.25, 3.75};
+
+    for (int value = 0; value < 100; ++value)
+    {
+        EXPECT_EQ(countLess(ints.data(), ints.size(), value), expectedLowerBound(ints, value))
+            << "Dispatched int search mismatch for: " << value;
+    }
+    for (double value : {-3.0, -2.5, 0.0, 0.5, 1.0, 4.0})
+    {
+        EXPECT_EQ(countLess(doubles.data(), doubles.size(), value), expectedLowerBound(doubles, value))
+            << "Dispatched double search mismatch for: " << value;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
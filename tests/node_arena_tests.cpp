@@ -0,0 +1,169 @@
+#include "models/binary_tree_set.hpp"
+#include "models/node_arena.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace models;
+
+TEST(NodeArenaTests, CreateAndDestroy)
+{
+    NodeArena<BinaryNode<int>> arena;
+    BinaryNode<int> *node = arena.create(42);
+
+    EXPECT_EQ(node->value(), 42) << "Arena should construct the node with the given value";
+    EXPECT_EQ(arena.stats().allocations, 1) << "One node should have been allocated";
+    EXPECT_EQ(arena.stats().bytes_in_use, sizeof(BinaryNode<int>)) << "One node should be in use";
+
+    arena.destroy(node);
+    EXPECT_EQ(arena.stats().deallocations, 1) << "One node should have been deallocated";
+    EXPECT_EQ(arena.stats().bytes_in_use, 0) << "No nodes should be in use after destroy";
+}
+
+TEST(NodeArenaTests, FreedSlotIsReused)
+{
+    NodeArena<BinaryNode<int>> arena;
+    BinaryNode<int> *first = arena.create(1);
+    arena.create(2);
+    arena.destroy(first);
+
+    BinaryNode<int> *reused = arena.create(3);
+    EXPECT_EQ(reused, first) << "A destroyed node's slot should be handed out again";
+    EXPECT_EQ(reused->value(), 3) << "Reused slot should hold the new value";
+}
+
+TEST(NodeArenaTests, ConsecutiveNodesAreContiguous)
+{
+    NodeArena<BinaryNode<int>> arena;
+    BinaryNode<int> *previous = arena.create(0);
+    for (int i = 1; i < 16; ++i)
+    {
+        BinaryNode<int> *node = arena.create(i);
+        EXPECT_EQ(reinterpret_cast<char *>(node) - reinterpret_cast<char *>(previous),
+                  static_cast<std::ptrdiff_t>(sizeof(BinaryNode<int>)))
+            << "Nodes created back to back should be adjacent in memory";
+        previous = node;
+    }
+    EXPECT_EQ(arena.stats().system_allocations, 1) << "Sixteen nodes should fit in the first slab";
+}
+
+TEST(NodeArenaTests, SlabsGrowGeometrically)
+{
+    NodeArena<BinaryNode<int>> arena;
+    for (int i = 0; i < 100000; ++i)
+    {
+        arena.create(i);
+    }
+
+    EXPECT_EQ(arena.stats().allocations, 100000) << "Every create should be counted";
+    EXPECT_LT(arena.stats().system_allocations, 30) << "Slabs should amortize calls to the system allocator";
+    EXPECT_GE(arena.stats().bytes_reserved, 100000 * sizeof(BinaryNode<int>)) << "Slabs should hold every node";
+
+    arena.release();
+    EXPECT_EQ(arena.stats().bytes_reserved, 0) << "Release should return every slab";
+}
+
+TEST(NodeArenaTests, ReserveServesOneBlock)
+{
+    NodeArena<BinaryNode<int>> arena;
+    arena.create(-1);
+    arena.reserve(10000);
+    const size_t systemAllocations = arena.stats().system_allocations;
+
+    BinaryNode<int> *first = arena.create(0);
+    BinaryNode<int> *last = first;
+    for (int i = 1; i < 10000; ++i)
+    {
+        last = arena.create(i);
+    }
+    EXPECT_EQ(arena.stats().system_allocations, systemAllocations) << "Reserved nodes should not grow the arena";
+    EXPECT_EQ(last - first, 9999) << "Reserved nodes should be laid out in one block";
+
+    NodeArena<BinaryNode<int>> moved(std::move(arena));
+    EXPECT_EQ(moved.stats().allocations, 10001) << "Moving an arena should carry its counters";
+    EXPECT_EQ(arena.stats().bytes_reserved, 0) << "Moved-from arena should own no slabs";
+}
+
+TEST(NodeArenaTests, AdoptTakesOverNodes)
+{
+    NodeArena<BinaryNode<int>> arena, other;
+    arena.create(1);
+    BinaryNode<int> *adopted = other.create(2);
+    BinaryNode<int> *freed = other.create(3);
+    other.destroy(freed);
+
+    arena.adopt(std::move(other));
+    EXPECT_EQ(arena.stats().allocations, 3) << "Adopting should sum the allocation counters";
+    EXPECT_EQ(arena.stats().bytes_in_use, 2 * sizeof(BinaryNode<int>)) << "Adopted live nodes should be counted";
+    EXPECT_EQ(other.stats().bytes_reserved, 0) << "The adopted arena should own no slabs";
+
+    EXPECT_EQ(arena.create(4), freed) << "Free slots of the adopted arena should be reused";
+    arena.destroy(adopted);
+    EXPECT_EQ(arena.stats().bytes_in_use, 2 * sizeof(BinaryNode<int>)) << "Adopted nodes should be destroyable";
+}
+
+TEST(NodeArenaTests, ThrowingConstructorReturnsSlot)
+{
+    NodeArena<BinaryNode<std::string>> arena;
+    EXPECT_THROW(arena.create(std::string()), std::invalid_argument) << "Empty string node should throw";
+    EXPECT_EQ(arena.stats().allocations, 0) << "Failed construction should not be counted";
+
+    BinaryNode<std::string> *node = arena.create(std::string("valid"));
+    EXPECT_EQ(node->value(), "valid") << "Arena should still work after a failed construction";
+    arena.destroy(node);
+}
+
+TEST(NodeArenaTests, TreeReportsAllocationStats)
+{
+    BinaryTreeSet<int> tree;
+    for (int i = 0; i < 1000; ++i)
+    {
+        tree.insert(i % 500);
+    }
+    tree.erase(0);
+
+    AllocationStats stats = tree.allocationStats();
+    EXPECT_EQ(stats.allocations, 500) << "Only unique values should allocate nodes";
+    EXPECT_EQ(stats.deallocations, 1) << "Erase should destroy one node";
+    EXPECT_EQ(stats.bytes_in_use, 499 * sizeof(BinaryNode<int>)) << "Bytes in use should track live nodes";
+
+    tree.clear();
+    EXPECT_EQ(tree.allocationStats().bytes_reserved, 0) << "Clear should release the whole arena";
+    EXPECT_EQ(tree.allocationStats().deallocations, 1) << "Bulk clear should not visit nodes one by one";
+}
+
+TEST(NodeArenaTests, StringTreeClearRunsDestructors)
+{
+    BinaryTreeSet<std::string, AvlBalanced> tree;
+    for (int i = 0; i < 200; ++i)
+    {
+        tree.insert("a long enough string to live on the heap " + std::to_string(i));
+    }
+
+    tree.clear();
+    EXPECT_EQ(tree.allocationStats().deallocations, 200) << "String nodes should be destroyed before release";
+
+    tree.insert("reused");
+    EXPECT_TRUE(tree.contains("reused")) << "Tree should be usable after clear";
+}
+
+TEST(NodeArenaTests, HeapNodeAllocatorTree)
+{
+    BinaryTreeSet<std::string, Unbalanced, HeapNodeAllocator<BinaryNode<std::string>>> tree;
+    tree.insertRange({"banana", "apple", "cherry"});
+    EXPECT_TRUE(tree.erase("banana")) << "Erase should work with the heap allocator";
+
+    AllocationStats stats = tree.allocationStats();
+    EXPECT_EQ(stats.allocations, 3) << "Every insert should allocate";
+    EXPECT_EQ(stats.system_allocations, 3) << "Every node should be its own heap allocation";
+    EXPECT_EQ(stats.deallocations, 1) << "Erase should delete one node";
+
+    tree.clear();
+    EXPECT_EQ(tree.allocationStats().deallocations, 3) << "Clear should delete every node individually";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
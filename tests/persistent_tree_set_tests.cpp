@@ -0,0 +1,239 @@
+#include "models/persistent_tree_set.hpp"
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace models;
+
+namespace
+{
+std::vector<int> contents(const PersistentTreeSet<int>::Snapshot &snapshot)
+{
+    std::vector<int> values;
+    snapshot.traverseInorder([&values](int value) { values.push_back(value); });
+    return values;
+}
+} // namespace
+
+TEST(PersistentTreeSetTests, SequentialMatchesStdSet)
+{
+    PersistentTreeSet<int> set;
+    std::set<int> expected;
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> values(0, 999);
+    bool agrees = true;
+    for (int i = 0; i < 10000; ++i)
+    {
+        const int value = values(random);
+        switch (random() % 3)
+        {
+        case 0:
+            agrees = agrees && set.insert(value) == expected.insert(value).second;
+            break;
+        case 1:
+            agrees = agrees && set.erase(value) == (expected.erase(value) == 1);
+            break;
+        default:
+            agrees = agrees && set.contains(value) == (expected.count(value) == 1);
+        }
+    }
+
+    const PersistentTreeSet<int>::Snapshot snapshot = set.snapshot();
+    EXPECT_TRUE(agrees) << "Every insert, erase and contains should agree with std::set";
+    EXPECT_EQ(set.size(), expected.size()) << "Size should match std::set";
+    EXPECT_EQ(contents(snapshot), std::vector<int>(expected.begin(), expected.end()))
+        << "Traversal should visit the values in order";
+    EXPECT_LE(snapshot.height(), 1.4405 * std::log2(expected.size() + 2) - 1.3277)
+        << "Path copying should keep the AVL height bound";
+}
+
+TEST(PersistentTreeSetTests, SnapshotsDoNotChange)
+{
+    PersistentTreeSet<int> set;
+    for (int value = 0; value < 100; ++value)
+    {
+        set.insert(value);
+    }
+    const PersistentTreeSet<int>::Snapshot before = set.snapshot();
+
+    for (int value = 0; value < 100; value += 2)
+    {
+        set.erase(value);
+    }
+    set.insert(500);
+    const PersistentTreeSet<int>::Snapshot after = set.snapshot();
+
+    EXPECT_EQ(before.size(), 100) << "An earlier snapshot should keep its size";
+    EXPECT_TRUE(before.contains(0)) << "An earlier snapshot should keep erased values";
+    EXPECT_FALSE(before.contains(500)) << "An earlier snapshot should not see later inserts";
+    EXPECT_EQ(after.size(), 51) << "A later snapshot should see the modifications";
+    EXPECT_FALSE(after.contains(0)) << "A later snapshot should not contain erased values";
+    EXPECT_TRUE(after.contains(500)) << "A later snapshot should contain inserted values";
+
+    PersistentTreeSet<int>::Snapshot copy = before;
+    EXPECT_EQ(contents(copy), contents(before)) << "A copied snapshot should refer to the same version";
+    copy = after;
+    EXPECT_EQ(copy.size(), after.size()) << "Assigning a snapshot should switch versions";
+}
+
+TEST(PersistentTreeSetTests, SnapshotsOutliveTheSet)
+{
+    auto set = std::make_unique<PersistentTreeSet<std::string>>();
+    set->insert("beta");
+    set->insert("alpha");
+    PersistentTreeSet<std::string>::Snapshot snapshot = set->snapshot();
+    set->erase("beta");
+    set.reset();
+
+    std::vector<std::string> values;
+    snapshot.traverseInorder([&values](const std::string &value) { values.push_back(value); });
+    EXPECT_EQ(values, (std::vector<std::string>{"alpha", "beta"})) << "A snapshot should stay valid after the set";
+}
+
+TEST(PersistentTreeSetTests, WritesDoNotWaitForScans)
+{
+    PersistentTreeSet<int> set;
+    for (int value = 0; value < 10; ++value)
+    {
+        set.insert(value);
+    }
+
+    //? Modifying the set from inside its own traversal would deadlock if traversals held the writer lock
+    std::vector<int> visited;
+    set.traverseInorder([&](int value) {
+        visited.push_back(value);
+        set.insert(value + 100);
+        set.erase(value);
+    });
+
+    EXPECT_EQ(visited, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}))
+        << "The traversal should see the version it started on";
+    EXPECT_EQ(set.size(), 10) << "Every modification made during the traversal should have been applied";
+    EXPECT_TRUE(set.contains(109) && !set.contains(9)) << "The set should hold the new values only";
+}
+
+TEST(PersistentTreeSetTests, ConcurrentScansSeeConsistentVersions)
+{
+    //? The writer keeps the size at 1000 or 1001 and the values in [0, 2000), readers check every version they scan
+    PersistentTreeSet<int> set;
+    for (int value = 0; value < 2000; value += 2)
+    {
+        set.insert(value);
+    }
+
+    std::atomic<bool> stop{false};
+    std::thread writer([&]() {
+        std::mt19937 random(7);
+        while (!stop)
+        {
+            const int value = static_cast<int>(random() % 1000) * 2 + 1;
+            if (set.insert(value))
+            {
+                set.erase(value - 1);
+                set.insert(value - 1);
+                set.erase(value);
+            }
+        }
+    });
+
+    std::atomic<bool> consistent{true};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r)
+    {
+        readers.emplace_back([&]() {
+            for (int round = 0; round < 50; ++round)
+            {
+                const PersistentTreeSet<int>::Snapshot snapshot = set.snapshot();
+                size_t count = 0;
+                int previous = -1;
+                bool ordered = true;
+                snapshot.traverseInorder([&](int value) {
+                    ordered = ordered && value > previous;
+                    previous = value;
+                    ++count;
+                });
+                if (!ordered || count != snapshot.size() || count < 1000 || count > 1001)
+                {
+                    consistent = false;
+                }
+            }
+        });
+    }
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+    stop = true;
+    writer.join();
+
+    EXPECT_TRUE(consistent) << "Every snapshot should be a sorted, complete version of the set";
+    EXPECT_EQ(set.size(), 1000) << "The writer should leave the set with its initial size";
+}
+
+TEST(PersistentTreeSetTests, CustomComparator)
+{
+    PersistentTreeSet<int, std::greater<>> set;
+    for (int value : {3, 1, 4, 1, 5, 9, 2, 6})
+    {
+        set.insert(value);
+    }
+    std::vector<int> values;
+    set.traverseInorder([&values](int value) {
+        values.push_back(value);
+        return values.size() < 3;
+    });
+    EXPECT_EQ(values, (std::vector<int>{9, 6, 5})) << "std::greater should order values descending";
+}
+
+TEST(PersistentTreeSetTests, HeightCountsEdges)
+{
+    PersistentTreeSet<int> set;
+    EXPECT_EQ(set.snapshot().height(), -1) << "An empty version should have height -1";
+    set.insert(1);
+    EXPECT_EQ(set.snapshot().height(), 0) << "A single value should have height 0";
+    set.insert(2);
+    set.insert(3);
+    EXPECT_EQ(set.snapshot().height(), 1) << "Three values should be rebalanced to height 1";
+}
+
+TEST(PersistentTreeSetTests, AssignedSnapshotsKeepTheirComparator)
+{
+    struct Modulo
+    {
+        int divisor;
+        bool operator()(int left, int right) const
+        {
+            return left % divisor < right % divisor;
+        }
+    };
+    PersistentTreeSet<int, Modulo> coarse(Modulo{1});
+    PersistentTreeSet<int, Modulo> fine(Modulo{100});
+    for (int value = 0; value < 20; ++value)
+    {
+        coarse.insert(value);
+        fine.insert(value);
+    }
+    EXPECT_EQ(coarse.size(), 1) << "Every value should be equivalent modulo 1";
+
+    PersistentTreeSet<int, Modulo>::Snapshot snapshot = coarse.snapshot();
+    snapshot = fine.snapshot();
+    int found = 0;
+    for (int value = 0; value < 20; ++value)
+    {
+        found += snapshot.contains(value);
+    }
+    EXPECT_EQ(found, 20) << "An assigned snapshot should search with the comparator of the set it came from";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
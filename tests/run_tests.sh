@@ -13,8 +13,8 @@ cd "$PROJECT_ROOT"
 mkdir -p build
 cd build
 
-# Configure with CMake
-cmake ..
+# Configure with CMake (Debug profile, which builds with AddressSanitizer)
+cmake -DCMAKE_BUILD_TYPE=Debug ..
 
 # Build the project
 make -j$(nproc 2>/dev/null || sysctl -n hw.ncpu 2>/dev/null || echo 4)
@@ -0,0 +1,172 @@
+#include "models/binary_tree_set.hpp"
+#include "models/set_file.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace models;
+
+namespace
+{
+//? A file in the temporary directory, removed when the test is done with it
+class TemporaryFile
+{
+  private:
+    std::string file_path;
+
+  public:
+    explicit TemporaryFile(const std::string &name)
+        : file_path((std::filesystem::temp_directory_path() / ("set_file_tests_" + name)).string())
+    {
+    }
+
+    ~TemporaryFile()
+    {
+        std::remove(file_path.c_str());
+    }
+
+    const std::string &path() const
+    {
+        return file_path;
+    }
+};
+} // namespace
+
+TEST(SetFileTests, IntRoundTrip)
+{
+    TemporaryFile file("ints");
+    AvlTreeSet<int> set;
+    for (int value : {50, 20, 80, 10, 30, 70, 90, -5})
+    {
+        set.insert(value);
+    }
+    set.save(file.path());
+
+    const MappedSet<int> mapped(file.path());
+    EXPECT_EQ(mapped.size(), set.size()) << "The mapped set should hold every saved value";
+    EXPECT_EQ(std::vector<int>(mapped.begin(), mapped.end()), (std::vector<int>{-5, 10, 20, 30, 50, 70, 80, 90}))
+        << "The mapped values should be in order";
+    EXPECT_TRUE(mapped.contains(70)) << "The mapped set should find saved values";
+    EXPECT_FALSE(mapped.contains(71)) << "The mapped set should not find other values";
+    EXPECT_EQ(mapped.rank(50), 4) << "Rank should count the values before the given one";
+    EXPECT_EQ(*mapped.lower_bound(75), 80) << "lower_bound should find the first value not before the given one";
+
+    const AvlTreeSet<int> loaded = AvlTreeSet<int>::load(file.path());
+    std::vector<int> values;
+    loaded.traverseInorder([&values](int value) { values.push_back(value); });
+    EXPECT_EQ(values, std::vector<int>(mapped.begin(), mapped.end())) << "load should rebuild the same set";
+    EXPECT_LE(loaded.height(), 4) << "load should build a balanced tree";
+}
+
+TEST(SetFileTests, DoubleAndEmptyRoundTrip)
+{
+    TemporaryFile doubles("doubles");
+    BinaryTreeSet<double> set;
+    for (double value : {2.5, -1.25, 1e10})
+    {
+        set.insert(value);
+    }
+    set.save(doubles.path());
+    const MappedSet<double> mapped(doubles.path());
+    EXPECT_EQ(std::vector<double>(mapped.begin(), mapped.end()), (std::vector<double>{-1.25, 2.5, 1e10}))
+        << "Doubles should be stored exactly";
+
+    TemporaryFile empty("empty");
+    BinaryTreeSet<int>().save(empty.path());
+    const MappedSet<int> mappedEmpty(empty.path());
+    EXPECT_TRUE(mappedEmpty.empty()) << "An empty set should round trip";
+    EXPECT_FALSE(mappedEmpty.contains(0)) << "An empty mapped set should contain nothing";
+    EXPECT_TRUE(BinaryTreeSet<int>::load(empty.path()).empty()) << "Loading an empty set should give an empty set";
+}
+
+TEST(SetFileTests, StringPoolRoundTrip)
+{
+    TemporaryFile file("strings");
+    BinaryTreeSet<std::string> set;
+    for (const char *word : {"pear", "apple", "fig", "a much longer string than the others", "kiwi"})
+    {
+        set.insert(word);
+    }
+    set.save(file.path());
+
+    const MappedSet<std::string> mapped(file.path());
+    std::vector<std::string_view> values(mapped.begin(), mapped.end());
+    EXPECT_EQ(values, (std::vector<std::string_view>{"a much longer string than the others", "apple", "fig", "kiwi",
+                                                      "pear"}))
+        << "Strings should come back in order as views into the pool";
+    EXPECT_TRUE(mapped.contains(std::string("kiwi"))) << "A std::string should be found in the mapped set";
+    EXPECT_FALSE(mapped.contains("grape")) << "Missing strings should not be found";
+    EXPECT_EQ(mapped.rank("fig"), 2) << "Rank should work on strings";
+
+    const BinaryTreeSet<std::string> loaded = BinaryTreeSet<std::string>::load(file.path());
+    EXPECT_EQ(loaded.size(), 5) << "load should rebuild every string";
+    EXPECT_TRUE(loaded.contains("apple")) << "load should rebuild the string values";
+}
+
+TEST(SetFileTests, CustomOrderingRoundTrip)
+{
+    TemporaryFile file("descending");
+    BinaryTreeSet<int, AvlBalanced, NodeArena<BinaryNode<int>>, std::greater<>> set;
+    for (int value : {1, 3, 2})
+    {
+        set.insert(value);
+    }
+    set.save(file.path());
+
+    const MappedSet<int, std::greater<>> mapped(file.path());
+    EXPECT_EQ(std::vector<int>(mapped.begin(), mapped.end()), (std::vector<int>{3, 2, 1}))
+        << "Values should be saved in the set's own order";
+    EXPECT_TRUE(mapped.contains(1)) << "Lookups should use the ordering given to the mapped set";
+}
+
+TEST(SetFileTests, InvalidFilesAreRejected)
+{
+    EXPECT_THROW(MappedSet<int>("/nonexistent/directory/set.bin"), std::runtime_error)
+        << "A missing file should be rejected";
+
+    TemporaryFile garbage("garbage");
+    {
+        std::ofstream out(garbage.path(), std::ios::binary);
+        out << "this is not a set file, just some text that is long enough to hold a header";
+    }
+    EXPECT_THROW(MappedSet<int>(garbage.path()), std::runtime_error) << "A file without the magic should be rejected";
+
+    TemporaryFile doubles("wrong_type");
+    BinaryTreeSet<double> set;
+    set.insert(1.0);
+    set.save(doubles.path());
+    EXPECT_THROW(MappedSet<int>(doubles.path()), std::runtime_error) << "Another key size should be rejected";
+    EXPECT_THROW(MappedSet<std::string>(doubles.path()), std::runtime_error)
+        << "Fixed size keys should not be read as strings";
+    EXPECT_THROW(MappedSet<int64_t>(doubles.path()), std::runtime_error) << "Doubles should not be read as integers";
+    EXPECT_THROW(MappedSet<uint64_t>(doubles.path()), std::runtime_error)
+        << "Doubles should not be read as unsigned integers";
+
+    TemporaryFile signedInts("signed");
+    BinaryTreeSet<int> negative;
+    negative.insert(-1);
+    negative.save(signedInts.path());
+    EXPECT_THROW(MappedSet<float>(signedInts.path()), std::runtime_error) << "Integers should not be read as floats";
+    EXPECT_THROW(MappedSet<uint32_t>(signedInts.path()), std::runtime_error)
+        << "Signed integers should not be read as unsigned ones";
+    EXPECT_EQ(MappedSet<int>(signedInts.path()).size(), 1u) << "The same key type should still be accepted";
+
+    TemporaryFile truncated("truncated");
+    BinaryTreeSet<int> ints;
+    ints.insertRange({1, 2, 3, 4});
+    ints.save(truncated.path());
+    std::filesystem::resize_file(truncated.path(), std::filesystem::file_size(truncated.path()) - 2);
+    EXPECT_THROW(MappedSet<int>(truncated.path()), std::runtime_error) << "A truncated file should be rejected";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,203 @@
+#include "models/binary_tree_set.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace models;
+
+namespace
+{
+//? Returns the real height of the subtree, or -2 if the BST order, a parent link or a cached height or size is broken
+//? anywhere below
+int checkInvariants(const BinaryNode<int> *node, const int *low, const int *high)
+{
+    if (!node)
+    {
+        return -1;
+    }
+    if ((low && node->value() <= *low) || (high && node->value() >= *high))
+    {
+        return -2;
+    }
+    if ((node->left() && node->left()->parent() != node) || (node->right() && node->right()->parent() != node))
+    {
+        return -2;
+    }
+
+    const int value = node->value();
+    const int leftHeight = checkInvariants(node->left(), low, &value);
+    const int rightHeight = checkInvariants(node->right(), &value, high);
+    if (leftHeight == -2 || rightHeight == -2)
+    {
+        return -2;
+    }
+
+    const size_t size = 1 + (node->left() ? node->left()->size() : 0) + (node->right() ? node->right()->size() : 0);
+    const int height = 1 + std::max(leftHeight, rightHeight);
+    return height == node->height() && size == node->size() ? height : -2;
+}
+
+template <typename Set> bool isValidTree(const Set &tree)
+{
+    return checkInvariants(tree.getRoot(), nullptr, nullptr) != -2 &&
+           (!tree.getRoot() || tree.getRoot()->parent() == nullptr);
+}
+
+template <typename Set> int depthOf(const Set &tree, int value)
+{
+    int depth = 0;
+    for (const BinaryNode<int> *node = tree.getRoot(); node && node->value() != value; ++depth)
+    {
+        node = value < node->value() ? node->left() : node->right();
+    }
+    return depth;
+}
+} // namespace
+
+TEST(SplayTreeSetTests, AccessedValuesMoveToTheRoot)
+{
+    SplayTreeSet<int> tree;
+    for (int i = 0; i < 100; ++i)
+    {
+        tree.insert(i);
+        EXPECT_EQ(tree.getRoot()->value(), i) << "An inserted value should be splayed to the root";
+    }
+    EXPECT_EQ(tree.height(), 99) << "Sorted inserts should leave a path, splay trees have no worst case bound";
+
+    EXPECT_TRUE(tree.contains(0)) << "The deepest value should be found";
+    EXPECT_EQ(tree.getRoot()->value(), 0) << "A found value should be splayed to the root";
+    EXPECT_LT(tree.height(), 60) << "Splaying the deepest node should roughly halve the path";
+
+    EXPECT_EQ(tree.find(42)->value(), 42) << "find should return the node";
+    EXPECT_EQ(tree.getRoot()->value(), 42) << "find should splay too";
+
+    EXPECT_FALSE(tree.contains(1000)) << "A missing value should not be found";
+    EXPECT_EQ(tree.getRoot()->value(), 99) << "A miss should splay the last node visited";
+
+    tree.insert(42);
+    EXPECT_EQ(tree.size(), 100) << "A duplicate should not be inserted";
+    EXPECT_EQ(tree.getRoot()->value(), 42) << "A duplicate insert should stop at the equal value and splay it";
+
+    EXPECT_TRUE(tree.erase(50)) << "An existing value should be erased";
+    EXPECT_FALSE(tree.contains(50)) << "An erased value should be gone";
+    EXPECT_TRUE(isValidTree(tree)) << "Heights, sizes and parent links should be right after splaying";
+}
+
+TEST(SplayTreeSetTests, RandomOperationsMatchStdSet)
+{
+    SplayTreeSet<int> tree;
+    std::set<int> expected;
+    std::mt19937 engine(7);
+    std::uniform_int_distribution<int> values(0, 499);
+    for (int step = 0; step < 5000; ++step)
+    {
+        const int value = values(engine);
+        switch (engine() % 3)
+        {
+        case 0:
+            tree.insert(value);
+            expected.insert(value);
+            break;
+        case 1:
+            EXPECT_EQ(tree.erase(value), expected.erase(value) == 1) << "erase should report removed values";
+            break;
+        default:
+            EXPECT_EQ(tree.contains(value), expected.count(value) == 1) << "contains should match std::set";
+            break;
+        }
+        if (step % 100 == 0)
+        {
+            EXPECT_TRUE(isValidTree(tree)) << "Invariants should hold after step " << step;
+        }
+    }
+
+    EXPECT_EQ(tree.size(), expected.size()) << "The sizes should match";
+    EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()))
+        << "Splaying should never change the order of the values";
+    EXPECT_TRUE(isValidTree(tree)) << "Invariants should hold at the end";
+    EXPECT_EQ(*tree.select(tree.size() / 2), *std::next(expected.begin(), expected.size() / 2))
+        << "Order statistics should use the sizes kept up to date by the rotations";
+}
+
+TEST(SplayTreeSetTests, HotValuesStayNearTheRoot)
+{
+    SplayTreeSet<int> tree;
+    std::vector<int> values(4096);
+    for (int i = 0; i < 4096; ++i)
+    {
+        values[i] = i;
+    }
+    std::shuffle(values.begin(), values.end(), std::mt19937(11));
+    for (int value : values)
+    {
+        tree.insert(value);
+    }
+
+    const std::vector<int> hot = {17, 900, 2048, 3001, 4095, 5, 1234, 2500};
+    for (int round = 0; round < 50; ++round)
+    {
+        for (int value : hot)
+        {
+            tree.contains(value);
+        }
+    }
+    for (int value : hot)
+    {
+        EXPECT_LT(depthOf(tree, value), 2 * static_cast<int>(hot.size()))
+            << "A value in a small working set should stay within a few levels of the root";
+    }
+    EXPECT_TRUE(isValidTree(tree)) << "Invariants should hold after the lookups";
+}
+
+TEST(SplayTreeSetTests, SampledSplayingSplaysSomeLookups)
+{
+    SampledSplayTreeSet<int, 4> tree;
+    for (int i = 0; i < 1000; ++i)
+    {
+        tree.insert(i * 7 % 1000);
+    }
+    EXPECT_EQ(tree.getRoot()->value(), 993) << "Inserts should always splay";
+
+    //? Each value is looked up once, so the root is the value just looked up exactly when that lookup splayed
+    int splayed = 0;
+    for (int i = 0; i < 400; ++i)
+    {
+        const int value = 2 * i;
+        EXPECT_TRUE(tree.contains(value)) << "Sampled lookups should find every value";
+        splayed += tree.getRoot()->value() == value;
+    }
+    EXPECT_GT(splayed, 50) << "About one lookup in four should splay";
+    EXPECT_LT(splayed, 200) << "Most lookups should leave the tree alone";
+    EXPECT_TRUE(isValidTree(tree)) << "Invariants should hold after sampled splays";
+}
+
+TEST(SplayTreeSetTests, IteratorsAndStringsAcrossSplays)
+{
+    SplayTreeSet<std::string> tree;
+    for (const char *value : {"pear", "apple", "fig", "kiwi", "banana", "cherry"})
+    {
+        tree.insert(value);
+    }
+
+    //? Iterators hold nodes, which splaying moves around but never reallocates
+    std::vector<std::string> visited;
+    for (auto it = tree.begin(); it != tree.end(); ++it)
+    {
+        visited.push_back(*it);
+        tree.contains(std::string("kiwi"));
+        tree.contains(std::string("apple"));
+    }
+    EXPECT_EQ(visited, std::vector<std::string>({"apple", "banana", "cherry", "fig", "kiwi", "pear"}))
+        << "Iteration should stay in order while lookups splay";
+    EXPECT_TRUE(tree.contains(std::string_view("fig"))) << "Heterogeneous lookups should splay as well";
+    EXPECT_EQ(tree.getRoot()->value(), "fig") << "The heterogeneous lookup should have splayed its value";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,102 @@
+#include "models/binary_tree_set.hpp"
+#include "models/static_set.hpp"
+#include <algorithm>
+#include <functional>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace models;
+
+TEST(StaticSetTests, QueriesMatchSortedArrayForEverySize)
+{
+    //? Every size up to 70 covers perfect trees and every fill of a partial bottom level
+    bool containsAgrees = true;
+    bool lowerBoundAgrees = true;
+    bool rankAgrees = true;
+    bool forwardAgrees = true;
+    bool backwardAgrees = true;
+    for (int n = 0; n <= 70; ++n)
+    {
+        std::vector<int> sorted;
+        for (int i = 0; i < n; ++i)
+        {
+            sorted.push_back(2 * i);
+        }
+        const StaticSet<int> set = StaticSet<int>::fromSorted(sorted.begin(), sorted.end());
+
+        for (int key = -1; key <= 2 * n + 1; ++key)
+        {
+            const auto expected = std::lower_bound(sorted.begin(), sorted.end(), key);
+            const auto found = set.lower_bound(key);
+            containsAgrees = containsAgrees && set.contains(key) == (expected != sorted.end() && *expected == key);
+            const bool sameBound =
+                expected == sorted.end() ? found == set.end() : found != set.end() && *found == *expected;
+            lowerBoundAgrees = lowerBoundAgrees && sameBound;
+            rankAgrees = rankAgrees && set.rank(key) == static_cast<size_t>(expected - sorted.begin());
+        }
+        forwardAgrees = forwardAgrees && std::vector<int>(set.begin(), set.end()) == sorted;
+        backwardAgrees = backwardAgrees && std::vector<int>(std::make_reverse_iterator(set.end()),
+                                                            std::make_reverse_iterator(set.begin())) ==
+                                               std::vector<int>(sorted.rbegin(), sorted.rend());
+    }
+
+    EXPECT_TRUE(containsAgrees) << "contains should agree with the sorted array";
+    EXPECT_TRUE(lowerBoundAgrees) << "lower_bound should agree with std::lower_bound";
+    EXPECT_TRUE(rankAgrees) << "rank should count the values before the key";
+    EXPECT_TRUE(forwardAgrees) << "Iterating forwards should visit the values in order";
+    EXPECT_TRUE(backwardAgrees) << "Iterating backwards should visit the values in reverse order";
+}
+
+TEST(StaticSetTests, FreezeCopiesTheTree)
+{
+    AvlTreeSet<int> tree;
+    for (int value : {50, 20, 80, 10, 30, 70, 90, 60})
+    {
+        tree.insert(value);
+    }
+    const StaticSet<int> set = tree.freeze();
+    tree.clear();
+
+    std::vector<int> values;
+    set.traverseInorder([&values](int value) { values.push_back(value); });
+    EXPECT_EQ(values, (std::vector<int>{10, 20, 30, 50, 60, 70, 80, 90})) << "freeze should copy every value in order";
+    EXPECT_EQ(set.size(), 8) << "freeze should keep the size";
+    EXPECT_TRUE(set.contains(60)) << "The frozen set should not depend on the tree";
+    EXPECT_EQ(set.rank(55), 4) << "Rank should count the values before the key";
+
+    size_t visited = 0;
+    EXPECT_FALSE(set.traverseInorder([&visited](int) { return ++visited < 3; }))
+        << "Returning false should stop the traversal";
+    EXPECT_EQ(visited, 3) << "The traversal should stop at the third value";
+
+    EXPECT_TRUE(BinaryTreeSet<int>().freeze().empty()) << "Freezing an empty tree should give an empty set";
+}
+
+TEST(StaticSetTests, StringsAndComparators)
+{
+    BinaryTreeSet<std::string> tree;
+    for (const char *word : {"pear", "apple", "fig", "kiwi"})
+    {
+        tree.insert(word);
+    }
+    const StaticSet<std::string> words = tree.freeze();
+    EXPECT_TRUE(words.contains(std::string_view("kiwi"))) << "A transparent comparator should allow string_view keys";
+    EXPECT_FALSE(words.contains("grape")) << "Missing strings should not be found";
+    EXPECT_EQ(*words.lower_bound("b"), "fig") << "lower_bound should work on strings";
+
+    const std::vector<int> values = {1, 5, 3, 5, 2};
+    const StaticSet<int, std::greater<>> descending =
+        StaticSet<int, std::greater<>>::fromSorted(values.begin(), values.end());
+    EXPECT_EQ(std::vector<int>(descending.begin(), descending.end()), (std::vector<int>{5, 3, 2, 1}))
+        << "fromSorted should sort by the comparator and drop duplicates";
+    EXPECT_EQ(descending.rank(3), 1) << "Rank should follow the comparator's order";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,155 @@
+#include "models/string_set.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace models;
+
+namespace
+{
+std::vector<std::string> valuesOf(const StringSet &set)
+{
+    std::vector<std::string> values;
+    set.traverseInorder([&values](const std::string &value) { values.push_back(value); });
+    return values;
+}
+
+std::vector<std::string> prefixMatches(const StringSet &set, std::string_view prefix)
+{
+    std::vector<std::string> values;
+    set.prefixScan(prefix, [&values](const std::string &value) { values.push_back(value); });
+    return values;
+}
+} // namespace
+
+TEST(StringSetTests, KeysThatArePrefixesOfOthers)
+{
+    StringSet set;
+    EXPECT_TRUE(set.insert("abc")) << "A first key should be inserted as a leaf";
+    EXPECT_TRUE(set.insert("ab")) << "A key ending inside a leaf should split it";
+    EXPECT_TRUE(set.insert("abcd")) << "A key running past a leaf should split it";
+    EXPECT_TRUE(set.insert("")) << "The empty string is a key like any other";
+    EXPECT_TRUE(set.insert("abd")) << "A key branching inside a prefix should split the prefix";
+    EXPECT_FALSE(set.insert("ab")) << "A key ending at a node should be found as a duplicate";
+    EXPECT_EQ(set.size(), 5) << "Duplicates should not be counted";
+
+    for (const char *key : {"", "ab", "abc", "abcd", "abd"})
+    {
+        EXPECT_TRUE(set.contains(key)) << "Inserted key '" << key << "' should be found";
+    }
+    for (const char *key : {"a", "abcde", "abe", "b"})
+    {
+        EXPECT_FALSE(set.contains(key)) << "Key '" << key << "' was never inserted";
+    }
+    EXPECT_EQ(valuesOf(set), std::vector<std::string>({"", "ab", "abc", "abcd", "abd"}))
+        << "Shorter keys should come before their extensions";
+
+    EXPECT_TRUE(set.erase("ab")) << "A key ending at a node should be erased";
+    EXPECT_FALSE(set.erase("ab")) << "An erased key should be gone";
+    EXPECT_TRUE(set.erase("abcd")) << "A leaf should be erased";
+    EXPECT_EQ(valuesOf(set), std::vector<std::string>({"", "abc", "abd"})) << "The other keys should remain";
+
+    const std::string withZero("a\0b", 3);
+    EXPECT_TRUE(set.insert(withZero)) << "Keys may contain zero bytes";
+    EXPECT_TRUE(set.contains(withZero)) << "A key with a zero byte should be found";
+    EXPECT_FALSE(set.contains("a")) << "A zero byte should not end the key";
+}
+
+TEST(StringSetTests, RandomOperationsMatchStdSet)
+{
+    //? Keys over a small alphabet share long prefixes and fan out to every node size
+    StringSet set;
+    std::set<std::string> expected;
+    uint32_t state = 2024;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    };
+    for (int step = 0; step < 30000; ++step)
+    {
+        std::string key = "/data/";
+        const size_t length = next() % 4;
+        for (size_t i = 0; i < length; ++i)
+        {
+            key.push_back(static_cast<char>(next() % 3 == 0 ? next() % 256 : 'a' + next() % 4));
+        }
+        if (next() % 3 != 0)
+        {
+            EXPECT_EQ(set.insert(key), expected.insert(key).second) << "insert should report new keys";
+        }
+        else
+        {
+            EXPECT_EQ(set.erase(key), expected.erase(key) == 1) << "erase should report removed keys";
+        }
+    }
+    EXPECT_EQ(set.size(), expected.size()) << "The sizes should match";
+    EXPECT_EQ(valuesOf(set), std::vector<std::string>(expected.begin(), expected.end()))
+        << "Traversal should follow std::string order";
+
+    const StringSetStats stats = set.stats();
+    EXPECT_GT(stats.node48 + stats.node256, 0) << "Wide fan-out should use the large node kinds";
+    EXPECT_GT(stats.node4, 0) << "Sparse branches should use Node4";
+
+    for (const std::string &key : std::vector<std::string>(expected.begin(), expected.end()))
+    {
+        set.erase(key);
+    }
+    EXPECT_TRUE(set.empty()) << "Erasing every key should empty the set";
+    EXPECT_EQ(set.stats().leaves, 0) << "No node should be left behind";
+}
+
+TEST(StringSetTests, NodesGrowAndShrink)
+{
+    StringSet set;
+    for (int byte = 0; byte < 256; ++byte)
+    {
+        set.insert(std::string("k") + static_cast<char>(byte));
+    }
+    EXPECT_EQ(set.stats().node256, 1) << "256 distinct bytes after a shared byte should need a Node256";
+    EXPECT_EQ(set.stats().prefix_bytes, 1) << "The shared byte should be stored once";
+    for (int byte = 255; byte >= 2; --byte)
+    {
+        set.erase(std::string("k") + static_cast<char>(byte));
+    }
+    const StringSetStats stats = set.stats();
+    EXPECT_EQ(stats.node4, 1) << "Two children left should shrink the node back to a Node4";
+    EXPECT_EQ(stats.node16 + stats.node48 + stats.node256, 0) << "No larger node should remain";
+    set.erase(std::string("k") + static_cast<char>(1));
+    EXPECT_EQ(set.stats().leaves, 1) << "A single key left should collapse into one leaf";
+    EXPECT_EQ(valuesOf(set), std::vector<std::string>({std::string("k") + '\0'})) << "The last key should remain";
+}
+
+TEST(StringSetTests, PrefixScan)
+{
+    StringSet urls;
+    for (const char *url : {"https://a.org/", "https://a.org/docs", "https://a.org/docs/faq", "https://b.org/",
+                            "http://a.org/", "ftp://a.org/"})
+    {
+        urls.insert(url);
+    }
+    EXPECT_EQ(prefixMatches(urls, "https://a.org/d"),
+              std::vector<std::string>({"https://a.org/docs", "https://a.org/docs/faq"}))
+        << "A prefix ending inside a compressed path should match the whole subtree";
+    EXPECT_EQ(prefixMatches(urls, "https://a.org/docs/faq").size(), 1) << "A whole key is a prefix of itself";
+    EXPECT_EQ(prefixMatches(urls, "http").size(), 5) << "A short prefix should match every extension";
+    EXPECT_TRUE(prefixMatches(urls, "https://c").empty()) << "A missing branch should match nothing";
+    EXPECT_TRUE(prefixMatches(urls, "https://a.org/docs/faq/more").empty()) << "A longer prefix should not match";
+    EXPECT_EQ(prefixMatches(urls, "").size(), urls.size()) << "An empty prefix should match everything";
+
+    size_t visited = 0;
+    EXPECT_FALSE(urls.prefixScan("https", [&visited](const std::string &) { return ++visited < 2; }))
+        << "A callback returning false should stop the scan";
+    EXPECT_EQ(visited, 2) << "The scan should stop right after the callback returned false";
+
+    StringSet moved = std::move(urls);
+    EXPECT_EQ(moved.size(), 6) << "Moving should carry the keys";
+    EXPECT_TRUE(urls.empty()) << "The moved-from set should be empty";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
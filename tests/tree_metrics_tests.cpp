@@ -0,0 +1,189 @@
+#include "models/binary_tree_set.hpp"
+#include "models/tree_metrics.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace models;
+
+namespace
+{
+template <typename T>
+using MeteredAvlTreeSet = BinaryTreeSet<T, AvlBalanced, NodeArena<BinaryNode<T>>, std::less<>, TreeMetrics>;
+template <typename T>
+using MeteredSplayTreeSet = BinaryTreeSet<T, Splaying, NodeArena<BinaryNode<T>>, std::less<>, TreeMetrics>;
+
+//? Inserting 1..7 in order into an AVL tree rotates 4 times and leaves the perfect tree 4 (2 (1, 3), 6 (5, 7))
+MeteredAvlTreeSet<int> perfectTree()
+{
+    MeteredAvlTreeSet<int> tree;
+    for (int i = 1; i <= 7; ++i)
+    {
+        tree.insert(i);
+    }
+    return tree;
+}
+} // namespace
+
+TEST(TreeMetricsTests, LatencyHistogramPercentiles)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.valueAtPercentile(50), 0u) << "An empty histogram should report 0";
+    EXPECT_EQ(histogram.min(), 0u) << "An empty histogram should have no minimum";
+
+    for (uint64_t value = 1; value <= 100000; ++value)
+    {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.count(), 100000u) << "Every value should be counted";
+    EXPECT_EQ(histogram.min(), 1u) << "The minimum should be exact";
+    EXPECT_EQ(histogram.max(), 100000u) << "The maximum should be exact";
+    EXPECT_DOUBLE_EQ(histogram.mean(), 50000.5) << "The mean should be exact";
+    for (double percentile : {50.0, 90.0, 99.0, 99.9})
+    {
+        const double expected = percentile * 1000.0;
+        const auto value = static_cast<double>(histogram.valueAtPercentile(percentile));
+        EXPECT_GE(value, expected) << "The value at p" << percentile << " should not be below the exact one";
+        EXPECT_LE(value, expected * (1.0 + 1.0 / 64.0)) << "The value at p" << percentile << " should be within 1.6%";
+    }
+    EXPECT_EQ(histogram.valueAtPercentile(0), 1u) << "p0 should be the smallest value";
+    EXPECT_EQ(histogram.valueAtPercentile(100), 100000u) << "p100 should be the largest value";
+
+    uint64_t counted = 0;
+    uint64_t previousHighest = 0;
+    histogram.forEachBucket([&](uint64_t lowest, uint64_t highest, uint64_t count) {
+        EXPECT_TRUE(counted == 0 || lowest == previousHighest + 1) << "Buckets should cover consecutive ranges";
+        EXPECT_LE(highest - lowest, highest / 64) << "A bucket should be no wider than 1/64 of its values";
+        counted += count;
+        previousHighest = highest;
+    });
+    EXPECT_EQ(counted, histogram.count()) << "The buckets should hold every value";
+
+    histogram.reset();
+    histogram.record(5);
+    histogram.record(uint64_t(1) << 50);
+    EXPECT_EQ(histogram.count(), 2u) << "reset should forget the earlier values";
+    EXPECT_EQ(histogram.valueAtPercentile(50), 5u) << "Small values should have a bucket each";
+    EXPECT_EQ(histogram.max(), LatencyHistogram::highest_trackable) << "Huge values should be clamped";
+}
+
+TEST(TreeMetricsTests, CountsComparisonsVisitsAndRotations)
+{
+    MeteredAvlTreeSet<int> tree = perfectTree();
+    ASSERT_EQ(tree.getRoot()->value(), 4) << "The tree should be perfectly balanced";
+
+    TreeMetricsSnapshot snapshot = tree.metrics().snapshot();
+    const OperationStats &inserts = snapshot[TreeOperation::Insert];
+    EXPECT_EQ(inserts.count, 7u) << "Every insert should be counted";
+    EXPECT_EQ(inserts.allocations, 7u) << "Every insert should allocate a node";
+    EXPECT_EQ(inserts.rotations, 4u) << "Sorted inserts of 1..7 should rotate 4 times";
+    EXPECT_EQ(inserts.latency.count(), 7u) << "Every insert should be timed";
+
+    tree.insert(5);
+    EXPECT_TRUE(tree.contains(5)) << "5 should be found";
+    EXPECT_FALSE(tree.contains(8)) << "8 should not be found";
+    snapshot = tree.metrics().snapshot();
+    EXPECT_EQ(snapshot[TreeOperation::Insert].allocations, 7u) << "A duplicate should not allocate";
+
+    const OperationStats &lookups = snapshot[TreeOperation::Contains];
+    EXPECT_EQ(lookups.count, 2u) << "Both lookups should be counted";
+    EXPECT_EQ(lookups.nodes_visited, 6u) << "Each lookup should walk the 3 levels";
+    EXPECT_EQ(lookups.comparisons, 7u) << "A hit should compare once per level plus once for equality, a miss past "
+                                          "the largest value only once per level";
+    EXPECT_EQ(lookups.depth[3], 2u) << "Both lookups should be in the depth 3 bucket";
+    EXPECT_EQ(lookups.rotations, 0u) << "Lookups should not rotate an AVL tree";
+
+    EXPECT_TRUE(tree.erase(4)) << "The root should be erased";
+    const OperationStats erases = tree.metrics().snapshot()[TreeOperation::Erase];
+    EXPECT_EQ(erases.deallocations, 1u) << "The erased node should be counted";
+    EXPECT_EQ(erases.nodes_visited, 5u) << "The erase should visit 3 levels, then 6 and 5 on the way to the successor";
+    EXPECT_EQ(tree.metrics().snapshot()[TreeOperation::Find].count, 0u) << "No find should have been recorded";
+}
+
+TEST(TreeMetricsTests, SnapshotsAreIndependentAndResettable)
+{
+    MeteredAvlTreeSet<int> tree = perfectTree();
+    const TreeMetricsSnapshot before = tree.metrics().snapshot();
+    for (int i = 0; i < 10; ++i)
+    {
+        tree.find(i);
+    }
+    EXPECT_EQ(before[TreeOperation::Find].count, 0u) << "A snapshot should not change after it is taken";
+    EXPECT_EQ(tree.metrics().snapshot()[TreeOperation::Find].count, 10u) << "Every find should be counted";
+    EXPECT_STREQ(treeOperationName(TreeOperation::Find), "find") << "Operations should have export names";
+
+    MeteredAvlTreeSet<int> moved(std::move(tree));
+    EXPECT_EQ(moved.metrics().snapshot()[TreeOperation::Insert].count, 7u) << "Metrics should move with the nodes";
+    EXPECT_EQ(tree.metrics().snapshot()[TreeOperation::Insert].count, 0u) << "The moved-from set should start over";
+
+    moved.metrics().reset();
+    const TreeMetricsSnapshot after = moved.metrics().snapshot();
+    for (const OperationStats &stats : after.operations)
+    {
+        EXPECT_EQ(stats.count, 0u) << "reset should clear every operation";
+        EXPECT_EQ(stats.latency.count(), 0u) << "reset should clear the latencies";
+    }
+}
+
+TEST(TreeMetricsTests, ParallelInsertRangeKeepsMetrics)
+{
+    WorkStealingPool pool(2);
+    MeteredAvlTreeSet<int> tree = perfectTree();
+    for (int i = 1; i <= 7; ++i)
+    {
+        tree.erase(i);
+    }
+    std::vector<int> values(5000);
+    for (int i = 0; i < 5000; ++i)
+    {
+        values[i] = (i * 37) % 5000;
+    }
+    tree.insertRange(values, pool, 100);
+    EXPECT_EQ(tree.size(), 5000u) << "A parallel insertRange into an emptied set should build it";
+    EXPECT_EQ(tree.metrics().snapshot()[TreeOperation::Insert].count, 7u)
+        << "Filling an empty set should keep the metrics recorded before";
+
+    tree.insertRange({-1, 0, 5000}, pool, 100);
+    EXPECT_EQ(tree.size(), 5002u) << "A parallel insertRange should merge into a filled set";
+    EXPECT_EQ(tree.metrics().snapshot()[TreeOperation::Erase].count, 7u)
+        << "Merging into a filled set should keep the metrics recorded before";
+}
+
+TEST(TreeMetricsTests, SplayingRotationsAreCountedPerOperation)
+{
+    MeteredSplayTreeSet<int> tree;
+    for (int i = 0; i < 100; ++i)
+    {
+        tree.insert(i);
+    }
+    EXPECT_EQ(tree.metrics().snapshot()[TreeOperation::Insert].depth[1], 99u)
+        << "Each sorted insert into a splay tree should visit only the root";
+
+    EXPECT_TRUE(tree.contains(0)) << "The deepest value should be found";
+    const OperationStats lookups = tree.metrics().snapshot()[TreeOperation::Contains];
+    EXPECT_EQ(lookups.nodes_visited, 100u) << "The lookup should walk the whole path";
+    EXPECT_EQ(lookups.depth[OperationStats::depth_buckets - 1], 1u) << "Deep walks should land in the last bucket";
+    EXPECT_EQ(lookups.rotations, 99u) << "Splaying the deepest node should rotate once per level";
+
+    MeteredSplayTreeSet<std::string> words;
+    words.insert("fig");
+    words.insert("kiwi");
+    EXPECT_NE(words.find(std::string_view("fig")), nullptr) << "Heterogeneous lookups should work with metrics";
+    EXPECT_EQ(words.metrics().snapshot()[TreeOperation::Find].count, 1u) << "Heterogeneous lookups should be counted";
+}
+
+TEST(TreeMetricsTests, DisabledMetricsTakeNoSpace)
+{
+    static_assert(sizeof(AvlTreeSet<int>) ==
+                      sizeof(BinaryNode<int> *) + sizeof(size_t) + sizeof(NodeArena<BinaryNode<int>>),
+                  "A set without metrics should hold only its root, size and allocator");
+    EXPECT_GT(sizeof(MeteredAvlTreeSet<int>), sizeof(AvlTreeSet<int>)) << "A metered set should carry its counters";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,109 @@
+#include "models/work_stealing_pool.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace models;
+
+namespace
+{
+//? Naive parallel Fibonacci, forks a large tree of tiny jobs
+long long fibonacci(WorkStealingPool &pool, int n)
+{
+    if (n < 2)
+    {
+        return n;
+    }
+    long long left = 0, right = 0;
+    pool.parallelInvoke([&]() { left = fibonacci(pool, n - 1); }, [&]() { right = fibonacci(pool, n - 2); });
+    return left + right;
+}
+} // namespace
+
+TEST(WorkStealingPoolTests, ParallelInvokeRunsBoth)
+{
+    WorkStealingPool pool(3);
+    int left = 0, right = 0;
+    pool.parallelInvoke([&left]() { left = 1; }, [&right]() { right = 2; });
+
+    EXPECT_EQ(pool.workerCount(), 3) << "Pool should start the requested number of workers";
+    EXPECT_EQ(left, 1) << "Left function should have run";
+    EXPECT_EQ(right, 2) << "Right function should have run";
+}
+
+TEST(WorkStealingPoolTests, NestedForksComplete)
+{
+    WorkStealingPool pool(4);
+    EXPECT_EQ(fibonacci(pool, 20), 6765) << "Deeply nested parallelInvoke calls should all complete";
+}
+
+TEST(WorkStealingPoolTests, PoolWithoutWorkersRunsInline)
+{
+    WorkStealingPool pool(0);
+    const std::thread::id caller = std::this_thread::get_id();
+    bool sameThread = true;
+    pool.parallelInvoke([&]() { sameThread = sameThread && std::this_thread::get_id() == caller; },
+                        [&]() { sameThread = sameThread && std::this_thread::get_id() == caller; });
+
+    EXPECT_TRUE(sameThread) << "Without workers every job should run on the calling thread";
+    EXPECT_EQ(fibonacci(pool, 15), 610) << "Nested forks should complete without workers";
+}
+
+TEST(WorkStealingPoolTests, ParallelForCoversRangeOnce)
+{
+    WorkStealingPool pool(3);
+    std::vector<std::atomic<int>> visits(10007);
+    std::atomic<size_t> largestChunk{0};
+    pool.parallelFor(0, visits.size(), 64, [&](size_t begin, size_t end) {
+        size_t chunk = end - begin;
+        size_t seen = largestChunk.load();
+        while (chunk > seen && !largestChunk.compare_exchange_weak(seen, chunk))
+        {
+        }
+        for (size_t i = begin; i < end; ++i)
+        {
+            visits[i]++;
+        }
+    });
+
+    bool exactlyOnce = true;
+    for (const std::atomic<int> &count : visits)
+    {
+        exactlyOnce = exactlyOnce && count == 1;
+    }
+    EXPECT_TRUE(exactlyOnce) << "Every index should be visited exactly once";
+    EXPECT_LE(largestChunk.load(), 64) << "No chunk should be larger than the grain";
+
+    bool called = false;
+    pool.parallelFor(5, 5, 1, [&called](size_t, size_t) { called = true; });
+    EXPECT_FALSE(called) << "An empty range should not call the body";
+}
+
+TEST(WorkStealingPoolTests, ExceptionsPropagate)
+{
+    WorkStealingPool pool(2);
+    std::atomic<bool> otherRan{false};
+    EXPECT_THROW(pool.parallelInvoke([&otherRan]() { otherRan = true; },
+                                     []() { throw std::runtime_error("right failed"); }),
+                 std::runtime_error)
+        << "An exception in the forked function should reach the caller";
+    EXPECT_TRUE(otherRan) << "The other function should still have run";
+
+    EXPECT_THROW(pool.parallelFor(0, 1000, 10,
+                                  [](size_t begin, size_t) {
+                                      if (begin == 500)
+                                      {
+                                          throw std::logic_error("chunk failed");
+                                      }
+                                  }),
+                 std::logic_error)
+        << "An exception in any chunk should reach the caller";
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}